@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         AES-128 driver for the native platform. Uses the AES-NI
+ *         instructions when the host CPU has them, and the software
+ *         driver otherwise.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "dev/native-aes-128.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define NATIVE_AES_128_WITH_NI 1
+#else
+#define NATIVE_AES_128_WITH_NI 0
+#endif
+/*---------------------------------------------------------------------------*/
+#if NATIVE_AES_128_WITH_NI
+/* Lets the AES-NI intrinsics build without -maes. They only run once the
+   CPU is known to support them. */
+#define AES_NI __attribute__((target("aes,sse2")))
+
+static __m128i round_keys[11];
+/* Whether the CPU has been checked for AES-NI, and the result */
+static uint8_t ni_checked;
+static uint8_t use_ni;
+/*---------------------------------------------------------------------------*/
+static void
+check_ni(void)
+{
+  if(!ni_checked) {
+    __builtin_cpu_init();
+    use_ni = __builtin_cpu_supports("aes") != 0;
+    ni_checked = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static inline __m128i AES_NI
+expand_key(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, _MM_SHUFFLE(3, 3, 3, 3));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+/* The round constant must be an immediate operand */
+#define EXPAND_KEY(i, rcon) \
+  round_keys[i] = expand_key(round_keys[(i) - 1], \
+                             _mm_aeskeygenassist_si128(round_keys[(i) - 1], rcon))
+/*---------------------------------------------------------------------------*/
+static void AES_NI
+set_key_ni(const uint8_t *key)
+{
+  round_keys[0] = _mm_loadu_si128((const __m128i *)key);
+  EXPAND_KEY(1, 0x01);
+  EXPAND_KEY(2, 0x02);
+  EXPAND_KEY(3, 0x04);
+  EXPAND_KEY(4, 0x08);
+  EXPAND_KEY(5, 0x10);
+  EXPAND_KEY(6, 0x20);
+  EXPAND_KEY(7, 0x40);
+  EXPAND_KEY(8, 0x80);
+  EXPAND_KEY(9, 0x1b);
+  EXPAND_KEY(10, 0x36);
+}
+/*---------------------------------------------------------------------------*/
+static void AES_NI
+encrypt_ni(uint8_t *plaintext_and_result)
+{
+  __m128i s;
+  int round;
+
+  s = _mm_loadu_si128((const __m128i *)plaintext_and_result);
+  s = _mm_xor_si128(s, round_keys[0]);
+  for(round = 1; round < 10; round++) {
+    s = _mm_aesenc_si128(s, round_keys[round]);
+  }
+  s = _mm_aesenclast_si128(s, round_keys[10]);
+  _mm_storeu_si128((__m128i *)plaintext_and_result, s);
+}
+/*---------------------------------------------------------------------------*/
+/* Interleaves both blocks, so that the latency of each AESENC is hidden
+   behind the other block's */
+static void AES_NI
+encrypt_pair_ni(uint8_t *block1_and_result, uint8_t *block2_and_result)
+{
+  __m128i s1;
+  __m128i s2;
+  int round;
+
+  s1 = _mm_loadu_si128((const __m128i *)block1_and_result);
+  s2 = _mm_loadu_si128((const __m128i *)block2_and_result);
+  s1 = _mm_xor_si128(s1, round_keys[0]);
+  s2 = _mm_xor_si128(s2, round_keys[0]);
+  for(round = 1; round < 10; round++) {
+    s1 = _mm_aesenc_si128(s1, round_keys[round]);
+    s2 = _mm_aesenc_si128(s2, round_keys[round]);
+  }
+  s1 = _mm_aesenclast_si128(s1, round_keys[10]);
+  s2 = _mm_aesenclast_si128(s2, round_keys[10]);
+  _mm_storeu_si128((__m128i *)block1_and_result, s1);
+  _mm_storeu_si128((__m128i *)block2_and_result, s2);
+}
+#endif /* NATIVE_AES_128_WITH_NI */
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+#if NATIVE_AES_128_WITH_NI
+  check_ni();
+  if(use_ni) {
+    set_key_ni(key);
+    return;
+  }
+#endif /* NATIVE_AES_128_WITH_NI */
+  aes_128_driver.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *plaintext_and_result)
+{
+#if NATIVE_AES_128_WITH_NI
+  if(use_ni) {
+    encrypt_ni(plaintext_and_result);
+    return;
+  }
+#endif /* NATIVE_AES_128_WITH_NI */
+  aes_128_driver.encrypt(plaintext_and_result);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt_pair(uint8_t *block1_and_result, uint8_t *block2_and_result)
+{
+#if NATIVE_AES_128_WITH_NI
+  if(use_ni) {
+    encrypt_pair_ni(block1_and_result, block2_and_result);
+    return;
+  }
+#endif /* NATIVE_AES_128_WITH_NI */
+  aes_128_driver.encrypt(block1_and_result);
+  aes_128_driver.encrypt(block2_and_result);
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver native_aes_128_driver = {
+  set_key,
+  encrypt,
+  encrypt_pair
+};
+/*---------------------------------------------------------------------------*/
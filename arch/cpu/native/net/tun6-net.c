@@ -35,6 +35,7 @@
 
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uip-ds6.h"
+#include "tun6-net.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
@@ -69,9 +70,21 @@ static const char *config_ipaddr = "fd00::1/64";
 static char config_tundev[IFNAMSIZ + 1] = "tun0";
 
 
+static struct tun6_net_stats stats;
+
 #ifndef __CYGWIN__
 static int tunfd = -1;
 
+#if TUN6_NET_OUTPUT_QUEUE > 0
+/* Outgoing packets, waiting for the tun device to be writable */
+static struct {
+  uint8_t buf[UIP_BUFSIZE];
+  uint16_t len;
+} out_queue[TUN6_NET_OUTPUT_QUEUE];
+static uint8_t out_head;
+static uint8_t out_count;
+#endif /* TUN6_NET_OUTPUT_QUEUE > 0 */
+
 static int set_fd(fd_set *rset, fd_set *wset);
 static void handle_fd(fd_set *rset, fd_set *wset);
 static const struct select_callback tun_select_callback = {
@@ -102,6 +115,9 @@ static ssystem(const char *fmt, ...)
 static void
 cleanup(void)
 {
+#if TUN6_NET_PRINT_STATS_AT_EXIT
+  tun6_net_print_stats();
+#endif /* TUN6_NET_PRINT_STATS_AT_EXIT */
   ssystem("ifconfig %s down", config_tundev);
 #ifndef linux
   ssystem("sysctl -w net.ipv6.conf.all.forwarding=1");
@@ -218,6 +234,11 @@ tun_init()
 
   LOG_INFO("Tun open:%d\n", tunfd);
 
+  /* Read and write until the device would block, without blocking */
+  if(fcntl(tunfd, F_SETFL, fcntl(tunfd, F_GETFL) | O_NONBLOCK) == -1) {
+    LOG_WARN("Failed to make the tun device non-blocking\n");
+  }
+
   select_set_callback(tunfd, &tun_select_callback);
 
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
@@ -231,15 +252,19 @@ tun_init()
 }
 
 /*---------------------------------------------------------------------------*/
+/* Returns 1 if the packet was written, 0 if the device would block */
 static int
 tun_output(uint8_t *data, int len)
 {
   /* fprintf(stderr, "*** Writing to tun...%d\n", len); */
   if(tunfd != -1 && write(tunfd, data, len) != len) {
+    if(errno == EAGAIN || errno == EWOULDBLOCK) {
+      return 0;
+    }
     err(1, "serial_to_tun: write");
-    return -1;
   }
-  return 0;
+  stats.packets_out++;
+  return 1;
 }
 /*---------------------------------------------------------------------------*/
 static int
@@ -253,21 +278,96 @@ tun_input(unsigned char *data, int maxlen)
   }
 
   if((size = read(tunfd, data, maxlen)) == -1) {
+    if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return 0;
+    }
     err(1, "tun_input: read");
   }
   return size;
 }
+/*---------------------------------------------------------------------------*/
+#if TUN6_NET_OUTPUT_QUEUE > 0
+/* Writes the queued packets until the device would block */
+static void
+flush_output(void)
+{
+  int n = 0;
 
+  while(out_count > 0 &&
+        tun_output(out_queue[out_head].buf, out_queue[out_head].len)) {
+    out_head = (out_head + 1) % TUN6_NET_OUTPUT_QUEUE;
+    out_count--;
+    n++;
+  }
+  if(n > 0) {
+    stats.hist_out[n - 1]++;
+  }
+}
+#endif /* TUN6_NET_OUTPUT_QUEUE > 0 */
 /*---------------------------------------------------------------------------*/
 static uint8_t
 output(const linkaddr_t *localdest)
 {
   LOG_DBG("SUT: %u\n", uip_len);
-  if(uip_len > 0) {
-    return tun_output(uip_buf, uip_len);
+  if(uip_len == 0 || tunfd == -1) {
+    return 0;
+  }
+#if TUN6_NET_OUTPUT_QUEUE > 0
+  if(out_count == TUN6_NET_OUTPUT_QUEUE) {
+    flush_output();
+  }
+  if(out_count == TUN6_NET_OUTPUT_QUEUE) {
+    LOG_WARN("Output queue full, dropping packet\n");
+    stats.dropped_out++;
+    return 0;
+  }
+  {
+    int i = (out_head + out_count) % TUN6_NET_OUTPUT_QUEUE;
+    memcpy(out_queue[i].buf, uip_buf, uip_len);
+    out_queue[i].len = uip_len;
+    out_count++;
   }
+#else /* TUN6_NET_OUTPUT_QUEUE > 0 */
+  if(!tun_output(uip_buf, uip_len)) {
+    LOG_WARN("Tun device busy, dropping packet\n");
+    stats.dropped_out++;
+  }
+#endif /* TUN6_NET_OUTPUT_QUEUE > 0 */
   return 0;
 }
+#endif /*  __CYGWIN_ */
+/*---------------------------------------------------------------------------*/
+const struct tun6_net_stats *
+tun6_net_get_stats(void)
+{
+  return &stats;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_hist(const char *name, const unsigned long *hist, int size)
+{
+  int i;
+
+  fprintf(stderr, "tun6: packets per %s:", name);
+  for(i = 0; i < size; i++) {
+    if(hist[i] != 0) {
+      fprintf(stderr, " %d:%lu", i + 1, hist[i]);
+    }
+  }
+  fprintf(stderr, "\n");
+}
+/*---------------------------------------------------------------------------*/
+void
+tun6_net_print_stats(void)
+{
+  fprintf(stderr, "tun6: %lu packets in, %lu out, %lu dropped\n",
+          stats.packets_in, stats.packets_out, stats.dropped_out);
+  print_hist("read wakeup", stats.hist_in, TUN6_NET_BATCH_SIZE);
+#if TUN6_NET_OUTPUT_QUEUE > 0
+  print_hist("write flush", stats.hist_out, TUN6_NET_OUTPUT_QUEUE);
+#endif /* TUN6_NET_OUTPUT_QUEUE > 0 */
+}
+#ifndef __CYGWIN__
 
 /*---------------------------------------------------------------------------*/
 /* tun and slip select callback                                              */
@@ -280,6 +380,11 @@ set_fd(fd_set *rset, fd_set *wset)
   }
 
   FD_SET(tunfd, rset);
+#if TUN6_NET_OUTPUT_QUEUE > 0
+  if(out_count > 0) {
+    FD_SET(tunfd, wset);
+  }
+#endif /* TUN6_NET_OUTPUT_QUEUE > 0 */
   return 1;
 }
 
@@ -289,6 +394,7 @@ static void
 handle_fd(fd_set *rset, fd_set *wset)
 {
   int size;
+  int n;
 
   if(tunfd == -1) {
     /* tun is not open */
@@ -297,11 +403,30 @@ handle_fd(fd_set *rset, fd_set *wset)
 
   LOG_INFO("Tun6-handle FD\n");
 
+#if TUN6_NET_OUTPUT_QUEUE > 0
+  if(FD_ISSET(tunfd, wset)) {
+    flush_output();
+  }
+#endif /* TUN6_NET_OUTPUT_QUEUE > 0 */
+
   if(FD_ISSET(tunfd, rset)) {
-    size = tun_input(uip_buf, sizeof(uip_buf));
-    LOG_DBG("TUN data incoming read:%d\n", size);
-    uip_len = size;
-    tcpip_input();
+    /* Drain up to a batch of packets, and no more than the input queue
+       can take; the rest wait for the next wakeup, after the other file
+       descriptors */
+    for(n = 0; n < TUN6_NET_BATCH_SIZE && tcpip_input_queue_space() > 0;
+        n++) {
+      size = tun_input(uip_buf, sizeof(uip_buf));
+      LOG_DBG("TUN data incoming read:%d\n", size);
+      if(size <= 0) {
+        break;
+      }
+      uip_len = size;
+      tcpip_input_enqueue();
+    }
+    if(n > 0) {
+      stats.packets_in += n;
+      stats.hist_in[n - 1]++;
+    }
   }
 }
 #endif /*  __CYGWIN_ */
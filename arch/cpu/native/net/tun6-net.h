@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         The native tun network driver
+ */
+
+#ifndef TUN6_NET_H_
+#define TUN6_NET_H_
+
+#include "contiki.h"
+#include "net/netstack.h"
+
+/* The maximum number of packets read from the tun device per select()
+   wakeup, so that the other file descriptors get their turn. Reading
+   also stops when the IPv6 input queue is full. */
+#ifdef TUN6_NET_CONF_BATCH_SIZE
+#define TUN6_NET_BATCH_SIZE TUN6_NET_CONF_BATCH_SIZE
+#else
+#define TUN6_NET_BATCH_SIZE 16
+#endif
+
+/* The number of outgoing packets held until the tun device is
+   writable, and then written in one go. Zero to write each packet at
+   once. */
+#ifdef TUN6_NET_CONF_OUTPUT_QUEUE
+#define TUN6_NET_OUTPUT_QUEUE TUN6_NET_CONF_OUTPUT_QUEUE
+#else
+#define TUN6_NET_OUTPUT_QUEUE 8
+#endif
+
+/* Print the statistics of the tun driver to stderr when the process
+   exits. Off by default: they remain available through
+   tun6_net_get_stats() and tun6_net_print_stats(). */
+#ifdef TUN6_NET_CONF_PRINT_STATS_AT_EXIT
+#define TUN6_NET_PRINT_STATS_AT_EXIT TUN6_NET_CONF_PRINT_STATS_AT_EXIT
+#else
+#define TUN6_NET_PRINT_STATS_AT_EXIT 0
+#endif
+
+/** Statistics of the tun driver. hist_in[n - 1] counts the wakeups
+    that read n packets, hist_out[n - 1] the flushes that wrote n
+    packets. */
+struct tun6_net_stats {
+  unsigned long packets_in;
+  unsigned long packets_out;
+  unsigned long dropped_out;
+  unsigned long hist_in[TUN6_NET_BATCH_SIZE];
+  unsigned long hist_out[TUN6_NET_OUTPUT_QUEUE > 0 ? TUN6_NET_OUTPUT_QUEUE : 1];
+};
+
+/** \brief Get the statistics of the tun driver */
+const struct tun6_net_stats *tun6_net_get_stats(void);
+
+/** \brief Print the statistics of the tun driver to stderr */
+void tun6_net_print_stats(void);
+
+extern const struct network_driver tun6_net_driver;
+
+#endif /* TUN6_NET_H_ */
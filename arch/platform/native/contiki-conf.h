@@ -102,8 +102,18 @@ typedef unsigned long clock_time_t;
 
 #define CLOCK_CONF_SECOND 1000
 
+/* Separate event queue for the IP stack and callback timers */
+#ifndef PROCESS_CONF_PRIO_LEVELS
+#define PROCESS_CONF_PRIO_LEVELS 2
+#endif /* PROCESS_CONF_PRIO_LEVELS */
+
 #define LOG_CONF_ENABLED 1
 
+/* AES-NI when the host CPU supports it */
+#ifndef AES_128_CONF
+#define AES_128_CONF native_aes_128_driver
+#endif /* AES_128_CONF */
+
 #define PLATFORM_SUPPORTS_BUTTON_HAL 1
 
 /* Not part of C99 but actually present */
@@ -47,12 +47,16 @@
 #include <unistd.h>
 #include <sys/select.h>
 #include <errno.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #ifdef __CYGWIN__
 #include "net/wpcap-drv.h"
 #endif /* __CYGWIN__ */
 
 #include "contiki.h"
+#include "sys/deadline.h"
 #include "net/netstack.h"
 
 #include "dev/serial-line.h"
@@ -80,19 +84,39 @@
  * @{
  */
 
+/*
+ * Selects the epoll backend of the platform main loop instead of select().
+ * Only the descriptors that became ready are dispatched, and the kernel
+ * interest list is only updated when a callback changes its interest.
+ * Available on Linux only.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#else
+#define SELECT_EPOLL 0
+#endif
+
 /*
  * Defines the maximum number of file descriptors monitored by the platform
- * main loop.
+ * main loop. The callbacks take fd_sets, so it cannot exceed FD_SETSIZE.
  */
 #ifdef SELECT_CONF_MAX
 #define SELECT_MAX SELECT_CONF_MAX
+#elif SELECT_EPOLL
+#define SELECT_MAX 64
 #else
 #define SELECT_MAX 8
 #endif
 
+#if SELECT_MAX > FD_SETSIZE
+#error "SELECT_CONF_MAX must not exceed FD_SETSIZE"
+#endif
+
 /*
- * Defines the timeout (in msec) of the select operation if no monitored file
- * descriptors becomes ready.
+ * Defines the maximum timeout (in msec) of the select operation if no
+ * monitored file descriptors becomes ready. The main loop sleeps until the
+ * next timer deadline, but never longer than this, whether or not a timer
+ * is pending.
  */
 #ifdef SELECT_CONF_TIMEOUT
 #define SELECT_TIMEOUT SELECT_CONF_TIMEOUT
@@ -114,6 +138,22 @@
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if SELECT_EPOLL
+/* The maximum number of events fetched per epoll_wait() */
+#define EPOLL_MAX_EVENTS 16
+
+static int epoll_fd = -1;
+/* The events currently registered with epoll, per file descriptor. A
+   descriptor no callback is interested in is not registered, as epoll
+   would report its hang-ups and errors anyway. */
+static uint32_t epoll_events[SELECT_MAX];
+/* The callback whose set_fd asked for each descriptor */
+static uint16_t epoll_owner[SELECT_MAX];
+/* Descriptors epoll cannot wait on, e.g. regular files. Like select()
+   does, they are reported ready every round. */
+static uint8_t epoll_always_ready[SELECT_MAX];
+#endif /* SELECT_EPOLL */
+
 #ifdef PLATFORM_CONF_MAC_ADDR
 static uint8_t mac_addr[] = PLATFORM_CONF_MAC_ADDR;
 #else /* PLATFORM_CONF_MAC_ADDR */
@@ -171,9 +211,15 @@ static void
 stdin_handle_fd(fd_set *rset, fd_set *wset)
 {
   char c;
+  ssize_t len;
+
   if(FD_ISSET(STDIN_FILENO, rset)) {
-    if(read(STDIN_FILENO, &c, 1) > 0) {
+    len = read(STDIN_FILENO, &c, 1);
+    if(len > 0) {
       input_handler(c);
+    } else if(len == 0) {
+      /* End of input: stop polling stdin, it would always be readable */
+      select_set_callback(STDIN_FILENO, NULL);
     }
   }
 }
@@ -284,6 +330,171 @@ platform_init_stage_three()
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
 }
 /*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+/*---------------------------------------------------------------------------*/
+/* Tell epoll about the new interest in a descriptor. Returns 1 if the
+   descriptor is to be reported ready every round instead. */
+static int
+epoll_update(int fd, uint32_t interest)
+{
+  struct epoll_event ev = { 0 };
+
+  if(interest == 0) {
+    if(epoll_events[fd] != 0 && !epoll_always_ready[fd]) {
+      /* Fails harmlessly if the descriptor was closed, as that already
+         removed it */
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    epoll_events[fd] = 0;
+    epoll_always_ready[fd] = 0;
+    return 0;
+  }
+
+  if(!epoll_always_ready[fd]) {
+    ev.events = interest;
+    ev.data.fd = fd;
+    /* The modification fails if the descriptor was closed and its number
+       reused, it is then added again */
+    if(epoll_events[fd] == 0 ||
+       epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1) {
+      if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        if(errno == EPERM) {
+          epoll_always_ready[fd] = 1;
+        } else {
+          perror("epoll_ctl");
+        }
+      }
+    }
+  }
+  epoll_events[fd] = interest;
+  return epoll_always_ready[fd];
+}
+/*---------------------------------------------------------------------------*/
+/* Pass a ready descriptor to the callback that asked for it. Hang-ups and
+   errors show in the directions it asked for, as they do with select(). */
+static void
+epoll_dispatch(int fd, uint32_t events, fd_set *fdr, fd_set *fdw)
+{
+  const struct select_callback *callback = select_callback[epoll_owner[fd]];
+
+  /* The callback may have been removed by an earlier handler */
+  if(callback == NULL) {
+    return;
+  }
+  if(events & EPOLLHUP || events & EPOLLERR) {
+    events |= epoll_events[fd];
+  }
+  events &= epoll_events[fd];
+  if(events == 0) {
+    return;
+  }
+  if(events & EPOLLIN) {
+    FD_SET(fd, fdr);
+  }
+  if(events & EPOLLOUT) {
+    FD_SET(fd, fdw);
+  }
+  callback->handle_fd(fdr, fdw);
+  FD_CLR(fd, fdr);
+  FD_CLR(fd, fdw);
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_main_loop()
+{
+  static fd_set fdr;
+  static fd_set fdw;
+  static uint32_t interest[SELECT_MAX];
+
+#if SELECT_STDIN
+  select_set_callback(STDIN_FILENO, &stdin_fd);
+#endif /* SELECT_STDIN */
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(epoll_fd == -1) {
+    perror("epoll_create1");
+    return;
+  }
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  while(1) {
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    int always_ready;
+    int timeout_ms;
+    int i;
+    int fd;
+    int retval;
+
+    process_run();
+
+    /* Collect the interest of every callback. A callback may ask for
+       descriptors other than its own: each descriptor is handed to the
+       last callback that asked for it. */
+    memset(interest, 0, sizeof(interest));
+    for(i = 0; i <= select_max; i++) {
+      if(select_callback[i] == NULL ||
+         !select_callback[i]->set_fd(&fdr, &fdw)) {
+        FD_ZERO(&fdr);
+        FD_ZERO(&fdw);
+        continue;
+      }
+      for(fd = 0; fd < SELECT_MAX; fd++) {
+        if(FD_ISSET(fd, &fdr) || FD_ISSET(fd, &fdw)) {
+          interest[fd] = 0;
+          if(FD_ISSET(fd, &fdr)) {
+            interest[fd] |= EPOLLIN;
+          }
+          if(FD_ISSET(fd, &fdw)) {
+            interest[fd] |= EPOLLOUT;
+          }
+          epoll_owner[fd] = i;
+        }
+      }
+      FD_ZERO(&fdr);
+      FD_ZERO(&fdw);
+    }
+
+    /* epoll is only told about the descriptors whose interest changed
+       since the last round */
+    always_ready = 0;
+    for(fd = 0; fd < SELECT_MAX; fd++) {
+      if(interest[fd] != epoll_events[fd] || epoll_always_ready[fd]) {
+        always_ready |= epoll_update(fd, interest[fd]);
+      }
+    }
+
+    if(always_ready) {
+      timeout_ms = 0;
+    } else {
+      timeout_ms = (deadline_next_us((uint32_t)SELECT_TIMEOUT * 1000) + 999)
+        / 1000;
+    }
+
+    retval = epoll_wait(epoll_fd, events, EPOLL_MAX_EVENTS, timeout_ms);
+    if(retval < 0) {
+      if(errno != EINTR) {
+        perror("epoll_wait");
+      }
+      retval = 0;
+    }
+
+    for(i = 0; i < retval; i++) {
+      epoll_dispatch(events[i].data.fd, events[i].events, &fdr, &fdw);
+    }
+
+    if(always_ready) {
+      for(fd = 0; fd < SELECT_MAX; fd++) {
+        if(epoll_always_ready[fd]) {
+          epoll_dispatch(fd, epoll_events[fd], &fdr, &fdw);
+        }
+      }
+    }
+
+    etimer_request_poll();
+  }
+
+  return;
+}
+#else /* SELECT_EPOLL */
 void
 platform_main_loop()
 {
@@ -296,12 +507,14 @@ platform_main_loop()
     int maxfd;
     int i;
     int retval;
+    uint32_t timeout_us;
     struct timeval tv;
 
-    retval = process_run();
+    process_run();
 
-    tv.tv_sec = retval ? 0 : SELECT_TIMEOUT / 1000;
-    tv.tv_usec = retval ? 1 : (SELECT_TIMEOUT * 1000) % 1000000;
+    timeout_us = deadline_next_us((uint32_t)SELECT_TIMEOUT * 1000);
+    tv.tv_sec = timeout_us / 1000000;
+    tv.tv_usec = timeout_us % 1000000;
 
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
@@ -331,6 +544,7 @@ platform_main_loop()
 
   return;
 }
+#endif /* SELECT_EPOLL */
 /*---------------------------------------------------------------------------*/
 void
 log_message(char *m1, char *m2)
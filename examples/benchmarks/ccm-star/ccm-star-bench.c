@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for AES-128 and CCM*. Measures the block throughput of
+ *         the software AES-128 driver and of the platform driver, and the
+ *         time CCM* takes to secure and to verify 802.15.4 frames of
+ *         various lengths. Checks that every frame decrypts to the original
+ *         payload and MIC.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef CCM_STAR_BENCH_CONF_FRAMES
+#define FRAMES CCM_STAR_BENCH_CONF_FRAMES
+#else
+#define FRAMES 100000UL
+#endif
+
+#define BLOCKS (FRAMES * 8)
+
+/* The secured part of a data frame header: FCF, sequence number, PAN ID,
+   short addresses and auxiliary security header */
+#define HDR_LEN 15
+#define MIC_LEN 8
+#define MAX_PAYLOAD_LEN (127 - 2 - HDR_LEN - MIC_LEN)
+/*---------------------------------------------------------------------------*/
+PROCESS(ccm_star_bench_process, "CCM* benchmark");
+AUTOSTART_PROCESSES(&ccm_star_bench_process);
+/*---------------------------------------------------------------------------*/
+static const uint16_t payload_lens[] = { 0, 32, 64, MAX_PAYLOAD_LEN };
+
+#define NUM_PAYLOAD_LENS (sizeof(payload_lens) / sizeof(payload_lens[0]))
+
+static uint8_t key[AES_128_KEY_LENGTH];
+static uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+static uint8_t frame[HDR_LEN + MAX_PAYLOAD_LEN + MIC_LEN];
+static uint8_t payload[MAX_PAYLOAD_LEN];
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+static unsigned long
+aes_kblocks_per_second(const struct aes_128_driver *driver, int pair)
+{
+  uint8_t block1[AES_128_BLOCK_SIZE];
+  uint8_t block2[AES_128_BLOCK_SIZE];
+  rtimer_clock_t start, elapsed;
+  unsigned long i;
+
+  memset(block1, 0, sizeof(block1));
+  memset(block2, 0, sizeof(block2));
+  driver->set_key(key);
+  start = RTIMER_NOW();
+  for(i = 0; i < BLOCKS; i += 2) {
+    if(pair && driver->encrypt_pair) {
+      driver->encrypt_pair(block1, block2);
+    } else {
+      driver->encrypt(block1);
+      driver->encrypt(block2);
+    }
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  return elapsed ?
+    (unsigned long)((uint64_t)BLOCKS * RTIMER_SECOND / 1000 / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Secures and verifies frames with the given payload length. Returns the
+   average time per frame, in nanoseconds, for both operations together. */
+static unsigned long
+ccm_ns_per_frame(uint16_t payload_len)
+{
+  uint8_t mic[MIC_LEN];
+  rtimer_clock_t start, elapsed;
+  unsigned long i;
+
+  CCM_STAR.set_key(key);
+  start = RTIMER_NOW();
+  for(i = 0; i < FRAMES; i++) {
+    nonce[12] = i;
+    memcpy(frame + HDR_LEN, payload, payload_len);
+    CCM_STAR.aead(nonce, frame + HDR_LEN, payload_len, frame, HDR_LEN,
+                  frame + HDR_LEN + payload_len, MIC_LEN, 1);
+    CCM_STAR.aead(nonce, frame + HDR_LEN, payload_len, frame, HDR_LEN,
+                  mic, MIC_LEN, 0);
+    if(memcmp(mic, frame + HDR_LEN + payload_len, MIC_LEN)
+       || memcmp(frame + HDR_LEN, payload, payload_len)) {
+      errors++;
+    }
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  return (unsigned long)((uint64_t)elapsed * 1000000000 / RTIMER_SECOND / FRAMES);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ccm_star_bench_process, ev, data)
+{
+  static unsigned i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < sizeof(key); i++) {
+    key[i] = random_rand();
+  }
+  for(i = 0; i < sizeof(nonce); i++) {
+    nonce[i] = random_rand();
+  }
+  for(i = 0; i < HDR_LEN; i++) {
+    frame[i] = random_rand();
+  }
+  for(i = 0; i < sizeof(payload); i++) {
+    payload[i] = random_rand();
+  }
+
+  printf("ccm-star-bench: software AES-128 (%s) %8lu kblocks/s\n",
+         AES_128_WITH_T_TABLE ? "T-table" : "byte-wise",
+         aes_kblocks_per_second(&aes_128_driver, 0));
+  PROCESS_PAUSE();
+  printf("ccm-star-bench: AES_128 %8lu kblocks/s single"
+         " %8lu kblocks/s pairs\n",
+         aes_kblocks_per_second(&AES_128, 0),
+         aes_kblocks_per_second(&AES_128, 1));
+  PROCESS_PAUSE();
+
+  for(i = 0; i < NUM_PAYLOAD_LENS; i++) {
+    printf("ccm-star-bench: CCM* %3u + %3u bytes %7lu ns/frame"
+           " (secure and verify)\n",
+           HDR_LEN, payload_lens[i], ccm_ns_per_frame(payload_lens[i]));
+    PROCESS_PAUSE();
+  }
+
+  printf("ccm-star-bench: %u errors\n", errors);
+  printf("ccm-star-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
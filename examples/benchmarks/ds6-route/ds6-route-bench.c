@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for IPv6 route lookups. Fills the routing table
+ *         with host routes, as on a storing-mode RPL root, and measures
+ *         the number of uip_ds6_route_lookup() calls per second as the
+ *         table grows. Lookup results are checked against a scan of
+ *         the routing table, also after routes are replaced.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef DS6_ROUTE_BENCH_CONF_LOOKUPS
+#define LOOKUPS DS6_ROUTE_BENCH_CONF_LOOKUPS
+#else
+#define LOOKUPS 100000
+#endif
+
+#define NEXTHOPS 8
+/* One route is a /64 prefix, all others are host routes */
+#define HOST_ROUTES (UIP_DS6_ROUTE_NB - 1)
+#define REPLACEMENTS (4 * UIP_DS6_ROUTE_NB)
+/*---------------------------------------------------------------------------*/
+PROCESS(ds6_route_bench_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&ds6_route_bench_process);
+/*---------------------------------------------------------------------------*/
+static uip_ipaddr_t nexthops[NEXTHOPS];
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+static void
+host_addr(uip_ipaddr_t *addr, uint16_t id)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, id >> 8, id & 0xff);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_host_route(uint16_t id)
+{
+  uip_ipaddr_t addr;
+
+  host_addr(&addr, id);
+  if(uip_ds6_route_add(&addr, 128, &nexthops[id % NEXTHOPS]) == NULL) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Longest prefix match by scanning the routing table */
+static uip_ds6_route_t *
+reference_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *found = NULL;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if(uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length) &&
+       (found == NULL || r->length > found->length)) {
+      found = r;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_addr(uip_ipaddr_t *addr, uint16_t max_id)
+{
+  switch(random_rand() % 4) {
+  case 0:
+    /* Covered by the /64 route */
+    uip_ip6addr(addr, 0xfd00, 0, 0, 1, 0x0212, 0x7400, 0, random_rand());
+    break;
+  case 1:
+    /* No route */
+    uip_ip6addr(addr, 0xfd00, 1, 0, 0, 0, 0, 0, random_rand());
+    break;
+  default:
+    host_addr(addr, random_rand() % max_id);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_lookups(uint16_t max_id)
+{
+  uip_ipaddr_t addr;
+  uip_ds6_route_t *r, *expected;
+  unsigned i;
+
+  for(i = 0; i < 1000; i++) {
+    random_addr(&addr, max_id);
+    r = uip_ds6_route_lookup(&addr);
+    expected = reference_lookup(&addr);
+    if((r == NULL) != (expected == NULL) ||
+       (r != NULL && r->length != expected->length)) {
+      errors++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+lookups_per_second(uint16_t n)
+{
+  static uip_ipaddr_t addrs[64];
+  rtimer_clock_t start, elapsed;
+  unsigned long i;
+
+  for(i = 0; i < 64; i++) {
+    random_addr(&addrs[i], n);
+  }
+
+  start = RTIMER_NOW();
+  for(i = 0; i < LOOKUPS; i++) {
+    uip_ds6_route_lookup(&addrs[i % 64]);
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  return elapsed ? (unsigned long)((uint64_t)LOOKUPS * RTIMER_SECOND / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ds6_route_bench_process, ev, data)
+{
+  static uint16_t n, next_size;
+  uip_lladdr_t lladdr;
+  uip_ipaddr_t prefix;
+  uip_ds6_route_t *r;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("ds6-route-bench: %s, %u routes\n",
+         UIP_DS6_ROUTE_HASH_INDEX ? "hash index" : "list", UIP_DS6_ROUTE_NB);
+
+  /* Next hop neighbors */
+  for(i = 0; i < NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    if(uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                       NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+      errors++;
+    }
+  }
+
+  /* uip_ds6_route_add() replaces the longest matching route, so the
+     prefix must not cover the host routes */
+  uip_ip6addr(&prefix, 0xfd00, 0, 0, 1, 0, 0, 0, 0);
+  if(uip_ds6_route_add(&prefix, 64, &nexthops[0]) == NULL) {
+    errors++;
+  }
+
+  /* Grow the table, measuring at each power of two */
+  next_size = 16;
+  for(n = 0; n < HOST_ROUTES; n++) {
+    add_host_route(n);
+    if(n + 1 == next_size || n + 1 == HOST_ROUTES) {
+      check_lookups(n + 1);
+      printf("ds6-route-bench: routes %5u %9lu lookups/s\n",
+             n + 2, lookups_per_second(n + 1));
+      next_size *= 2;
+      PROCESS_PAUSE();
+    }
+  }
+
+  /* Remove and add back random host routes */
+  for(i = 0; i < REPLACEMENTS; i++) {
+    n = random_rand() % HOST_ROUTES;
+    host_addr(&prefix, n);
+    r = uip_ds6_route_lookup(&prefix);
+    if(r == NULL || r->length != 128) {
+      errors++;
+      continue;
+    }
+    uip_ds6_route_rm(r);
+    add_host_route(n);
+  }
+  check_lookups(HOST_ROUTES);
+
+  printf("ds6-route-bench: %u replacements, %u routes, %u errors\n",
+         REPLACEMENTS, uip_ds6_route_num_routes(), errors);
+  printf("ds6-route-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
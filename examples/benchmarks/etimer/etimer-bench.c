@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Microbenchmark for the event timer backends. Measures the
+ *         cost of setting, re-setting and stopping event timers and of
+ *         an etimer poll with 10, 100 and 1000 pending timers.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "sys/etimer.h"
+#include "sys/rtimer.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#ifndef ETIMER_BENCH_CONF_OPS
+#define ETIMER_BENCH_OPS 100000
+#else
+#define ETIMER_BENCH_OPS ETIMER_BENCH_CONF_OPS
+#endif
+
+#define ETIMER_BENCH_MAX_TIMERS 1000
+/*---------------------------------------------------------------------------*/
+PROCESS(etimer_bench_process, "Etimer benchmark");
+AUTOSTART_PROCESSES(&etimer_bench_process);
+/*---------------------------------------------------------------------------*/
+static struct etimer timers[ETIMER_BENCH_MAX_TIMERS];
+static const uint16_t sizes[] = { 10, 100, 1000 };
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+random_interval(void)
+{
+  /* Far enough in the future that nothing expires during a run */
+  return 100 * CLOCK_SECOND + random_rand() % (100 * CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+ns_per_op(rtimer_clock_t start, unsigned long ops)
+{
+  uint64_t ns;
+
+  ns = (uint64_t)(rtimer_clock_t)(RTIMER_NOW() - start) * 1000000000ULL;
+  return (unsigned long)(ns / RTIMER_SECOND / ops);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(uint16_t n)
+{
+  rtimer_clock_t start;
+  rtimer_clock_t set_time, stop_time;
+  unsigned long rounds, ops, i, r;
+  unsigned long set_ns, reset_ns, poll_ns, stop_ns;
+
+  /* Insert and remove all timers, enough rounds for a measurable time */
+  rounds = ETIMER_BENCH_OPS / n;
+  set_time = stop_time = 0;
+  for(r = 0; r < rounds; r++) {
+    start = RTIMER_NOW();
+    for(i = 0; i < n; i++) {
+      etimer_set(&timers[i], random_interval());
+    }
+    set_time += RTIMER_NOW() - start;
+    start = RTIMER_NOW();
+    for(i = 0; i < n; i++) {
+      etimer_stop(&timers[n - 1 - i]);
+    }
+    stop_time += RTIMER_NOW() - start;
+  }
+  ops = rounds * n;
+  set_ns = (unsigned long)((uint64_t)set_time * 1000000000ULL / RTIMER_SECOND / ops);
+  stop_ns = (unsigned long)((uint64_t)stop_time * 1000000000ULL / RTIMER_SECOND / ops);
+
+  /* Move pending timers to a new expiration time */
+  for(i = 0; i < n; i++) {
+    etimer_set(&timers[i], random_interval());
+  }
+  start = RTIMER_NOW();
+  for(i = 0; i < ETIMER_BENCH_OPS; i++) {
+    etimer_set(&timers[random_rand() % n], random_interval());
+  }
+  reset_ns = ns_per_op(start, ETIMER_BENCH_OPS);
+
+  /* Poll the etimer process while no timer has expired */
+  start = RTIMER_NOW();
+  for(i = 0; i < ETIMER_BENCH_OPS; i++) {
+    process_post_synch(&etimer_process, PROCESS_EVENT_POLL, NULL);
+  }
+  poll_ns = ns_per_op(start, ETIMER_BENCH_OPS);
+
+  for(i = 0; i < n; i++) {
+    etimer_stop(&timers[i]);
+  }
+
+  printf("etimer-bench: timers %4u set %6lu stop %6lu reset %6lu poll %6lu ns/op\n",
+         n, set_ns, stop_ns, reset_ns, poll_ns);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_bench_process, ev, data)
+{
+  static uint8_t i;
+
+  PROCESS_BEGIN();
+
+#if ETIMER_HEAP_SIZE
+  printf("etimer-bench: heap backend, %u slots, %u ops per test\n",
+         ETIMER_HEAP_SIZE, ETIMER_BENCH_OPS);
+#else
+  printf("etimer-bench: list backend, %u ops per test\n", ETIMER_BENCH_OPS);
+#endif
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+    /* Let the rest of the system run between tests */
+    PROCESS_PAUSE();
+  }
+
+  printf("etimer-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Stress benchmark for the heapmem allocator. Replays a recorded
+ *         trace of allocations and deallocations, or a synthetic
+ *         workload of small and medium-sized buffers, and reports the
+ *         time per operation, the number of failed allocations and the
+ *         fragmentation of the heap.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/* A trace operation: allocate, reallocate or free object "id". */
+typedef enum {
+  TRACE_ALLOC,
+  TRACE_REALLOC,
+  TRACE_FREE,
+} trace_op_type_t;
+
+typedef struct {
+  uint8_t type;
+  uint16_t id;
+  uint16_t size;
+} trace_op_t;
+
+#ifdef HEAPMEM_BENCH_CONF_TRACE
+/* Defines trace[] and TRACE_OBJECTS, see trace-from-log.py */
+#include HEAPMEM_BENCH_CONF_TRACE
+#define TRACE_LENGTH (sizeof(trace) / sizeof(trace[0]))
+#else
+/* Synthetic workload, generated at startup */
+#define TRACE_OBJECTS 64
+#define TRACE_LENGTH  4000
+static trace_op_t trace[TRACE_LENGTH];
+#endif
+
+#ifdef HEAPMEM_BENCH_CONF_ROUNDS
+#define ROUNDS HEAPMEM_BENCH_CONF_ROUNDS
+#else
+#define ROUNDS 200
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS(heapmem_bench_process, "Heapmem benchmark");
+AUTOSTART_PROCESSES(&heapmem_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint8_t *objects[TRACE_OBJECTS];
+static uint16_t sizes[TRACE_OBJECTS];
+static unsigned long failures;
+static unsigned long corruptions;
+/*---------------------------------------------------------------------------*/
+#ifndef HEAPMEM_BENCH_CONF_TRACE
+static void
+generate_trace(void)
+{
+  static uint8_t live[TRACE_OBJECTS];
+  unsigned i;
+  uint16_t id;
+
+  memset(live, 0, sizeof(live));
+  for(i = 0; i < TRACE_LENGTH; i++) {
+    id = random_rand() % TRACE_OBJECTS;
+    trace[i].id = id;
+    if(!live[id]) {
+      trace[i].type = TRACE_ALLOC;
+      /* Mostly small messages and options, some larger payloads */
+      if(random_rand() % 4) {
+        trace[i].size = 4 + random_rand() % 60;
+      } else {
+        trace[i].size = 64 + random_rand() % 448;
+      }
+      live[id] = 1;
+    } else if(random_rand() % 8 == 0) {
+      trace[i].type = TRACE_REALLOC;
+      trace[i].size = 4 + random_rand() % 256;
+    } else {
+      trace[i].type = TRACE_FREE;
+      trace[i].size = 0;
+      live[id] = 0;
+    }
+  }
+}
+#endif /* HEAPMEM_BENCH_CONF_TRACE */
+/*---------------------------------------------------------------------------*/
+static int
+check_object(uint16_t id)
+{
+  uint16_t i;
+
+  for(i = 0; i < sizes[id]; i++) {
+    if(objects[id][i] != (uint8_t)(id + i)) {
+      corruptions++;
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_object(uint16_t id, uint16_t from)
+{
+  uint16_t i;
+
+  for(i = from; i < sizes[id]; i++) {
+    objects[id][i] = (uint8_t)(id + i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay(int verify)
+{
+  unsigned i;
+  const trace_op_t *op;
+  uint8_t *ptr;
+  uint16_t old_size;
+
+  for(i = 0; i < TRACE_LENGTH; i++) {
+    op = &trace[i];
+    switch(op->type) {
+    case TRACE_ALLOC:
+      if(objects[op->id] != NULL) {
+        break;
+      }
+      objects[op->id] = heapmem_alloc(op->size);
+      if(objects[op->id] == NULL) {
+        failures++;
+      } else if(verify) {
+        sizes[op->id] = op->size;
+        fill_object(op->id, 0);
+      }
+      break;
+    case TRACE_REALLOC:
+      if(objects[op->id] == NULL) {
+        break;
+      }
+      ptr = heapmem_realloc(objects[op->id], op->size);
+      if(ptr == NULL) {
+        failures++;
+      } else {
+        objects[op->id] = ptr;
+        if(verify) {
+          old_size = sizes[op->id];
+          sizes[op->id] = old_size < op->size ? old_size : op->size;
+          check_object(op->id);
+          sizes[op->id] = op->size;
+          fill_object(op->id, old_size < op->size ? old_size : op->size);
+        }
+      }
+      break;
+    case TRACE_FREE:
+      if(verify && objects[op->id] != NULL) {
+        check_object(op->id);
+      }
+      heapmem_free(objects[op->id]);
+      objects[op->id] = NULL;
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_all(void)
+{
+  unsigned i;
+
+  for(i = 0; i < TRACE_OBJECTS; i++) {
+    heapmem_free(objects[i]);
+    objects[i] = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_stats(void)
+{
+  heapmem_stats_t stats;
+  heapmem_class_stats_t class_stats;
+  unsigned cls;
+
+  heapmem_stats(&stats);
+  printf("heapmem-bench: allocated %u overhead %u available %u footprint %u\n",
+         (unsigned)stats.allocated, (unsigned)stats.overhead,
+         (unsigned)stats.available, (unsigned)stats.footprint);
+  printf("heapmem-bench: chunks %u free chunks %u largest free %u (%u%% fragmentation)\n",
+         (unsigned)stats.chunks, (unsigned)stats.free_chunks,
+         (unsigned)stats.largest_free,
+         stats.available ?
+         (unsigned)(100 - 100 * (uint64_t)stats.largest_free / stats.available) : 0);
+
+  for(cls = 0; cls < heapmem_class_count(); cls++) {
+    if(heapmem_class_stats(cls, &class_stats) &&
+       (class_stats.allocations > 0 || class_stats.free_chunks > 0)) {
+      printf("heapmem-bench: class %2u max %5u allocs %7lu fails %5lu free %3u chunks %5u bytes\n",
+             cls, (unsigned)class_stats.max_size, class_stats.allocations,
+             class_stats.failures, (unsigned)class_stats.free_chunks,
+             (unsigned)class_stats.free_bytes);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(heapmem_bench_process, ev, data)
+{
+  static unsigned round;
+  static rtimer_clock_t start, elapsed;
+  unsigned long ops;
+
+  PROCESS_BEGIN();
+
+#ifndef HEAPMEM_BENCH_CONF_TRACE
+  generate_trace();
+#endif
+
+  /* One verified pass first, checking that objects are not corrupted */
+  replay(1);
+  printf("heapmem-bench: %u operations, %lu failed allocations, %lu corrupted objects\n",
+         (unsigned)TRACE_LENGTH, failures, corruptions);
+  print_stats();
+  free_all();
+
+  failures = 0;
+  elapsed = 0;
+  for(round = 0; round < ROUNDS; round++) {
+    start = RTIMER_NOW();
+    replay(0);
+    elapsed += RTIMER_NOW() - start;
+    free_all();
+    PROCESS_PAUSE();
+  }
+
+  ops = (unsigned long)ROUNDS * TRACE_LENGTH;
+  printf("heapmem-bench: %lu operations in %lu ms, %lu ns/op, %lu failed allocations\n",
+         ops, (unsigned long)((uint64_t)elapsed * 1000 / RTIMER_SECOND),
+         (unsigned long)((uint64_t)elapsed * 1000000000ULL / RTIMER_SECOND / ops),
+         failures);
+  printf("heapmem-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,6 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define HEAPMEM_CONF_ARENA_SIZE 16384
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Convert a heapmem debug log into a trace for heapmem-bench.
+
+The log is produced by a firmware built with DEBUG set to 1 in
+os/lib/heapmem.c and with HEAPMEM_DEBUG=1 defined for the application,
+which prints a line for every call to heapmem_alloc(),
+heapmem_realloc() and heapmem_free().
+Any other lines in the log are ignored.
+
+Usage: trace-from-log.py node.log > trace.h
+"""
+
+import re
+import sys
+
+LINE = re.compile(r'heapmem_(alloc|realloc|free)\w* ptr (\S+?),? (?:size (\d+))?')
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+
+    ids = {}          # Live pointer -> object id
+    free_ids = []     # Object ids that can be reused
+    next_id = 0
+    ops = []
+    moved = False     # The previous line was a reallocation
+
+    with open(sys.argv[1], errors='replace') as log:
+        for line in log:
+            match = LINE.search(line)
+            if match is None:
+                continue
+            call, ptr, size = match.groups()
+
+            if call == 'alloc' and moved:
+                # Reallocation that moved the object: heapmem_realloc()
+                # calls heapmem_alloc() for the new location.
+                moved = False
+                ids[ptr] = ids.pop(moved_ptr)
+                continue
+            moved = False
+
+            if call == 'alloc':
+                if free_ids:
+                    obj = free_ids.pop()
+                else:
+                    obj = next_id
+                    next_id += 1
+                ops.append(('TRACE_ALLOC', obj, int(size)))
+                if ptr in ('(nil)', '0x0'):
+                    # Failed allocation, replay it as a short-lived object
+                    ops.append(('TRACE_FREE', obj, 0))
+                    free_ids.append(obj)
+                else:
+                    ids[ptr] = obj
+            elif call == 'realloc':
+                # Reallocations of NULL and to size zero are followed by
+                # an allocation or a free line, respectively.
+                if ptr not in ids or int(size) == 0:
+                    continue
+                ops.append(('TRACE_REALLOC', ids[ptr], int(size)))
+                moved = True
+                moved_ptr = ptr
+            elif ptr in ids:
+                obj = ids.pop(ptr)
+                free_ids.append(obj)
+                ops.append(('TRACE_FREE', obj, 0))
+
+    if not ops:
+        sys.exit('No heapmem calls found in ' + sys.argv[1])
+
+    print('/* Generated by trace-from-log.py from %s */' % sys.argv[1])
+    print('#define TRACE_OBJECTS %d' % max(next_id, 1))
+    print('static const trace_op_t trace[] = {')
+    for op in ops:
+        print('  { %s, %d, %d },' % op)
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for the Internet checksum backends. Measures the
+ *         throughput of every backend built for the platform, for
+ *         packet sizes from a bare IPv6 header to a full 1280-byte
+ *         packet, and checks that all backends agree with the
+ *         reference implementation.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/ip-chksum.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#ifdef IP_CHKSUM_BENCH_CONF_BYTES
+#define BYTES IP_CHKSUM_BENCH_CONF_BYTES
+#else
+#define BYTES (256UL * 1024 * 1024)
+#endif
+
+#define MAX_LEN 1280
+/*---------------------------------------------------------------------------*/
+PROCESS(ip_chksum_bench_process, "Checksum benchmark");
+AUTOSTART_PROCESSES(&ip_chksum_bench_process);
+/*---------------------------------------------------------------------------*/
+struct backend {
+  const char *name;
+  uint16_t (*chksum)(uint16_t sum, const uint8_t *data, uint16_t len);
+};
+
+static const struct backend backends[] = {
+  { "reference", ip_chksum_reference },
+  { "word", ip_chksum_word },
+#if defined(__SSE2__)
+  { "sse2", ip_chksum_sse2 },
+#endif /* __SSE2__ */
+#if defined(__ARM_NEON)
+  { "neon", ip_chksum_neon },
+#endif /* __ARM_NEON */
+};
+
+#define NUM_BACKENDS (sizeof(backends) / sizeof(backends[0]))
+
+static const uint16_t sizes[] = { 40, 128, 512, MAX_LEN };
+
+#define NUM_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+/* One spare byte, to also measure unaligned data */
+static uint8_t buf[MAX_LEN + 1];
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+static void
+check_backends(void)
+{
+  unsigned b, i;
+  uint16_t offset, len, sum, expected;
+
+  for(i = 0; i < 10000; i++) {
+    offset = random_rand() & 1;
+    len = random_rand() % (MAX_LEN + 1);
+    sum = random_rand();
+    expected = ip_chksum_reference(sum, buf + offset, len);
+    for(b = 0; b < NUM_BACKENDS; b++) {
+      if(backends[b].chksum(sum, buf + offset, len) != expected) {
+        errors++;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+kbytes_per_second(const struct backend *backend, const uint8_t *data,
+                  uint16_t len)
+{
+  volatile uint16_t sink;
+  rtimer_clock_t start, elapsed;
+  unsigned long i, n;
+  uint16_t sum;
+
+  n = BYTES / len;
+  sum = 0;
+  start = RTIMER_NOW();
+  for(i = 0; i < n; i++) {
+    sum = backend->chksum(sum, data, len);
+  }
+  elapsed = RTIMER_NOW() - start;
+  sink = sum;
+  (void)sink;
+
+  return elapsed ?
+    (unsigned long)((uint64_t)n * len * RTIMER_SECOND / 1024 / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ip_chksum_bench_process, ev, data)
+{
+  static unsigned b;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = random_rand();
+  }
+
+  check_backends();
+
+  for(b = 0; b < NUM_BACKENDS; b++) {
+    for(i = 0; i < NUM_SIZES; i++) {
+      printf("ip-chksum-bench: %-9s %4u bytes %9lu KiB/s aligned"
+             " %9lu KiB/s unaligned\n",
+             backends[b].name, sizes[i],
+             kbytes_per_second(&backends[b], buf, sizes[i]),
+             kbytes_per_second(&backends[b], buf + 1, sizes[i]));
+    }
+    PROCESS_PAUSE();
+  }
+
+  printf("ip-chksum-bench: IP_CHKSUM is %s, %u errors\n",
+         IP_CHKSUM == ip_chksum_reference ? "reference" : "accelerated",
+         errors);
+  printf("ip-chksum-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for neighbor table lookups. Measures the number of
+ *         nbr_table_get_from_lladdr() calls per second for existing and
+ *         unknown addresses as the table grows, then replaces neighbors
+ *         and checks that all lookups still return the right entries.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef NBR_TABLE_BENCH_CONF_LOOKUPS
+#define LOOKUPS NBR_TABLE_BENCH_CONF_LOOKUPS
+#else
+#define LOOKUPS 200000
+#endif
+
+#define REPLACEMENTS (4 * NBR_TABLE_MAX_NEIGHBORS)
+/*---------------------------------------------------------------------------*/
+PROCESS(nbr_table_bench_process, "Neighbor table benchmark");
+AUTOSTART_PROCESSES(&nbr_table_bench_process);
+/*---------------------------------------------------------------------------*/
+struct bench_nbr {
+  uint16_t id;
+};
+NBR_TABLE(struct bench_nbr, bench_nbrs);
+
+static linkaddr_t addrs[NBR_TABLE_MAX_NEIGHBORS];
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+static void
+make_addr(linkaddr_t *addr, uint16_t id)
+{
+  /* Addresses of a deployment differ in their last bytes */
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = id >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = id & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add(unsigned slot, uint16_t id)
+{
+  struct bench_nbr *nbr;
+
+  make_addr(&addrs[slot], id);
+  nbr = nbr_table_add_lladdr(bench_nbrs, &addrs[slot],
+                             NBR_TABLE_REASON_UNDEFINED, NULL);
+  if(nbr == NULL) {
+    errors++;
+  } else {
+    nbr->id = id;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+lookups_per_second(unsigned n, int hit)
+{
+  static linkaddr_t unknown;
+  rtimer_clock_t start, elapsed;
+  struct bench_nbr *nbr;
+  unsigned long i;
+
+  make_addr(&unknown, 0xffff);
+
+  start = RTIMER_NOW();
+  for(i = 0; i < LOOKUPS; i++) {
+    nbr = nbr_table_get_from_lladdr(bench_nbrs,
+                                    hit ? &addrs[i % n] : &unknown);
+    if((nbr != NULL) != hit) {
+      errors++;
+    }
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  return elapsed ? (unsigned long)((uint64_t)LOOKUPS * RTIMER_SECOND / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_all(void)
+{
+  struct bench_nbr *nbr;
+  unsigned i;
+
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    nbr = nbr_table_get_from_lladdr(bench_nbrs, &addrs[i]);
+    if(nbr == NULL ||
+       !linkaddr_cmp(nbr_table_get_lladdr(bench_nbrs, nbr), &addrs[i])) {
+      errors++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(nbr_table_bench_process, ev, data)
+{
+  static unsigned n, next_size;
+  static uint16_t next_id;
+  unsigned slot;
+  struct bench_nbr *nbr;
+
+  PROCESS_BEGIN();
+
+  nbr_table_register(bench_nbrs, NULL);
+
+  printf("nbr-table-bench: %s, %u neighbors max\n",
+         NBR_TABLE_HASH_INDEX ? "hash index" : "list", NBR_TABLE_MAX_NEIGHBORS);
+
+  /* Grow the table, measuring at each power of two */
+  next_size = 8;
+  for(n = 0; n < NBR_TABLE_MAX_NEIGHBORS; n++) {
+    add(n, next_id++);
+    if(n + 1 == next_size || n + 1 == NBR_TABLE_MAX_NEIGHBORS) {
+      printf("nbr-table-bench: neighbors %4u hit %9lu miss %9lu lookups/s\n",
+             n + 1, lookups_per_second(n + 1, 1), lookups_per_second(n + 1, 0));
+      next_size *= 2;
+      PROCESS_PAUSE();
+    }
+  }
+
+  /* Replace random neighbors, which are evicted to make room */
+  for(n = 0; n < REPLACEMENTS; n++) {
+    slot = random_rand() % NBR_TABLE_MAX_NEIGHBORS;
+    nbr = nbr_table_get_from_lladdr(bench_nbrs, &addrs[slot]);
+    if(nbr == NULL) {
+      errors++;
+      continue;
+    }
+    nbr_table_remove(bench_nbrs, nbr);
+    add(slot, next_id++);
+  }
+  check_all();
+
+  printf("nbr-table-bench: %u replacements, %u errors\n", REPLACEMENTS, errors);
+  printf("nbr-table-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
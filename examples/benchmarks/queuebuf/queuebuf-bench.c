@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for the packet buffer handling of the MAC layers.
+ *         Forwards frames over a number of hops, running at each hop
+ *         the packetbuf and queuebuf operations that CSMA and TSCH make
+ *         on reception, queueing, (re)transmission and sent callback.
+ *         The radio is replaced by copies to and from a frame buffer.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/mac/framer/framer-802154.h"
+#include "net/mac/framer/frame802154.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef QUEUEBUF_BENCH_CONF_HOPS
+#define HOPS QUEUEBUF_BENCH_CONF_HOPS
+#else
+#define HOPS 6
+#endif
+
+/* Transmissions per frame and hop, i.e. one plus retransmissions */
+#ifdef QUEUEBUF_BENCH_CONF_TRANSMISSIONS
+#define TRANSMISSIONS QUEUEBUF_BENCH_CONF_TRANSMISSIONS
+#else
+#define TRANSMISSIONS 2
+#endif
+
+#ifdef QUEUEBUF_BENCH_CONF_FRAMES
+#define FRAMES QUEUEBUF_BENCH_CONF_FRAMES
+#else
+#define FRAMES 100000
+#endif
+
+#define PAYLOAD_LEN 100
+/*---------------------------------------------------------------------------*/
+PROCESS(queuebuf_bench_process, "Queuebuf benchmark");
+AUTOSTART_PROCESSES(&queuebuf_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint8_t radio_frame[PACKETBUF_SIZE];
+static uint16_t radio_len;
+static linkaddr_t next_hop;
+static unsigned long checksum;
+/*---------------------------------------------------------------------------*/
+/* Radio reception of a frame, and parsing by the framer */
+static int
+receive(void)
+{
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), radio_frame, radio_len);
+  packetbuf_set_datalen(radio_len);
+  return framer_802154.parse() >= 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Header compression output: the payload is rewritten into the packetbuf */
+static void
+prepare_output(const uint8_t *payload, uint16_t len)
+{
+  packetbuf_copyfrom(payload, len);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 1 + (checksum & 0x7f));
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+}
+/*---------------------------------------------------------------------------*/
+/* Sent callback of the upper layers, reading attributes */
+static void
+sent_callback(void)
+{
+  checksum += packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) +
+    packetbuf_datalen() + packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[0];
+}
+/*---------------------------------------------------------------------------*/
+/* CSMA: the frame is queued without MAC header, and framed again for
+   each transmission */
+static void
+csma_hop(const uint8_t *payload)
+{
+  struct queuebuf *q;
+  int tx;
+
+  prepare_output(payload, PAYLOAD_LEN);
+  q = queuebuf_new_from_packetbuf();
+  if(q == NULL) {
+    return;
+  }
+
+  for(tx = 0; tx < TRANSMISSIONS; tx++) {
+    queuebuf_to_packetbuf(q);
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+    if(framer_802154.create() < 0) {
+      break;
+    }
+    radio_len = packetbuf_totlen();
+    memcpy(radio_frame, packetbuf_hdrptr(), radio_len);
+    queuebuf_update_attr_from_packetbuf(q);
+  }
+
+  queuebuf_free(q);
+  sent_callback();
+}
+/*---------------------------------------------------------------------------*/
+/* TSCH: the frame is queued with its MAC header, transmitted from the
+   queuebuf, and put back in the packetbuf for the sent callback */
+static void
+tsch_hop(const uint8_t *payload)
+{
+  struct queuebuf *q;
+  int tx;
+
+  prepare_output(payload, PAYLOAD_LEN);
+  if(framer_802154.create() < 0) {
+    return;
+  }
+  q = queuebuf_new_from_packetbuf();
+  if(q == NULL) {
+    return;
+  }
+
+  for(tx = 0; tx < TRANSMISSIONS; tx++) {
+    radio_len = queuebuf_datalen(q);
+    memcpy(radio_frame, queuebuf_dataptr(q), radio_len);
+  }
+
+  queuebuf_to_packetbuf(q);
+  sent_callback();
+  queuebuf_free(q);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+run(void (*hop)(const uint8_t *payload))
+{
+  static uint8_t payload[PACKETBUF_SIZE];
+  rtimer_clock_t start;
+  unsigned long i;
+  int h;
+
+  /* The first frame comes from the application */
+  memset(payload, 0x5a, sizeof(payload));
+
+  start = RTIMER_NOW();
+  for(i = 0; i < FRAMES; i++) {
+    hop(payload);
+    for(h = 1; h < HOPS; h++) {
+      /* Receive the frame from the previous hop and forward it */
+      if(receive()) {
+        memcpy(payload, packetbuf_dataptr(), PAYLOAD_LEN);
+      }
+      hop(payload);
+    }
+  }
+
+  return (unsigned long)((uint64_t)(rtimer_clock_t)(RTIMER_NOW() - start) *
+                         1000000000ULL / RTIMER_SECOND / FRAMES);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(queuebuf_bench_process, ev, data)
+{
+  static unsigned long csma_ns, tsch_ns;
+
+  PROCESS_BEGIN();
+
+  frame802154_set_pan_id(IEEE802154_PANID);
+  next_hop.u8[0] = 1;
+
+  printf("queuebuf-bench: %u hops, %u transmissions per hop, %u frames\n",
+         HOPS, TRANSMISSIONS, FRAMES);
+
+  csma_ns = run(csma_hop);
+  PROCESS_PAUSE();
+  tsch_ns = run(tsch_hop);
+
+  printf("queuebuf-bench: csma %lu ns, tsch %lu ns per forwarded frame (%lu)\n",
+         csma_ns, tsch_ns, checksum);
+  printf("queuebuf-bench: free queuebufs %d\n", queuebuf_numfree());
+  printf("queuebuf-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for the non-storing RPL root. Feeds DAOs for a tree
+ *         of nodes to RPL, and measures the number of DAOs processed
+ *         per second, and the number of downward packets per second for
+ *         which a source routing header is inserted. Every header is
+ *         checked against the source routing graph.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "net/routing/routing.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/ipv6/uipbuf.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef RPL_SRH_BENCH_CONF_PACKETS
+#define PACKETS RPL_SRH_BENCH_CONF_PACKETS
+#else
+#define PACKETS 100000
+#endif
+
+/* Children per node */
+#define FANOUT 3
+/* The root is a node of the graph too */
+#define NODES (UIP_SR_LINK_NUM - 1)
+/* Destinations of most downward traffic */
+#define HOT_NODES 4
+#define UDP_PAYLOAD_LEN 16
+/*---------------------------------------------------------------------------*/
+PROCESS(rpl_srh_bench_process, "SRH benchmark");
+AUTOSTART_PROCESSES(&rpl_srh_bench_process);
+/*---------------------------------------------------------------------------*/
+static uip_ipaddr_t root_addr;
+static unsigned errors;
+#if RPL_DAO_BATCH_SIZE
+static unsigned batched_daos;
+#endif /* RPL_DAO_BATCH_SIZE */
+/*---------------------------------------------------------------------------*/
+/* Nodes are numbered from 1, 0 is the root */
+static void
+node_addr(uip_ipaddr_t *addr, uint16_t id)
+{
+  if(id == 0) {
+    uip_ipaddr_copy(addr, &root_addr);
+  } else {
+    uip_ipaddr_copy(addr, &root_addr);
+    addr->u8[8] = 0x02;
+    addr->u8[9] = 0x12;
+    addr->u8[10] = 0x74;
+    addr->u8[11] = 0x00;
+    addr->u8[12] = 0;
+    addr->u8[13] = 0;
+    addr->u8[14] = id >> 8;
+    addr->u8[15] = id & 0xff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+flush_daos(void)
+{
+#if RPL_DAO_BATCH_SIZE
+  rpl_dag_apply_dao_batch();
+  batched_daos = 0;
+#endif /* RPL_DAO_BATCH_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+static void
+dao_input(uint16_t id)
+{
+  uip_ipaddr_t from;
+  rpl_dao_t dao;
+
+  memset(&dao, 0, sizeof(dao));
+  node_addr(&from, id);
+  node_addr(&dao.parent_addr, (id - 1) / FANOUT);
+  dao.lifetime = curr_instance.default_lifetime;
+  rpl_process_dao(&from, &dao);
+#if RPL_DAO_BATCH_SIZE
+  /* A full batch makes the batch timer fire right away, before the next
+     DAO comes in */
+  if(++batched_daos == RPL_DAO_BATCH_SIZE) {
+    flush_daos();
+  }
+#endif /* RPL_DAO_BATCH_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+/* Build a UDP packet from the root in uip_buf, and insert the RPL
+ * extension headers as done before forwarding */
+static int
+packet_output(uint16_t id)
+{
+  memset(uip_buf, 0, UIP_IPUDPH_LEN + UDP_PAYLOAD_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = uip_ds6_if.cur_hop_limit;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root_addr);
+  node_addr(&UIP_IP_BUF->destipaddr, id);
+  uip_len = UIP_IPUDPH_LEN + UDP_PAYLOAD_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  uipbuf_clear_attr();
+  uip_ext_len = 0;
+  return rpl_ext_header_update();
+}
+/*---------------------------------------------------------------------------*/
+/* Check the source routing header of the packet in uip_buf against the
+ * path from the root to node id */
+static void
+check_srh(uint16_t id)
+{
+  struct uip_routing_hdr *rh = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+  struct uip_rpl_srh_hdr *srh = (struct uip_rpl_srh_hdr *)(UIP_IP_PAYLOAD(0) + RPL_RH_LEN);
+  uip_sr_node_t *root_node;
+  uip_sr_node_t *node;
+  uip_ipaddr_t dest;
+  uip_ipaddr_t expected;
+  uint8_t cmpr;
+  uint8_t *addr_ptr;
+  int i;
+
+  node_addr(&dest, id);
+  root_node = uip_sr_get_node(NULL, &root_addr);
+  node = uip_sr_get_node(NULL, &dest);
+
+  if(UIP_IP_BUF->proto != UIP_PROTO_ROUTING
+     || rh->routing_type != RPL_RH_TYPE_SRH || node == NULL) {
+    errors++;
+    return;
+  }
+  cmpr = srh->cmpr >> 4;
+  addr_ptr = (uint8_t *)srh + RPL_SRH_LEN + (rh->seg_left - 1) * (16 - cmpr);
+
+  /* The addresses are from the first hop down to the destination */
+  for(i = rh->seg_left - 1; i >= 0; i--) {
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&expected, node);
+    if(node->parent == root_node
+       || memcmp(addr_ptr, &expected.u8[cmpr], 16 - cmpr) != 0
+       || memcmp(&expected, &dest, cmpr) != 0) {
+      errors++;
+      return;
+    }
+    addr_ptr -= 16 - cmpr;
+    node = node->parent;
+  }
+  /* The first hop is the IPv6 destination */
+  NETSTACK_ROUTING.get_sr_node_ipaddr(&expected, node);
+  if(node->parent != root_node
+     || !uip_ipaddr_cmp(&expected, &UIP_IP_BUF->destipaddr)) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+per_second(unsigned long count, rtimer_clock_t elapsed)
+{
+  return elapsed ? (unsigned long)((uint64_t)count * RTIMER_SECOND / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+packets_per_second(const uint16_t *ids, unsigned num_ids)
+{
+  rtimer_clock_t start;
+  unsigned long i;
+
+  start = RTIMER_NOW();
+  for(i = 0; i < PACKETS; i++) {
+    if(!packet_output(ids[i % num_ids])) {
+      errors++;
+    }
+  }
+  return per_second(PACKETS, RTIMER_NOW() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rpl_srh_bench_process, ev, data)
+{
+  static uint16_t ids[64];
+  rtimer_clock_t start;
+  unsigned long daos;
+  uint16_t id;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("rpl-srh-bench: %u nodes, DAO batch %u, SRH cache %u\n",
+         UIP_SR_LINK_NUM, RPL_DAO_BATCH_SIZE, RPL_SRH_CACHE_SIZE);
+
+  NETSTACK_ROUTING.root_start();
+  if(!NETSTACK_ROUTING.get_root_ipaddr(&root_addr)) {
+    printf("rpl-srh-bench: not root\n");
+    PROCESS_EXIT();
+  }
+
+  /* Build the graph */
+  for(id = 1; id <= NODES; id++) {
+    dao_input(id);
+  }
+  flush_daos();
+  if(uip_sr_num_nodes() != NODES + 1) {
+    errors++;
+  }
+
+  /* DAO refreshes, as sent periodically by every node */
+  start = RTIMER_NOW();
+  for(i = 0; i < PACKETS / 10; i++) {
+    dao_input(1 + i % NODES);
+  }
+  flush_daos();
+  daos = per_second(PACKETS / 10, RTIMER_NOW() - start);
+
+  /* Check the headers to every node */
+  for(id = 1; id <= NODES; id++) {
+    if(!packet_output(id)) {
+      errors++;
+    }
+    check_srh(id);
+  }
+
+  for(i = 0; i < 64; i++) {
+    ids[i] = NODES - random_rand() % (NODES / 2);
+  }
+  printf("rpl-srh-bench: %lu DAOs/s, %lu packets/s to %u nodes, %lu packets/s to 64 nodes\n",
+         daos, packets_per_second(ids, HOT_NODES), HOT_NODES,
+         packets_per_second(ids, 64));
+
+  /* Move nodes around and check the headers again */
+  for(i = 0; i < NODES; i++) {
+    id = 1 + random_rand() % NODES;
+    if(!packet_output(id)) {
+      errors++;
+    }
+    check_srh(id);
+    dao_input(1 + random_rand() % NODES);
+    flush_daos();
+  }
+
+  printf("rpl-srh-bench: %u nodes, %u errors\n", uip_sr_num_nodes(), errors);
+  printf("rpl-srh-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
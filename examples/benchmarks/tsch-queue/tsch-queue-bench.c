@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for the TSCH neighbor queues, from the point of view of
+ *         a coordinator with many neighbors and a shared cell. Every slot
+ *         picks a neighbor to transmit to on the shared cell, and updates
+ *         the backoff windows. Prints the number of slots per second and
+ *         checks every selection against a walk over all neighbors.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef TSCH_QUEUE_BENCH_CONF_SLOTS
+#define SLOTS TSCH_QUEUE_BENCH_CONF_SLOTS
+#else
+#define SLOTS 100000
+#endif
+
+/* The number of packets kept in the queues */
+#define PACKETS 8
+/* Transmissions fail with a probability of 1/FAILURE */
+#define FAILURE 4
+/* The virtual EB and broadcast neighbors use two table entries */
+#define CHILDREN (NBR_TABLE_MAX_NEIGHBORS - 2)
+/*---------------------------------------------------------------------------*/
+PROCESS(tsch_queue_bench_process, "TSCH queue benchmark");
+AUTOSTART_PROCESSES(&tsch_queue_bench_process);
+/*---------------------------------------------------------------------------*/
+/* The parts of TSCH the queues depend on. There is no slot operation to
+   lock out. */
+#if LINKADDR_SIZE == 8
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+#else
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+#endif
+const linkaddr_t tsch_eb_address = { { 0 } };
+int tsch_is_coordinator = 1;
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_neighbor *children[CHILDREN];
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+static void
+child_address(linkaddr_t *addr, unsigned i)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = (i + 1) >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = (i + 1) & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_packet(void)
+{
+  linkaddr_t addr;
+
+  child_address(&addr, random_rand() % CHILDREN);
+  if(tsch_queue_add_packet(&addr, 3, NULL, NULL) == NULL) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Is there any neighbor the shared cell can be used for? */
+static int
+any_ready(void)
+{
+  unsigned i;
+
+  for(i = 0; i < CHILDREN; i++) {
+    if(!tsch_queue_is_empty(children[i])
+       && tsch_queue_backoff_expired(children[i])) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_queue_bench_process, ev, data)
+{
+  static struct tsch_link link;
+  static unsigned long sent;
+  static unsigned long busy;
+  struct tsch_neighbor *n;
+  struct tsch_packet *p;
+  rtimer_clock_t start, elapsed;
+  linkaddr_t addr;
+  unsigned long i;
+
+  PROCESS_BEGIN();
+
+  printf("tsch-queue-bench: %s, %u neighbors\n",
+         TSCH_QUEUE_WITH_BITMAP ? "bitmap" : "walk", NBR_TABLE_MAX_NEIGHBORS);
+
+  tsch_queue_init();
+  for(i = 0; i < CHILDREN; i++) {
+    child_address(&addr, i);
+    children[i] = tsch_queue_add_nbr(&addr);
+    if(children[i] == NULL) {
+      errors++;
+      PROCESS_EXIT();
+    }
+  }
+
+  /* The shared cell of the minimal schedule */
+  link.link_options = LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED;
+  linkaddr_copy(&link.addr, &tsch_broadcast_address);
+
+  random_init(1);
+  for(i = 0; i < PACKETS; i++) {
+    add_packet();
+  }
+
+  start = RTIMER_NOW();
+  for(i = 0; i < SLOTS; i++) {
+    n = NULL;
+    p = tsch_queue_get_unicast_packet_for_any(&n, &link);
+    if(p != NULL) {
+      busy++;
+      p->transmissions++;
+      if(!tsch_queue_packet_sent(n, p, &link,
+                                 random_rand() % FAILURE ? MAC_TX_OK : MAC_TX_NOACK)) {
+        /* Keep the number of queued packets constant */
+        tsch_queue_free_packet(p);
+        sent++;
+        add_packet();
+      }
+    }
+    tsch_queue_update_all_backoff_windows(&link.addr);
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  printf("tsch-queue-bench: %lu slots/s\n",
+         elapsed ? (unsigned long)((uint64_t)SLOTS * RTIMER_SECOND / elapsed) : 0);
+
+  /* Same again, checking that the shared cell is used whenever a
+     neighbor is ready */
+  for(i = 0; i < SLOTS / 10; i++) {
+    int ready = any_ready();
+    n = NULL;
+    p = tsch_queue_get_unicast_packet_for_any(&n, &link);
+    if((p != NULL) != ready
+       || (p != NULL && (tsch_queue_is_empty(n) || !tsch_queue_backoff_expired(n)))) {
+      errors++;
+    }
+    if(p != NULL) {
+      p->transmissions++;
+      if(!tsch_queue_packet_sent(n, p, &link,
+                                 random_rand() % FAILURE ? MAC_TX_OK : MAC_TX_NOACK)) {
+        tsch_queue_free_packet(p);
+        sent++;
+        add_packet();
+      }
+    }
+    tsch_queue_update_all_backoff_windows(&link.addr);
+  }
+
+  printf("tsch-queue-bench: %lu busy slots, %lu packets sent, %u errors\n",
+         busy, sent, errors);
+  printf("tsch-queue-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
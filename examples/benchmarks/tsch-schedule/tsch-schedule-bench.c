@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for the TSCH schedule. Builds a schedule of 1000 links
+ *         over three slotframes and measures the number of
+ *         tsch_schedule_get_next_active_link() calls per second, as well
+ *         as the cost of removing and adding links. Prints a checksum of
+ *         the selected links, which must not depend on the lookup method.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef TSCH_SCHEDULE_BENCH_CONF_LOOKUPS
+#define LOOKUPS TSCH_SCHEDULE_BENCH_CONF_LOOKUPS
+#else
+#define LOOKUPS 100000
+#endif
+
+#define NUM_LINKS 1000
+#define UPDATES 5000
+
+/* A minimal-like slotframe with a single shared cell, an Orchestra-like
+   receiver-based slotframe and a slotframe of negotiated cells */
+static const uint16_t sf_sizes[] = { 101, 397, 1009 };
+static const uint16_t sf_links[] = { 1, 397, NUM_LINKS - 1 - 397 };
+#define NUM_SLOTFRAMES (sizeof(sf_sizes) / sizeof(sf_sizes[0]))
+/*---------------------------------------------------------------------------*/
+PROCESS(tsch_schedule_bench_process, "TSCH schedule benchmark");
+AUTOSTART_PROCESSES(&tsch_schedule_bench_process);
+/*---------------------------------------------------------------------------*/
+static struct tsch_slotframe *slotframes[NUM_SLOTFRAMES];
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+/* The parts of TSCH the schedule depends on. There is no slot operation
+   to lock out, and the neighbors only count their Tx links. */
+#define NUM_NEIGHBORS 33
+static struct tsch_neighbor neighbors[NUM_NEIGHBORS];
+static linkaddr_t neighbor_addrs[NUM_NEIGHBORS];
+static unsigned num_neighbors;
+
+#if LINKADDR_SIZE == 8
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+#else
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+#endif
+struct tsch_link *current_link;
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  unsigned i;
+
+  for(i = 0; i < num_neighbors; i++) {
+    if(linkaddr_cmp(&neighbor_addrs[i], addr)) {
+      return &neighbors[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  struct tsch_neighbor *n = tsch_queue_get_nbr(addr);
+
+  if(n == NULL && num_neighbors < NUM_NEIGHBORS) {
+    n = &neighbors[num_neighbors++];
+    memset(n, 0, sizeof(*n));
+    linkaddr_copy(&neighbor_addrs[n - neighbors], addr);
+    ringbufindex_init(&n->tx_ringbuf, TSCH_QUEUE_NUM_PER_NEIGHBOR);
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_link *
+add_link(unsigned sf, unsigned i)
+{
+  linkaddr_t addr;
+  uint8_t options;
+  uint16_t timeslot;
+  uint16_t channel_offset;
+  struct tsch_link *l;
+
+  memset(&addr, 0, sizeof(addr));
+  if(sf == 0) {
+    options = LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED;
+    timeslot = 0;
+    channel_offset = 0;
+  } else {
+    /* Spread the cells over the slotframe, several per timeslot in the
+       larger one, and alternate between Rx cells and Tx cells to one of
+       32 neighbors */
+    timeslot = (i * 7) % sf_sizes[sf];
+    channel_offset = 1 + (i * 7) / sf_sizes[sf];
+    if(i % 2) {
+      options = LINK_OPTION_RX;
+    } else {
+      options = LINK_OPTION_TX | (i % 4 ? LINK_OPTION_SHARED : 0);
+      addr.u8[0] = 0x02;
+      addr.u8[LINKADDR_SIZE - 1] = 1 + i % 32;
+    }
+  }
+  l = tsch_schedule_add_link(slotframes[sf], options, LINK_TYPE_NORMAL,
+                             &addr, timeslot, channel_offset, 1);
+  if(l == NULL) {
+    errors++;
+  }
+  return l;
+}
+/*---------------------------------------------------------------------------*/
+/* Looks up the next active link from many ASNs. Returns the number of
+   lookups per second, and updates the checksum of the selected links. */
+static unsigned long
+lookups_per_second(uint32_t *checksum)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *l;
+  struct tsch_link *backup;
+  uint16_t time_offset;
+  rtimer_clock_t start, elapsed;
+  unsigned long i;
+
+  TSCH_ASN_INIT(asn, 0, 0);
+  start = RTIMER_NOW();
+  for(i = 0; i < LOOKUPS; i++) {
+    l = tsch_schedule_get_next_active_link(&asn, &time_offset, &backup);
+    if(l == NULL) {
+      errors++;
+      break;
+    }
+    *checksum = *checksum * 31 + l->handle;
+    *checksum = *checksum * 31 + time_offset;
+    *checksum = *checksum * 31 + (backup != NULL ? backup->handle : 0xffff);
+    /* Move on to the selected slot, as the slot operation would, or to
+       an arbitrary slot from time to time */
+    if(i % 16 == 0) {
+      TSCH_ASN_INC(asn, 1 + random_rand() % 1024);
+    } else {
+      TSCH_ASN_INC(asn, time_offset);
+    }
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  return elapsed ? (unsigned long)((uint64_t)LOOKUPS * RTIMER_SECOND / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Removes and adds back links. Returns the number of updates per second. */
+static unsigned long
+updates_per_second(void)
+{
+  rtimer_clock_t start, elapsed;
+  unsigned n;
+  unsigned i;
+  struct tsch_link *l;
+
+  start = RTIMER_NOW();
+  for(n = 0; n < UPDATES; n++) {
+    i = random_rand() % sf_links[2];
+    l = tsch_schedule_get_link_by_timeslot(slotframes[2],
+                                           (i * 7) % sf_sizes[2],
+                                           1 + (i * 7) / sf_sizes[2]);
+    if(l == NULL || !tsch_schedule_remove_link(slotframes[2], l)) {
+      errors++;
+    }
+    add_link(2, i);
+  }
+  elapsed = RTIMER_NOW() - start;
+
+  return elapsed ? (unsigned long)((uint64_t)UPDATES * RTIMER_SECOND / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_schedule_bench_process, ev, data)
+{
+  static uint32_t checksum;
+  unsigned sf;
+  unsigned i;
+  unsigned long rate;
+
+  PROCESS_BEGIN();
+
+  printf("tsch-schedule-bench: %s, %u links\n",
+         TSCH_SCHEDULE_WITH_INDEX ? "index" : "list", NUM_LINKS);
+
+  tsch_schedule_remove_all_slotframes();
+  for(sf = 0; sf < NUM_SLOTFRAMES; sf++) {
+    slotframes[sf] = tsch_schedule_add_slotframe(sf, sf_sizes[sf]);
+    for(i = 0; i < sf_links[sf]; i++) {
+      add_link(sf, i);
+    }
+  }
+
+  /* The same sequence of ASNs for both lookup methods */
+  random_init(1);
+  rate = lookups_per_second(&checksum);
+  printf("tsch-schedule-bench: %lu next-link lookups/s\n", rate);
+  printf("tsch-schedule-bench: %lu link updates/s\n", updates_per_second());
+  printf("tsch-schedule-bench: checksum %08lx, %u errors\n",
+         (unsigned long)checksum, errors);
+  printf("tsch-schedule-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Benchmark for the source routing graph of a non-storing RPL
+ *         root. Builds a tree of nodes, and measures the number of
+ *         uip_sr_update_node() calls (one per DAO) and uip_sr_get_path()
+ *         calls (one per downward packet) per second as the graph grows.
+ *         Paths are checked against a walk of the graph, also after
+ *         nodes change parent.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/routing/routing.h"
+#include "lib/random.h"
+#include "sys/rtimer.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#ifdef UIP_SR_BENCH_CONF_LOOKUPS
+#define LOOKUPS UIP_SR_BENCH_CONF_LOOKUPS
+#else
+#define LOOKUPS 100000
+#endif
+
+/* Children per node */
+#define FANOUT 4
+/* The root is a node of the graph too */
+#define NODES (UIP_SR_LINK_NUM - 1)
+#define REPARENTS (4 * UIP_SR_LINK_NUM)
+#define LIFETIME 3600
+/*---------------------------------------------------------------------------*/
+PROCESS(uip_sr_bench_process, "Source routing benchmark");
+AUTOSTART_PROCESSES(&uip_sr_bench_process);
+/*---------------------------------------------------------------------------*/
+static uip_ipaddr_t root_addr;
+static unsigned errors;
+/*---------------------------------------------------------------------------*/
+/* Nodes are numbered from 1, 0 is the root */
+static void
+node_addr(uip_ipaddr_t *addr, uint16_t id)
+{
+  if(id == 0) {
+    uip_ipaddr_copy(addr, &root_addr);
+  } else {
+    memcpy(addr, &root_addr, 8);
+    uip_ip6addr_u8(addr, addr->u8[0], addr->u8[1], addr->u8[2], addr->u8[3],
+                   addr->u8[4], addr->u8[5], addr->u8[6], addr->u8[7],
+                   0x02, 0x12, 0x74, 0x00, 0, 0, id >> 8, id & 0xff);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_node(uint16_t id, uint16_t parent)
+{
+  uip_ipaddr_t child_addr, parent_addr;
+
+  node_addr(&child_addr, id);
+  node_addr(&parent_addr, parent);
+  if(uip_sr_update_node(NULL, &child_addr, &parent_addr, LIFETIME) == NULL) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_path(uint16_t id)
+{
+  uip_ipaddr_t addr;
+  const uip_sr_path_t *path;
+  uip_sr_node_t *node;
+  uip_sr_node_t *root_node;
+  unsigned len = 0;
+
+  node_addr(&addr, id);
+  path = uip_sr_get_path(NULL, &addr);
+  root_node = uip_sr_get_node(NULL, &root_addr);
+  node = uip_sr_get_node(NULL, &addr);
+  if(path == NULL || path->node != node) {
+    errors++;
+    return;
+  }
+  while(node->parent != root_node) {
+    node = node->parent;
+    len++;
+  }
+  if(path->len != len || path->first_hop != node) {
+    errors++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+per_second(unsigned long count, rtimer_clock_t elapsed)
+{
+  return elapsed ? (unsigned long)((uint64_t)count * RTIMER_SECOND / elapsed) : 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+measure(uint16_t n)
+{
+  static uint16_t ids[64];
+  uip_ipaddr_t addr;
+  rtimer_clock_t start, daos, paths, cached;
+  unsigned long i;
+
+  for(i = 0; i < 64; i++) {
+    ids[i] = 1 + random_rand() % n;
+  }
+
+  /* DAO refreshes */
+  start = RTIMER_NOW();
+  for(i = 0; i < LOOKUPS / 10; i++) {
+    update_node(ids[i % 64], (ids[i % 64] - 1) / FANOUT);
+  }
+  daos = RTIMER_NOW() - start;
+
+  /* Paths to varying destinations */
+  start = RTIMER_NOW();
+  for(i = 0; i < LOOKUPS; i++) {
+    node_addr(&addr, ids[i % 64]);
+    uip_sr_get_path(NULL, &addr);
+  }
+  paths = RTIMER_NOW() - start;
+
+  /* Paths to the same destination */
+  node_addr(&addr, ids[0]);
+  start = RTIMER_NOW();
+  for(i = 0; i < LOOKUPS; i++) {
+    uip_sr_get_path(NULL, &addr);
+  }
+  cached = RTIMER_NOW() - start;
+
+  printf("uip-sr-bench: nodes %5u %8lu DAOs/s %9lu paths/s %9lu cached paths/s\n",
+         n + 1, per_second(LOOKUPS / 10, daos), per_second(LOOKUPS, paths),
+         per_second(LOOKUPS, cached));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(uip_sr_bench_process, ev, data)
+{
+  static uint16_t n, next_size;
+  uint16_t id, parent;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("uip-sr-bench: %s, %u nodes\n",
+         UIP_SR_HASH_INDEX ? "hash index" : "list", UIP_SR_LINK_NUM);
+
+  NETSTACK_ROUTING.root_start();
+  if(!NETSTACK_ROUTING.get_root_ipaddr(&root_addr)) {
+    printf("uip-sr-bench: not root\n");
+    PROCESS_EXIT();
+  }
+
+  /* Grow the graph, measuring at each power of two */
+  next_size = 16;
+  for(n = 1; n <= NODES; n++) {
+    update_node(n, (n - 1) / FANOUT);
+    if(n + 1 == next_size || n == NODES) {
+      for(i = 1; i <= n; i++) {
+        check_path(i);
+      }
+      measure(n);
+      next_size *= 2;
+      PROCESS_PAUSE();
+    }
+  }
+
+  /* Move random nodes to random parents. Updates that would create a
+   * loop are ignored by uip-sr. */
+  for(i = 0; i < REPARENTS; i++) {
+    id = 1 + random_rand() % NODES;
+    parent = random_rand() % NODES;
+    if(parent != id) {
+      update_node(id, parent);
+    }
+    check_path(1 + random_rand() % NODES);
+  }
+  for(i = 1; i <= NODES; i++) {
+    check_path(i);
+  }
+
+  printf("uip-sr-bench: %u parent changes, %u nodes, %u errors\n",
+         REPARENTS, uip_sr_num_nodes(), errors);
+  printf("uip-sr-bench: done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
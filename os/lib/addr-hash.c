@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \addtogroup addr-hash
+ * @{ */
+
+/**
+ * \file
+ *         Implementation of the address hash index
+ */
+
+#include "lib/addr-hash.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+static void
+set_slot(const struct addr_hash *h, unsigned slot, unsigned entry)
+{
+  if(h->slot_size == 1) {
+    ((uint8_t *)h->slots)[slot] = entry;
+  } else {
+    ((uint16_t *)h->slots)[slot] = entry;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+addr_hash_clear(const struct addr_hash *h)
+{
+  memset(h->slots, 0, ((size_t)h->mask + 1) * h->slot_size);
+}
+/*---------------------------------------------------------------------------*/
+void
+addr_hash_insert(const struct addr_hash *h, unsigned home, unsigned entry)
+{
+  unsigned slot = home;
+
+  while(addr_hash_get(h, slot) != 0) {
+    slot = addr_hash_next(h, slot);
+  }
+  set_slot(h, slot, entry);
+}
+/*---------------------------------------------------------------------------*/
+int
+addr_hash_remove(const struct addr_hash *h, unsigned home, unsigned entry)
+{
+  unsigned slot = home;
+  unsigned next;
+
+  while(addr_hash_get(h, slot) != entry) {
+    if(addr_hash_get(h, slot) == 0) {
+      return 0;
+    }
+    slot = addr_hash_next(h, slot);
+  }
+
+  next = slot;
+  for(;;) {
+    set_slot(h, slot, 0);
+    do {
+      next = addr_hash_next(h, next);
+      if(addr_hash_get(h, next) == 0) {
+        return 1;
+      }
+      home = h->home(addr_hash_get(h, next));
+      /* Keep the entry in place if its home slot is cyclically in
+       * (slot, next] */
+    } while(slot <= next ? (slot < home && home <= next)
+            : (slot < home || home <= next));
+    set_slot(h, slot, addr_hash_get(h, next));
+    slot = next;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \addtogroup lib
+ * @{ */
+
+/**
+ * \defgroup addr-hash Address hash index
+ *
+ * An open addressing hash index with linear probing, for finding the
+ * entries of a table from their address in constant time. Each slot
+ * holds the position of an entry in its table plus one, or zero if
+ * empty. Removing an entry moves the following slots of its probe
+ * sequence back, so that no tombstones are needed and a lookup stops at
+ * the first empty slot. The index should have at least twice as many
+ * slots as the table has entries, so that probe sequences stay short.
+ *
+ * Addresses are hashed with 32-bit FNV-1a, folded to the size of the
+ * index.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the address hash index
+ */
+
+#ifndef ADDR_HASH_H_
+#define ADDR_HASH_H_
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/** The smallest supported index size (a power of two) of at least n slots */
+#define ADDR_HASH_SIZE_AT_LEAST(n) \
+  ((n) <= 8 ? 8 : (n) <= 16 ? 16 : (n) <= 32 ? 32 : (n) <= 64 ? 64 : \
+   (n) <= 128 ? 128 : (n) <= 256 ? 256 : (n) <= 512 ? 512 : \
+   (n) <= 1024 ? 1024 : (n) <= 2048 ? 2048 : (n) <= 4096 ? 4096 : \
+   (n) <= 8192 ? 8192 : 16384)
+
+/** The initial value of an FNV-1a hash */
+#define ADDR_HASH_FNV1A_INIT 2166136261UL
+
+/** An address hash index */
+struct addr_hash {
+  /** The slots, of slot_size bytes each */
+  void *slots;
+  /** The size of a slot: 1 or 2 bytes */
+  uint8_t slot_size;
+  /** The number of slots minus one. The number of slots is a power of two. */
+  uint16_t mask;
+  /** Returns the home slot of the address of an entry, given as its
+      position in the table plus one */
+  unsigned (*home)(unsigned entry);
+};
+
+/**
+ * \brief Define an address hash index
+ * \param name The name of the index
+ * \param size The number of slots, a power of two
+ * \param slot_type The type of a slot: uint8_t or uint16_t, large enough
+ * to hold the number of entries in the table
+ * \param home The function that returns the home slot of an entry
+ */
+#define ADDR_HASH(name, size, slot_type, home)                          \
+  static slot_type name##_slots[size];                                  \
+  static const struct addr_hash name =                                  \
+    { name##_slots, sizeof(slot_type), (size) - 1, home }
+
+/**
+ * \brief Add bytes to an FNV-1a hash
+ * \param hash The hash of the previous bytes, or ADDR_HASH_FNV1A_INIT
+ * \param data The bytes
+ * \param len The number of bytes
+ * \return The hash of the previous bytes followed by these
+ */
+static inline uint32_t
+addr_hash_fnv1a(uint32_t hash, const void *data, unsigned len)
+{
+  const uint8_t *p = data;
+
+  while(len-- > 0) {
+    hash = (hash ^ *p++) * 16777619UL;
+  }
+  return hash;
+}
+
+/**
+ * \brief Fold a hash to a slot of an index
+ * \param hash The hash
+ * \param mask The number of slots of the index minus one
+ * \return The slot
+ */
+static inline unsigned
+addr_hash_fold(uint32_t hash, unsigned mask)
+{
+  return (hash ^ (hash >> 16)) & mask;
+}
+
+/**
+ * \brief Get the entry in a slot
+ * \param h The index
+ * \param slot The slot
+ * \return The position of the entry in its table plus one, or zero if
+ * the slot is empty
+ */
+static inline unsigned
+addr_hash_get(const struct addr_hash *h, unsigned slot)
+{
+  return h->slot_size == 1 ? ((uint8_t *)h->slots)[slot]
+                           : ((uint16_t *)h->slots)[slot];
+}
+
+/**
+ * \brief Get the slot after a slot in a probe sequence
+ * \param h The index
+ * \param slot The slot
+ * \return The next slot
+ */
+static inline unsigned
+addr_hash_next(const struct addr_hash *h, unsigned slot)
+{
+  return (slot + 1) & h->mask;
+}
+
+/**
+ * \brief Remove all entries from an index
+ * \param h The index
+ */
+void addr_hash_clear(const struct addr_hash *h);
+
+/**
+ * \brief Add an entry to an index
+ * \param h The index
+ * \param home The home slot of the address of the entry
+ * \param entry The position of the entry in its table plus one
+ */
+void addr_hash_insert(const struct addr_hash *h, unsigned home,
+                      unsigned entry);
+
+/**
+ * \brief Remove an entry from an index
+ * \param h The index
+ * \param home The home slot of the address of the entry
+ * \param entry The position of the entry in its table plus one
+ * \retval 1 The entry was removed
+ * \retval 0 The entry was not in the index
+ */
+int addr_hash_remove(const struct addr_hash *h, unsigned home,
+                     unsigned entry);
+
+#endif /* ADDR_HASH_H_ */
+
+/** @} */
+/** @} */
@@ -64,85 +64,75 @@ set_iv(uint8_t *iv,
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
+/* Feeds the additional authenticated data into the CBC-MAC x */
 static void
-ctr_step(const uint8_t *nonce,
-    uint16_t pos,
-    uint8_t *m_and_result,
-    uint16_t m_len,
-    uint16_t counter)
+mic_a(uint8_t *x, const uint8_t *a, uint16_t a_len)
 {
-  uint8_t a[AES_128_BLOCK_SIZE];
+  uint32_t pos; /* 32-bits as can need to exceed a_len to reach end of loop */
   uint8_t i;
 
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  AES_128.encrypt(a);
-
-  for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
+  x[0] = x[0] ^ (a_len >> 8);
+  x[1] = x[1] ^ a_len;
+  for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
+    x[i] ^= a[i - 2];
   }
-}
-/*---------------------------------------------------------------------------*/
-static void
-mic(const uint8_t *nonce,
-    const uint8_t *m, uint16_t m_len,
-    const uint8_t *a, uint16_t a_len,
-    uint8_t *result,
-    uint8_t mic_len)
-{
-  uint8_t x[AES_128_BLOCK_SIZE];
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint8_t i;
 
-  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
   AES_128.encrypt(x);
 
-  if(a_len) {
-    x[0] = x[0] ^ (a_len >> 8);
-    x[1] = x[1] ^ a_len;
-    for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-      x[i] ^= a[i - 2];
+  pos = 14;
+  while(pos < a_len) {
+    for(i = 0; (pos + i < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
+      x[i] ^= a[pos + i];
     }
-
+    pos += AES_128_BLOCK_SIZE;
     AES_128.encrypt(x);
-
-    pos = 14;
-    while(pos < a_len) {
-      for(i = 0; (pos + i < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= a[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
   }
-
-  if(m_len) {
-    pos = 0;
-    while(pos < m_len) {
-      for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= m[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
-  }
-
-  ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0);
-
-  memcpy(result, x, mic_len);
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Authenticates and encrypts (or decrypts) m in a single pass. Each block
+ * of m goes through the CBC-MAC x and is XORed with its CTR keystream
+ * block k. As these two encryptions are independent, they are handed to
+ * the AES driver in pairs: when encrypting, the CBC-MAC of a plaintext
+ * block along with its own keystream block; when decrypting, the CBC-MAC
+ * of the previous (decrypted) block along with the current keystream block.
+ */
 static void
-ctr(const uint8_t *nonce, uint8_t *m, uint16_t m_len)
+mic_and_ctr(const uint8_t *nonce, uint8_t *x, uint8_t *m, uint16_t m_len,
+    int forward)
 {
+  uint8_t k[AES_128_BLOCK_SIZE];
   uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
   uint16_t counter;
+  uint8_t i;
+  uint8_t n;
 
-  pos = 0;
   counter = 1;
-  while(pos < m_len) {
-    ctr_step(nonce, pos, m, m_len, counter++);
-    pos += AES_128_BLOCK_SIZE;
+  for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+    n = MIN(m_len - pos, AES_128_BLOCK_SIZE);
+    set_iv(k, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+    if(forward) {
+      for(i = 0; i < n; i++) {
+        x[i] ^= m[pos + i];
+      }
+      aes_128_encrypt_pair(x, k);
+      for(i = 0; i < n; i++) {
+        m[pos + i] ^= k[i];
+      }
+    } else {
+      if(pos == 0) {
+        AES_128.encrypt(k);
+      } else {
+        aes_128_encrypt_pair(x, k);
+      }
+      for(i = 0; i < n; i++) {
+        m[pos + i] ^= k[i];
+        x[i] ^= m[pos + i];
+      }
+    }
+  }
+  if(!forward && m_len) {
+    AES_128.encrypt(x);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -159,24 +149,27 @@ aead(const uint8_t* nonce,
     uint8_t *result, uint8_t mic_len,
     int forward)
 {
+  uint8_t x[AES_128_BLOCK_SIZE];
+  uint8_t k0[AES_128_BLOCK_SIZE];
+  uint8_t i;
+
   if(a_len > MAX_A_LEN || !MIC_LEN_VALID(mic_len)) {
     return;
   }
 
-  if(!forward) {
-    /* decrypt */
-    ctr(nonce, m, m_len);
+  /* B_0 starts the CBC-MAC, A_0 gives the keystream of the MIC */
+  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
+  set_iv(k0, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  aes_128_encrypt_pair(x, k0);
+
+  if(a_len) {
+    mic_a(x, a, a_len);
   }
 
-  mic(nonce,
-    m, m_len,
-    a, a_len,
-    result,
-    mic_len);
+  mic_and_ctr(nonce, x, m, m_len, forward);
 
-  if(forward) {
-    /* encrypt */
-    ctr(nonce, m, m_len);
+  for(i = 0; i < mic_len; i++) {
+    result[i] = x[i] ^ k0[i];
   }
 }
 /*---------------------------------------------------------------------------*/
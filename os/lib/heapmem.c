@@ -106,6 +106,26 @@
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
+/*
+ * The HEAPMEM_CONF_SIZE_CLASSES parameter determines whether free chunks
+ * are kept in segregated free lists, one per size class (non-zero
+ * value), or in a single free list (zero value).
+ *
+ * With size classes, each of the SMALL_CLASSES smallest classes holds
+ * chunks of a single size, so small allocations are served in constant
+ * time from the head of their list. Larger classes cover power-of-two
+ * size ranges. A bitmap of non-empty classes is used to find a larger
+ * chunk to split without searching. Freed chunks are merged with the
+ * free chunks that follow them, and a full defragmentation pass over
+ * the heap is made only when an allocation cannot be satisfied in any
+ * other way.
+ */
+#ifdef HEAPMEM_CONF_SIZE_CLASSES
+#define HEAPMEM_SIZE_CLASSES HEAPMEM_CONF_SIZE_CLASSES
+#else
+#define HEAPMEM_SIZE_CLASSES 0
+#endif /* HEAPMEM_CONF_SIZE_CLASSES */
+
 /* Macros for chunk iteration. */
 #define NEXT_CHUNK(chunk)						\
   ((chunk_t *)((char *)(chunk) + sizeof(chunk_t) + (chunk)->size))
@@ -149,8 +169,111 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
+
+#if HEAPMEM_SIZE_CLASSES
+#define SMALL_CLASSES 16
+#define LARGE_CLASSES 16
+#define CLASS_COUNT   (SMALL_CLASSES + LARGE_CLASSES)
+#define SMALL_MAX     (SMALL_CLASSES * HEAPMEM_ALIGNMENT)
+
+static chunk_t *free_lists[CLASS_COUNT];
+/* Bit n is set if free_lists[n] is not empty. */
+static uint32_t nonempty_classes;
+static unsigned long class_allocations[CLASS_COUNT];
+static unsigned long class_failures[CLASS_COUNT];
+
+#define FREE_LIST(chunk) free_lists[size_class((chunk)->size)]
+#else
 static chunk_t *free_list;
 
+#define FREE_LIST(chunk) free_list
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+#if HEAPMEM_SIZE_CLASSES
+/*
+ * size_class: Get the class of a chunk size. Small class n holds chunks
+ * of (n + 1) * HEAPMEM_ALIGNMENT bytes. Large class n holds chunks in
+ * the range (SMALL_MAX << n, SMALL_MAX << (n + 1)], and the last class
+ * also holds all chunks larger than that.
+ */
+static unsigned
+size_class(size_t size)
+{
+  unsigned cls;
+
+  if(size <= SMALL_MAX) {
+    return size == 0 ? 0 : (size - 1) / HEAPMEM_ALIGNMENT;
+  }
+
+  size = (size - 1) / SMALL_MAX;
+  for(cls = SMALL_CLASSES; size > 1 && cls < CLASS_COUNT - 1; cls++) {
+    size >>= 1;
+  }
+  return cls;
+}
+
+/* lowest_class: Get the lowest class set in a non-zero class bitmap. */
+static unsigned
+lowest_class(uint32_t classes)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(classes);
+#else
+  unsigned cls;
+
+  for(cls = 0; !(classes & 1); cls++) {
+    classes >>= 1;
+  }
+  return cls;
+#endif
+}
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+/* free_list_insert: Put a chunk first on the free list for its size. */
+static void
+free_list_insert(chunk_t * const chunk)
+{
+  chunk_t **head = &FREE_LIST(chunk);
+
+  chunk->prev = NULL;
+  chunk->next = *head;
+  if(*head != NULL) {
+    (*head)->prev = chunk;
+  }
+  *head = chunk;
+
+#if HEAPMEM_SIZE_CLASSES
+  nonempty_classes |= (uint32_t)1 << size_class(chunk->size);
+#endif
+}
+
+/* free_list_remove: Remove a chunk from the free list for its size. */
+static void
+free_list_remove(chunk_t * const chunk)
+{
+  chunk_t **head = &FREE_LIST(chunk);
+
+  if(chunk == *head) {
+    *head = chunk->next;
+    if(*head != NULL) {
+      (*head)->prev = NULL;
+    }
+#if HEAPMEM_SIZE_CLASSES
+    else {
+      nonempty_classes &= ~((uint32_t)1 << size_class(chunk->size));
+    }
+#endif
+  } else {
+    chunk->prev->next = chunk->next;
+  }
+
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk->prev;
+  }
+}
+
+static void coalesce_chunks(chunk_t *chunk);
+
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
 static void *
@@ -174,17 +297,18 @@ free_chunk(chunk_t * const chunk)
 {
   chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
 
+#if HEAPMEM_SIZE_CLASSES
+  /* Merge with the free chunks that follow, so that the chunk goes
+     into the class of its final size. */
+  coalesce_chunks(chunk);
+#endif
+
   if(IS_LAST_CHUNK(chunk)) {
     /* Release the chunk back into the wilderness. */
     heap_usage -= sizeof(chunk_t) + chunk->size;
   } else {
     /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
-    }
-    free_list = chunk;
+    free_list_insert(chunk);
   }
 }
 
@@ -195,18 +319,7 @@ allocate_chunk(chunk_t * const chunk)
 {
   chunk->flags |= CHUNK_FLAG_ALLOCATED;
 
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
-    }
-  } else {
-    chunk->prev->next = chunk->next;
-  }
-
-  if(chunk->next != NULL) {
-    chunk->next->prev = chunk->prev;
-  }
+  free_list_remove(chunk);
 }
 
 /*
@@ -247,6 +360,74 @@ coalesce_chunks(chunk_t *chunk)
   }
 }
 
+/* coalesce_free_chunk: Coalesce a chunk on the free list with the
+   free chunks that follow it, keeping it on the right free list. */
+static void
+coalesce_free_chunk(chunk_t *chunk)
+{
+#if HEAPMEM_SIZE_CLASSES
+  /* The class of the chunk may change with its size. */
+  free_list_remove(chunk);
+  coalesce_chunks(chunk);
+  free_list_insert(chunk);
+#else
+  coalesce_chunks(chunk);
+#endif
+}
+
+#if HEAPMEM_SIZE_CLASSES
+/* defrag_chunks: Coalesce all adjacent free chunks in the heap. This
+   is only done when an allocation would fail otherwise. */
+static void
+defrag_chunks(void)
+{
+  chunk_t *chunk;
+
+  for(chunk = first_chunk;
+      (char *)chunk < &heap_base[heap_usage];
+      chunk = NEXT_CHUNK(chunk)) {
+    if(CHUNK_FREE(chunk)) {
+      coalesce_free_chunk(chunk);
+    }
+  }
+}
+
+/* find_free_chunk: Find a free chunk that is large enough for an
+   allocation request. */
+static chunk_t *
+find_free_chunk(const size_t size)
+{
+  int i;
+  unsigned cls;
+  uint32_t larger;
+  chunk_t *chunk;
+
+  /* Chunks in a small class all have the same size, so the first
+     chunk is a perfect fit. In a large class, search a bounded number
+     of chunks. */
+  cls = size_class(size);
+  i = CHUNK_SEARCH_MAX;
+  for(chunk = free_lists[cls]; chunk != NULL; chunk = chunk->next) {
+    if(i-- == 0) {
+      break;
+    }
+    if(size <= chunk->size) {
+      return chunk;
+    }
+  }
+
+  /* Any chunk in a larger class is large enough. Take one from the
+     smallest such class to avoid fragmenting large chunks. */
+  if(cls + 1 < CLASS_COUNT) {
+    larger = nonempty_classes & ~(((uint32_t)1 << (cls + 1)) - 1);
+    if(larger != 0) {
+      return free_lists[lowest_class(larger)];
+    }
+  }
+
+  return NULL;
+}
+#else
 /* defrag_chunks: Scan the free list for chunks that can be coalesced,
    and stop within a bounded time. */
 static void
@@ -264,12 +445,18 @@ defrag_chunks(void)
     coalesce_chunks(chunk);
   }
 }
+#endif /* HEAPMEM_SIZE_CLASSES */
 
 /* get_free_chunk: Search the free list for the most suitable chunk, as
    determined by its size, to satisfy an allocation request. */
 static chunk_t *
 get_free_chunk(const size_t size)
 {
+#if HEAPMEM_SIZE_CLASSES
+  chunk_t *best;
+
+  best = find_free_chunk(size);
+#else
   int i;
   chunk_t *chunk, *best;
 
@@ -298,6 +485,7 @@ get_free_chunk(const size_t size)
       }
     }
   }
+#endif /* HEAPMEM_SIZE_CLASSES */
 
   if(best != NULL) {
     /* We found a chunk for the allocation. Split it if necessary. */
@@ -320,7 +508,8 @@ get_free_chunk(const size_t size)
  * free list will be examined.
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
- * space, and thereby create a new chunk available for use.
+ * space, and thereby create a new chunk available for use. With size
+ * classes, it will then also try to defragment the whole heap.
  */
 void *
 #if HEAPMEM_DEBUG
@@ -332,16 +521,37 @@ heapmem_alloc(size_t size)
   chunk_t *chunk;
 
   size = ALIGN(size);
+#if HEAPMEM_SIZE_CLASSES
+  /* Chunks of the smallest class must all have the same size. */
+  if(size == 0) {
+    size = HEAPMEM_ALIGNMENT;
+  }
+#endif
 
   chunk = get_free_chunk(size);
   if(chunk == NULL) {
     chunk = extend_space(sizeof(chunk_t) + size);
+    if(chunk != NULL) {
+      chunk->size = size;
+    }
+#if HEAPMEM_SIZE_CLASSES
+    else {
+      defrag_chunks();
+      chunk = get_free_chunk(size);
+    }
+#endif
     if(chunk == NULL) {
+#if HEAPMEM_SIZE_CLASSES
+      class_failures[size_class(size)]++;
+#endif
       return NULL;
     }
-    chunk->size = size;
   }
 
+#if HEAPMEM_SIZE_CLASSES
+  class_allocations[size_class(size)]++;
+#endif
+
   chunk->flags = CHUNK_FLAG_ALLOCATED;
 
 #if HEAPMEM_DEBUG
@@ -499,12 +709,61 @@ heapmem_stats(heapmem_stats_t *stats)
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
     } else {
-      coalesce_chunks(chunk);
+      coalesce_free_chunk(chunk);
       stats->available += chunk->size;
+      stats->free_chunks++;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
     stats->overhead += sizeof(chunk_t);
   }
   stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+  if(HEAPMEM_ARENA_SIZE - heap_usage > stats->largest_free) {
+    stats->largest_free = HEAPMEM_ARENA_SIZE - heap_usage;
+  }
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
 }
+
+/* heapmem_class_count: Get the number of size classes. */
+unsigned
+heapmem_class_count(void)
+{
+#if HEAPMEM_SIZE_CLASSES
+  return CLASS_COUNT;
+#else
+  return 0;
+#endif
+}
+
+/* heapmem_class_stats: Obtain statistics for a single size class. */
+int
+heapmem_class_stats(unsigned cls, heapmem_class_stats_t *stats)
+{
+#if HEAPMEM_SIZE_CLASSES
+  chunk_t *chunk;
+
+  if(cls >= CLASS_COUNT) {
+    return 0;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  if(cls < SMALL_CLASSES) {
+    stats->max_size = (cls + 1) * HEAPMEM_ALIGNMENT;
+  } else if(cls < CLASS_COUNT - 1) {
+    stats->max_size = (size_t)SMALL_MAX << (cls - SMALL_CLASSES + 1);
+  } else {
+    stats->max_size = HEAPMEM_ARENA_SIZE;
+  }
+  for(chunk = free_lists[cls]; chunk != NULL; chunk = chunk->next) {
+    stats->free_chunks++;
+    stats->free_bytes += chunk->size;
+  }
+  stats->allocations = class_allocations[cls];
+  stats->failures = class_failures[cls];
+  return 1;
+#else
+  return 0;
+#endif
+}
@@ -45,7 +45,10 @@
  * Each allocated memory object is referred to as a "chunk". The
  * allocator manages free chunks in a double-linked list. While this
  * adds some memory overhead compared to a single-linked list, it
- * improves the performance of list management.
+ * improves the performance of list management. If
+ * HEAPMEM_CONF_SIZE_CLASSES is set, free chunks are instead kept in
+ * one list per size class, which makes the allocation of small
+ * objects a constant-time operation.
  *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
@@ -82,8 +85,23 @@ typedef struct heapmem_stats {
   size_t available;
   size_t footprint;
   size_t chunks;
+  /* Number of free chunks inside the footprint. */
+  size_t free_chunks;
+  /* Largest free chunk or unused space at the end of the heap. The ratio
+     of this to the available memory indicates how fragmented the heap is. */
+  size_t largest_free;
 } heapmem_stats_t;
 
+typedef struct heapmem_class_stats {
+  /* Largest chunk size that belongs to the class. */
+  size_t max_size;
+  size_t free_chunks;
+  size_t free_bytes;
+  /* Allocation requests of a size in this class. */
+  unsigned long allocations;
+  unsigned long failures;
+} heapmem_class_stats_t;
+
 #if HEAPMEM_DEBUG
 
 #define heapmem_alloc(size) heapmem_alloc_debug((size), __FILE__, __LINE__)
@@ -161,6 +179,29 @@ void heapmem_free(void *ptr);
 
 void heapmem_stats(heapmem_stats_t *stats);
 
+/**
+ * \brief       Obtain the number of size classes.
+ * \return      The number of size classes, or zero if the allocator
+ *              is not configured with HEAPMEM_CONF_SIZE_CLASSES.
+ */
+
+unsigned heapmem_class_count(void);
+
+/**
+ * \brief       Obtain statistics for a size class.
+ * \param cls   The size class, from zero to heapmem_class_count() - 1.
+ * \param stats A pointer to an object of type heapmem_class_stats_t,
+ *              which will be filled when calling this function.
+ * \return      Non-zero if the statistics were obtained, zero if the
+ *              size class does not exist.
+ *
+ * The counters of a size class show how many allocation requests of
+ * a size in the class were made, how many of them failed, and how many
+ * free chunks of the class are waiting to be reused.
+ */
+
+int heapmem_class_stats(unsigned cls, heapmem_class_stats_t *stats);
+
 #endif /* !HEAPMEM_H */
 
 /** @} */
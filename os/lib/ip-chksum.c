@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \addtogroup ip-chksum
+ * @{ */
+
+/**
+ * \file
+ *         Implementation of the Internet checksum backends
+ */
+
+#include "lib/ip-chksum.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif /* __ARM_NEON */
+
+/*---------------------------------------------------------------------------*/
+/*
+ * The accelerated backends sum the data in the host's byte order and
+ * swap the result once at the end, which gives the same result as
+ * summing big-endian words (RFC 1071, section 2(B)). These two helpers
+ * convert a host-order value to its in-memory representation as a
+ * big-endian word, and back.
+ */
+static inline uint16_t
+to_native(uint16_t value)
+{
+  uint8_t bytes[2] = { value >> 8, value & 0xff };
+  uint16_t word;
+
+  memcpy(&word, bytes, sizeof(word));
+  return word;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint16_t
+from_native(uint16_t word)
+{
+  uint8_t bytes[2];
+
+  memcpy(bytes, &word, sizeof(word));
+  return (bytes[0] << 8) | bytes[1];
+}
+/*---------------------------------------------------------------------------*/
+/* Sums len bytes into a 64-bit accumulator. A 16-bit length cannot
+   overflow the accumulator, so the carries are all folded later. */
+static inline uint64_t
+add_words(uint64_t acc, const uint8_t *data, uint16_t len)
+{
+  uint32_t w0, w1, w2, w3;
+  uint16_t w;
+
+  while(len >= 16) {
+    memcpy(&w0, data, sizeof(w0));
+    memcpy(&w1, data + 4, sizeof(w1));
+    memcpy(&w2, data + 8, sizeof(w2));
+    memcpy(&w3, data + 12, sizeof(w3));
+    acc += (uint64_t)w0 + w1 + w2 + w3;
+    data += 16;
+    len -= 16;
+  }
+
+  while(len >= 4) {
+    memcpy(&w0, data, sizeof(w0));
+    acc += w0;
+    data += 4;
+    len -= 4;
+  }
+
+  if(len >= 2) {
+    memcpy(&w, data, sizeof(w));
+    acc += w;
+    data += 2;
+    len -= 2;
+  }
+
+  if(len > 0) {
+    /* Pad the last byte with zero, at the same position in the word
+       that it would have in a big-endian word. */
+    uint8_t last[2] = { data[0], 0 };
+    memcpy(&w, last, sizeof(w));
+    acc += w;
+  }
+
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint16_t
+fold(uint64_t acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return from_native((uint16_t)acc);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+ip_chksum_reference(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {   /* At least two more bytes */
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+ip_chksum_word(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  return fold(add_words(to_native(sum), data, len));
+}
+/*---------------------------------------------------------------------------*/
+#if defined(__SSE2__)
+uint16_t
+ip_chksum_sse2(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  uint32_t lanes[4];
+
+  /* Each 32-bit lane receives two 16-bit words per 16 bytes of data,
+     which it can hold for any 16-bit length. */
+  while(len >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)data);
+    acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+    acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+    data += 16;
+    len -= 16;
+  }
+
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return fold(add_words((uint64_t)to_native(sum) +
+                        lanes[0] + lanes[1] + lanes[2] + lanes[3],
+                        data, len));
+}
+#endif /* __SSE2__ */
+/*---------------------------------------------------------------------------*/
+#if defined(__ARM_NEON)
+uint16_t
+ip_chksum_neon(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint32x4_t acc = vdupq_n_u32(0);
+  uint32_t lanes[4];
+
+  /* Pairwise add the 16-bit words into the 32-bit lanes. As for SSE2,
+     a lane cannot overflow for any 16-bit length. */
+  while(len >= 16) {
+    acc = vpadalq_u16(acc, vreinterpretq_u16_u8(vld1q_u8(data)));
+    data += 16;
+    len -= 16;
+  }
+
+  vst1q_u32(lanes, acc);
+  return fold(add_words((uint64_t)to_native(sum) +
+                        lanes[0] + lanes[1] + lanes[2] + lanes[3],
+                        data, len));
+}
+#endif /* __ARM_NEON */
+/*---------------------------------------------------------------------------*/
+uint16_t
+ip_chksum_adjust(uint16_t chksum, uint16_t old_sum, uint16_t new_sum)
+{
+  uint32_t sum;
+
+  sum = (uint16_t)~chksum + (uint16_t)~old_sum + new_sum;
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum = (sum >> 16) + (sum & 0xffff);
+  return ~sum;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \addtogroup lib
+ * @{ */
+
+/**
+ * \defgroup ip-chksum Internet checksum
+ *
+ * The 16-bit one's complement checksum used by IPv4, ICMP, UDP and
+ * TCP (RFC 1071). Several interchangeable backends are provided: a
+ * byte-wise reference implementation, a portable word-at-a-time
+ * implementation that accumulates 32-bit loads in a 64-bit register
+ * and folds the carries once at the end, and SSE2 and NEON variants
+ * for hosts that have them. All backends return the same result, so
+ * the fastest one available is selected by IP_CHKSUM at compile time.
+ *
+ * The module also implements the incremental checksum update of
+ * RFC 1624, for rewriting a few header fields without summing the
+ * whole packet again.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the Internet checksum backends
+ */
+
+#ifndef IP_CHKSUM_H_
+#define IP_CHKSUM_H_
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/*
+ * The backend used by IP_CHKSUM(). Can be set to any of the functions
+ * below, or to a platform-specific function with the same signature.
+ */
+#ifdef IP_CHKSUM_CONF
+#define IP_CHKSUM IP_CHKSUM_CONF
+#elif defined(__SSE2__)
+#define IP_CHKSUM ip_chksum_sse2
+#elif defined(__ARM_NEON)
+#define IP_CHKSUM ip_chksum_neon
+#elif UINTPTR_MAX > 0xffff
+#define IP_CHKSUM ip_chksum_word
+#else
+#define IP_CHKSUM ip_chksum_reference
+#endif
+
+/**
+ * \brief      Sum a data area into a partial Internet checksum
+ * \param sum  The partial sum to continue from (or zero)
+ * \param data Pointer to the data
+ * \param len  The length of the data, in bytes
+ * \return     The partial sum, in host byte order
+ *
+ *             The data is summed as a sequence of 16-bit big-endian
+ *             words, an odd final byte being padded with zero. The
+ *             result is not complemented, so that partial sums over
+ *             several areas (e.g. a pseudo-header and a payload) can
+ *             be chained. Only the last area may have an odd length.
+ *
+ *             This is the reference implementation, which the
+ *             other backends are tested against.
+ */
+uint16_t ip_chksum_reference(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief      Word-at-a-time variant of ip_chksum_reference()
+ *
+ *             Sums 32-bit words in a 64-bit accumulator and folds the
+ *             carries back only once, after the loop. Makes no
+ *             assumption on the alignment of \a data.
+ */
+uint16_t ip_chksum_word(uint16_t sum, const uint8_t *data, uint16_t len);
+
+#if defined(__SSE2__) || defined(DOXYGEN)
+/**
+ * \brief      SSE2 variant of ip_chksum_reference()
+ */
+uint16_t ip_chksum_sse2(uint16_t sum, const uint8_t *data, uint16_t len);
+#endif /* __SSE2__ */
+
+#if defined(__ARM_NEON) || defined(DOXYGEN)
+/**
+ * \brief      NEON variant of ip_chksum_reference()
+ */
+uint16_t ip_chksum_neon(uint16_t sum, const uint8_t *data, uint16_t len);
+#endif /* __ARM_NEON */
+
+/**
+ * \brief          Update a checksum after a change in the summed data
+ * \param chksum   The checksum, as found in the packet, in host byte order
+ * \param old_sum  Partial sum of the data before the change
+ * \param new_sum  Partial sum of the same data after the change
+ * \return         The updated checksum, in host byte order
+ *
+ *             Implements HC' = ~(~HC + ~m + m') from RFC 1624, where
+ *             m and m' are the partial sums, as returned by
+ *             IP_CHKSUM(), of the old and new contents of the fields
+ *             that changed. The fields must start at an even offset
+ *             from the beginning of the checksummed data.
+ *
+ *             An incorrect checksum stays incorrect after the update,
+ *             so the receiver still detects corrupted packets.
+ */
+uint16_t ip_chksum_adjust(uint16_t chksum, uint16_t old_sum, uint16_t new_sum);
+
+#endif /* IP_CHKSUM_H_ */
+
+/** @} */
+/** @} */
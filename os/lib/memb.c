@@ -47,25 +47,73 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/*---------------------------------------------------------------------------*/
+#define BITS_PER_WORD 32
+
+#if MEMB_STATS
+static struct memb *memb_head;
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
+static unsigned
+lowest_bit(uint32_t word)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(word);
+#else
+  unsigned bit;
+
+  for(bit = 0; !(word & 1); bit++) {
+    word >>= 1;
+  }
+  return bit;
+#endif
+}
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
-  memset(m->used, 0, m->num);
+#if MEMB_STATS
+  struct memb *n;
+#endif /* MEMB_STATS */
+
+  memset(m->used, 0, MEMB_USED_WORDS(m->num) * sizeof(uint32_t));
   memset(m->mem, 0, m->size * m->num);
+  m->count = 0;
+  m->max_count = 0;
+
+#if MEMB_STATS
+  for(n = memb_head; n != NULL; n = n->next) {
+    if(n == m) {
+      return;
+    }
+  }
+  m->next = memb_head;
+  memb_head = m;
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
-  int i;
+  unsigned i;
+  unsigned block;
+  uint32_t free_blocks;
 
-  for(i = 0; i < m->num; ++i) {
-    if(m->used[i] == false) {
-      /* If this block was unused, we set the used flag on
-	 and return a pointer to the memory block. */
-      m->used[i] = true;
-      return (void *)((char *)m->mem + (i * m->size));
+  for(i = 0; i < MEMB_USED_WORDS(m->num); ++i) {
+    free_blocks = ~m->used[i];
+    if(free_blocks != 0) {
+      /* Take the lowest free block in this word. The bits past the
+         last block in the last word are always clear. */
+      block = i * BITS_PER_WORD + lowest_bit(free_blocks);
+      if(block >= m->num) {
+        break;
+      }
+      /* Set the used flag and return a pointer to the memory block. */
+      m->used[i] |= (uint32_t)1 << (block % BITS_PER_WORD);
+      if(++m->count > m->max_count) {
+        m->max_count = m->count;
+      }
+      return (void *)((char *)m->mem + (block * m->size));
     }
   }
 
@@ -77,24 +125,29 @@ memb_alloc(struct memb *m)
 int
 memb_free(struct memb *m, void *ptr)
 {
-  int i;
-  char *ptr2;
+  size_t offset;
+  unsigned block;
+  uint32_t mask;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  /* The pointer must point to the beginning of one of the blocks. */
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
   }
-  return -1;
+
+  /* Check the allocation status to detect the double-free error and
+     free the block. */
+  block = offset / m->size;
+  mask = (uint32_t)1 << (block % BITS_PER_WORD);
+  if(!(m->used[block / BITS_PER_WORD] & mask)) {
+    return -1;
+  }
+  m->used[block / BITS_PER_WORD] &= ~mask;
+  m->count--;
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -107,15 +160,21 @@ memb_inmemb(struct memb *m, void *ptr)
 int
 memb_numfree(struct memb *m)
 {
-  int i;
-  int num_free = 0;
-
-  for(i = 0; i < m->num; ++i) {
-    if(m->used[i] == false) {
-      ++num_free;
-    }
-  }
-
-  return num_free;
+  return m->num - m->count;
 }
+/*---------------------------------------------------------------------------*/
+int
+memb_high_water(struct memb *m)
+{
+  return m->max_count;
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+struct memb *
+memb_stats_head(void)
+{
+  return memb_head;
+}
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
 /** @} */
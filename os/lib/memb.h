@@ -46,7 +46,8 @@
  * size. A set of memory blocks is statically declared with the
  * MEMB() macro. Memory blocks are allocated from the declared
  * memory by the memb_alloc() function, and are deallocated with the
- * memb_free() function.
+ * memb_free() function. The allocation state of the blocks is kept in
+ * a bitmap, so that a free block is found one word at a time.
  *
  * @{
  */
@@ -64,8 +65,28 @@
 #define MEMB_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "sys/cc.h"
 
+/**
+ * \brief Keep a list of all initialized memory blocks with their
+ *        names, so that their usage can be inspected at runtime.
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else
+#define MEMB_STATS 0
+#endif /* MEMB_CONF_STATS */
+
+/* Number of words in the allocation bitmap of a memory block. */
+#define MEMB_USED_WORDS(num) (((num) + 31) / 32)
+
+#if MEMB_STATS
+#define MEMB_STATS_INIT(name) , #name, NULL
+#else
+#define MEMB_STATS_INIT(name)
+#endif /* MEMB_STATS */
+
 /**
  * Declare a memory block.
  *
@@ -88,22 +109,36 @@ MEMB(connections, struct connection, 16);
  *
  */
 #define MEMB(name, structure, num) \
-        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static uint32_t CC_CONCAT(name,_memb_used)[MEMB_USED_WORDS(num)]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          0, 0 MEMB_STATS_INIT(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
-  bool *used;
+  /* Bitmap of allocated blocks, one bit per block. */
+  uint32_t *used;
   void *mem;
+  /* Number of allocated blocks. */
+  unsigned short count;
+  /* Highest number of blocks that have been allocated at once. */
+  unsigned short max_count;
+#if MEMB_STATS
+  const char *name;
+  struct memb *next;
+#endif /* MEMB_STATS */
 };
 
 /**
  * Initialize a memory block that was declared with MEMB().
  *
+ * This also resets the high-water mark of the memory block and, if
+ * MEMB_CONF_STATS is set, adds it to the list of memory blocks shown
+ * by the shell.
+ *
  * \param m A set of memory blocks previously declared with MEMB().
  */
 void  memb_init(struct memb *m);
@@ -149,6 +184,26 @@ int memb_inmemb(struct memb *m, void *ptr);
  */
 int  memb_numfree(struct memb *m);
 
+/**
+ * Get the high-water mark of a memory block
+ *
+ * \param m m A set of memory blocks previously declared with MEMB().
+ *
+ * \return the highest number of memory blocks that have been allocated
+ * at the same time since the memory block was initialized
+ */
+int  memb_high_water(struct memb *m);
+
+#if MEMB_STATS
+/**
+ * Get the first memory block in the list of initialized memory blocks
+ *
+ * \return the memory block initialized first, or NULL if none. The
+ * following ones are linked through the next field.
+ */
+struct memb *memb_stats_head(void);
+#endif /* MEMB_STATS */
+
 /** @} */
 /** @} */
 
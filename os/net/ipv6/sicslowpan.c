@@ -73,6 +73,7 @@
 #include "net/netstack.h"
 #include "net/packetbuf.h"
 #include "net/queuebuf.h"
+#include "lib/addr-hash.h"
 
 #include "net/routing/routing.h"
 
@@ -200,13 +201,15 @@ static int last_rssi;
 /* Support for reassembling multiple packets                         */
 /* ----------------------------------------------------------------- */
 
+static struct sicslowpan_reass_stats reass_stats;
+
 #if SICSLOWPAN_CONF_FRAG
 static uint16_t my_tag;
 
-/** The total length of the IPv6 packet in the sicslowpan_buf. */
-
 /* This needs to be defined in NBR / Nodes depending on available RAM   */
 /*   and expected reassembly requirements                               */
+/* FRAGMENT_BUFFERS is the number of non-first fragments that can be
+ * buffered. It only sets the default size of the reassembly buffer. */
 #ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
 #define SICSLOWPAN_FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
 #else
@@ -214,10 +217,7 @@ static uint16_t my_tag;
 #endif
 
 /* REASS_CONTEXTS corresponds to the number of simultaneous
- * reassemblies that can be made. NOTE: the first buffer for each
- * reassembly is stored in the context since it can be larger than the
- * rest of the fragments due to header compression.
- **/
+ * reassemblies that can be made. */
 #ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
 #define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
 #else
@@ -240,216 +240,438 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* The reassembly buffer is shared by all contexts. Each packet being
+ * reassembled gets a contiguous region of its full size, where every
+ * fragment is written directly at its offset. The default size holds
+ * as much data as the per-fragment buffers used to. */
+#ifdef SICSLOWPAN_CONF_REASS_BUF_SIZE
+#define SICSLOWPAN_REASS_BUF_SIZE SICSLOWPAN_CONF_REASS_BUF_SIZE
+#else
+#define SICSLOWPAN_REASS_BUF_SIZE \
+  (SICSLOWPAN_FRAGMENT_BUFFERS * SICSLOWPAN_FRAGMENT_SIZE + \
+   SICSLOWPAN_REASS_CONTEXTS * SICSLOWPAN_FIRST_FRAGMENT_SIZE)
+#endif
+
+/* Find reassembly contexts through a hash index of the sender and tag,
+ * instead of a scan of all contexts. Useful with many contexts. */
+#ifdef SICSLOWPAN_CONF_REASS_HASH_INDEX
+#define SICSLOWPAN_REASS_HASH_INDEX SICSLOWPAN_CONF_REASS_HASH_INDEX
+#else
+#define SICSLOWPAN_REASS_HASH_INDEX 0
+#endif
+
+/* Forward the fragments of packets that are not for us as they arrive,
+ * instead of reassembling the packets first (RFC 8930). */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARDING
+#define SICSLOWPAN_FRAG_FORWARDING SICSLOWPAN_CONF_FRAG_FORWARDING
+#else
+#define SICSLOWPAN_FRAG_FORWARDING 0
+#endif
+
+/* The number of packets that can be forwarded fragment by fragment
+ * at the same time */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARDING_ENTRIES
+#define SICSLOWPAN_FRAG_FORWARDING_ENTRIES SICSLOWPAN_CONF_FRAG_FORWARDING_ENTRIES
+#else
+#define SICSLOWPAN_FRAG_FORWARDING_ENTRIES 4
+#endif
+
+/* Fragment offsets are in units of 8 bytes. Regions in the reassembly
+ * buffer are rounded up to units too, which keeps them aligned. */
+#define REASS_UNIT 8
+#define REASS_ROUND(len) (((len) + REASS_UNIT - 1) & ~(REASS_UNIT - 1))
+#define REASS_BITMAP_SIZE ((UIP_BUFSIZE / REASS_UNIT + 8) / 8)
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
   linkaddr_t sender;
-  /** The destination address of the fragments being merged */
-  linkaddr_t receiver;
   /** When reassembling, the tag in the fragments being merged. */
   uint16_t tag;
-  /** Total length of the fragmented packet */
+  /** Total length of the fragmented packet (zero if the context is free) */
   uint16_t len;
-  /** Current length of reassembled fragments */
+  /** Number of bytes of the packet received so far */
   uint16_t reassembled_len;
+  /** Offset of the packet in the reassembly buffer */
+  uint16_t buf_offset;
   /** Reassembly %process %timer. */
   struct timer reass_timer;
-
-  /** Fragment size of first fragment */
-  uint16_t first_frag_len;
-  /** First fragment - needs a larger buffer since the size is uncompressed size
-   and we need to know total size to know when we have received last fragment. */
-  uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+  /** One bit per 8-byte unit of the packet, set when received. Used to
+      detect duplicate and overlapping fragments. */
+  uint8_t received[REASS_BITMAP_SIZE];
 };
 
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
-struct sicslowpan_frag_buf {
-  /* the index of the frag_info */
-  uint8_t index;
-  /* Fragment offset */
-  uint8_t offset;
-  /* Length of this fragment (if zero this buffer is not allocated) */
-  uint8_t len;
-  uint8_t data[SICSLOWPAN_FRAGMENT_SIZE];
-};
+static union {
+  uint32_t u32[(SICSLOWPAN_REASS_BUF_SIZE + 3) / 4];
+  uint8_t u8[SICSLOWPAN_REASS_BUF_SIZE];
+} reass_buf;
+
+#if SICSLOWPAN_REASS_HASH_INDEX
+/* Hash index over the sender and tag of the contexts. Each slot holds a
+ * context index plus one, or zero if empty. */
+#define HASH_SIZE ADDR_HASH_SIZE_AT_LEAST(2 * SICSLOWPAN_REASS_CONTEXTS)
+
+#if SICSLOWPAN_REASS_CONTEXTS > 255
+#error "SICSLOWPAN_REASS_HASH_INDEX supports up to 255 contexts"
+#endif
 
-static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
+static unsigned hash_home(unsigned entry);
+ADDR_HASH(hash_index, HASH_SIZE, uint8_t, hash_home);
+#endif /* SICSLOWPAN_REASS_HASH_INDEX */
 
 /*---------------------------------------------------------------------------*/
+#if SICSLOWPAN_REASS_HASH_INDEX
+/* Get the home slot of a sender and tag in the hash index */
+static unsigned
+hash_slot(const linkaddr_t *sender, uint16_t tag)
+{
+  uint8_t tag_bytes[2] = { tag >> 8, tag & 0xff };
+  uint32_t hash = addr_hash_fnv1a(ADDR_HASH_FNV1A_INIT, sender, LINKADDR_SIZE);
+
+  hash = addr_hash_fnv1a(hash, tag_bytes, sizeof(tag_bytes));
+  return addr_hash_fold(hash, hash_index.mask);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+hash_home(unsigned entry)
+{
+  return hash_slot(&frag_info[entry - 1].sender, frag_info[entry - 1].tag);
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_insert(int context)
+{
+  addr_hash_insert(&hash_index,
+                   hash_slot(&frag_info[context].sender, frag_info[context].tag),
+                   context + 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(int context)
+{
+  addr_hash_remove(&hash_index,
+                   hash_slot(&frag_info[context].sender, frag_info[context].tag),
+                   context + 1);
+}
+#endif /* SICSLOWPAN_REASS_HASH_INDEX */
+/*---------------------------------------------------------------------------*/
+/* Find the context of the packet with a tag from a sender */
 static int
-clear_fragments(uint8_t frag_info_index)
+find_context(const linkaddr_t *sender, uint16_t tag)
+{
+#if SICSLOWPAN_REASS_HASH_INDEX
+  unsigned slot;
+  unsigned entry;
+  struct sicslowpan_frag_info *info;
+
+  for(slot = hash_slot(sender, tag);
+      (entry = addr_hash_get(&hash_index, slot)) != 0;
+      slot = addr_hash_next(&hash_index, slot)) {
+    info = &frag_info[entry - 1];
+    if(info->tag == tag && linkaddr_cmp(&info->sender, sender)) {
+      return entry - 1;
+    }
+  }
+#else /* SICSLOWPAN_REASS_HASH_INDEX */
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len > 0 && frag_info[i].tag == tag &&
+       linkaddr_cmp(&frag_info[i].sender, sender)) {
+      return i;
+    }
+  }
+#endif /* SICSLOWPAN_REASS_HASH_INDEX */
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_context(int context)
 {
-  int i, clear_count;
-  clear_count = 0;
-  frag_info[frag_info_index].len = 0;
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
-      /* deallocate the buffer */
-      frag_buf[i].len = 0;
-      clear_count++;
+#if SICSLOWPAN_REASS_HASH_INDEX
+  hash_remove(context);
+#endif /* SICSLOWPAN_REASS_HASH_INDEX */
+  frag_info[context].len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+timeout_contexts(void)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+      LOG_WARN("reassembly: timeout - tag: %d, %d of %d bytes\n",
+               frag_info[i].tag, frag_info[i].reassembled_len,
+               frag_info[i].len);
+      reass_stats.timeouts++;
+      free_context(i);
     }
   }
-  return clear_count;
 }
 /*---------------------------------------------------------------------------*/
-static int
-timeout_fragments(int not_context)
+/* Check whether len bytes at offset in the reassembly buffer are free */
+static bool
+is_buf_free(uint16_t offset, uint16_t len)
 {
   int i;
-  int count = 0;
+
   for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].len > 0 && i != not_context &&
-       timer_expired(&frag_info[i].reass_timer)) {
-      /* This context can be freed */
-      count += clear_fragments(i);
+    if(frag_info[i].len > 0 &&
+       offset < frag_info[i].buf_offset + REASS_ROUND(frag_info[i].len) &&
+       frag_info[i].buf_offset < offset + len) {
+      return false;
     }
   }
-  return count;
+  return true;
 }
 /*---------------------------------------------------------------------------*/
+/* Find room for len bytes in the reassembly buffer: at its beginning, or
+ * right after the region of another context. */
 static int
-store_fragment(uint8_t index, uint8_t offset)
+find_buf_space(uint16_t len)
 {
   int i;
-  int len;
-
-  len = packetbuf_datalen() - packetbuf_hdr_len;
+  uint16_t offset;
 
-  if(len <= 0 || len > SICSLOWPAN_FRAGMENT_SIZE) {
-    /* Unacceptable fragment size. */
-    return -1;
+  if(is_buf_free(0, len)) {
+    return 0;
   }
-
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer,
-         and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
-      /* return the length of the stored fragment */
-      return len;
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len > 0) {
+      offset = frag_info[i].buf_offset + REASS_ROUND(frag_info[i].len);
+      if(offset + len <= SICSLOWPAN_REASS_BUF_SIZE && is_buf_free(offset, len)) {
+        return offset;
+      }
     }
   }
-  /* failed */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
-/* add a new fragment to the buffer */
-static int8_t
-add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+/* Move the regions of all contexts to the beginning of the reassembly
+ * buffer, in order, so that the free space is contiguous */
+static void
+compact_buf(void)
 {
-  int i;
-  int len;
-  int8_t found = -1;
+  int i, lowest;
+  uint16_t end = 0;
 
-  if(offset == 0) {
-    /* This is a first fragment - check if we can add this */
+  for(;;) {
+    lowest = -1;
     for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-      /* clear all fragment info with expired timer to free all fragment buffers */
-      if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
-        clear_fragments(i);
-      }
-
-      /* We use len as indication on used or not used */
-      if(found < 0 && frag_info[i].len == 0) {
-        /* We remember the first free fragment info but must continue
-           the loop to free any other expired fragment buffers. */
-        found = i;
+      if(frag_info[i].len > 0 && frag_info[i].buf_offset >= end &&
+         (lowest < 0 || frag_info[i].buf_offset < frag_info[lowest].buf_offset)) {
+        lowest = i;
       }
     }
-
-    if(found < 0) {
-      LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
-      return -1;
+    if(lowest < 0) {
+      return;
     }
+    if(frag_info[lowest].buf_offset != end) {
+      memmove(&reass_buf.u8[end], &reass_buf.u8[frag_info[lowest].buf_offset],
+              REASS_ROUND(frag_info[lowest].len));
+      frag_info[lowest].buf_offset = end;
+    }
+    end += REASS_ROUND(frag_info[lowest].len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Get the reassembly context of a fragment, creating it if this is the
+ * first fragment received for the packet, in whatever order */
+static int
+get_context(uint16_t tag, uint16_t frag_size)
+{
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+  int i, j;
+  int offset;
+  uint16_t used;
+
+  i = find_context(sender, tag);
+  if(i >= 0) {
+    if(timer_expired(&frag_info[i].reass_timer)) {
+      LOG_WARN("reassembly: timeout - tag: %d\n", tag);
+      reass_stats.timeouts++;
+      free_context(i);
+    } else if(frag_info[i].len != frag_size) {
+      /* The sender has reused the tag for another packet */
+      LOG_WARN("reassembly: size changed from %d to %d - tag: %d\n",
+               frag_info[i].len, frag_size, tag);
+      reass_stats.invalid++;
+      free_context(i);
+    } else {
+      return i;
+    }
+  }
 
-    /* Found a free fragment info to store data in */
-    frag_info[found].len = frag_size;
-    frag_info[found].tag = tag;
-    linkaddr_copy(&frag_info[found].sender,
-                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
-    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
-    /* first fragment can not be stored immediately but is moved into
-       the buffer while uncompressing */
-    return found;
+  if(frag_size < UIP_IPH_LEN || frag_size > UIP_BUFSIZE) {
+    LOG_WARN("reassembly: invalid packet size %d - tag: %d\n", frag_size, tag);
+    reass_stats.invalid++;
+    return -1;
   }
 
-  /* This is a N-fragment - should find the info */
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].tag == tag && frag_info[i].len > 0 &&
-       linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-      /* Tag and Sender match - this must be the correct info to store in */
-      found = i;
-      break;
+  /* Free the contexts of packets that will never complete */
+  timeout_contexts();
+
+  used = 0;
+  i = -1;
+  for(j = 0; j < SICSLOWPAN_REASS_CONTEXTS; j++) {
+    if(frag_info[j].len > 0) {
+      used += REASS_ROUND(frag_info[j].len);
+    } else if(i < 0) {
+      i = j;
     }
   }
 
-  if(found < 0) {
-    /* no entry found for storing the new fragment */
-    LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+  offset = -1;
+  if(i >= 0) {
+    offset = find_buf_space(REASS_ROUND(frag_size));
+    if(offset < 0 &&
+       REASS_ROUND(frag_size) <= SICSLOWPAN_REASS_BUF_SIZE - used) {
+      compact_buf();
+      offset = used;
+    }
+  }
+  if(offset < 0) {
+    LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+    reass_stats.no_context++;
     return -1;
   }
 
-  /* i is the index of the reassembly context */
-  len = store_fragment(i, offset);
-  if(len < 0 && timeout_fragments(i) > 0) {
-    len = store_fragment(i, offset);
+  linkaddr_copy(&frag_info[i].sender, sender);
+  frag_info[i].tag = tag;
+  frag_info[i].len = frag_size;
+  frag_info[i].reassembled_len = 0;
+  frag_info[i].buf_offset = offset;
+  memset(frag_info[i].received, 0, sizeof(frag_info[i].received));
+  timer_set(&frag_info[i].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+#if SICSLOWPAN_REASS_HASH_INDEX
+  hash_insert(i);
+#endif /* SICSLOWPAN_REASS_HASH_INDEX */
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/* Record the reception of len bytes of a packet, at offset, in the
+ * bitmap received and the byte count received_len. Returns 1 if the
+ * bytes are new, 0 if they were all received before, and -1 if they
+ * overlap with bytes received before. */
+static int
+mark_received(uint8_t *received, uint16_t *received_len,
+              uint16_t offset, uint16_t len)
+{
+  unsigned unit;
+  unsigned first = offset / REASS_UNIT;
+  unsigned last = (offset + len - 1) / REASS_UNIT;
+  unsigned count = 0;
+
+  for(unit = first; unit <= last; unit++) {
+    if(received[unit / 8] & (1 << (unit % 8))) {
+      count++;
+    }
   }
-  if(len > 0) {
-    frag_info[i].reassembled_len += len;
-    return i;
-  } else {
-    /* should we also clear all fragments since we failed to store
-       this fragment? */
-    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
-    return -1;
+  if(count > 0) {
+    return count == last - first + 1 ? 0 : -1;
+  }
+
+  for(unit = first; unit <= last; unit++) {
+    received[unit / 8] |= 1 << (unit % 8);
   }
+  *received_len += len;
+  return 1;
 }
 /*---------------------------------------------------------------------------*/
-/* Copy all the fragments that are associated with a specific context
-   into uip */
-static bool
-copy_frags2uip(int context)
+#if SICSLOWPAN_FRAG_FORWARDING
+/* A virtual reassembly buffer: the state of a packet that is forwarded
+ * fragment by fragment. It maps the sender and tag of the incoming
+ * fragments to the next hop and tag of the outgoing ones. Once all
+ * fragments are through, the entry is kept to recognize retransmitted
+ * ones, until it expires or is needed for another packet. */
+struct sicslowpan_vrb {
+  /** The sender of the incoming fragments */
+  linkaddr_t sender;
+  /** The next hop of the outgoing fragments */
+  linkaddr_t next_hop;
+  /** The tag of the incoming fragments */
+  uint16_t tag;
+  /** The tag of the outgoing fragments */
+  uint16_t out_tag;
+  /** Size of the incoming packet (zero if the entry is free) */
+  uint16_t len;
+  /** Size of the outgoing packet, which differs from the incoming one
+      if the routing protocol added or removed extension headers (zero
+      until the first fragment is sent) */
+  uint16_t out_len;
+  /** Number of bytes of the incoming packet forwarded (or dropped) so far */
+  uint16_t forwarded_len;
+  /** One bit per 8-byte unit of the incoming packet, set when forwarded
+      (or dropped), so that retransmitted fragments are not sent twice */
+  uint8_t received[REASS_BITMAP_SIZE];
+  /** Set if the IP stack rejected the first fragment: the other
+      fragments are dropped instead of forwarded */
+  uint8_t discard;
+  /** MAC attributes of the first fragment, used for the others too */
+  uint8_t max_mac_transmissions;
+#if LLSEC802154_USES_AUX_HEADER
+  uint8_t security_level;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_index;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+  /** Entries expire like reassembly contexts */
+  struct timer timer;
+};
+
+static struct sicslowpan_vrb vrb_table[SICSLOWPAN_FRAG_FORWARDING_ENTRIES];
+
+/* The entry of the packet whose first fragment is going through the IP
+ * stack, if any */
+static struct sicslowpan_vrb *vrb_pending;
+/*---------------------------------------------------------------------------*/
+static struct sicslowpan_vrb *
+vrb_lookup(const linkaddr_t *sender, uint16_t tag)
 {
   int i;
 
-  /* Check length fields before proceeding. */
-  if(frag_info[context].len < frag_info[context].first_frag_len ||
-     frag_info[context].len > sizeof(uip_buf)) {
-    LOG_WARN("input: invalid total size of fragments\n");
-    clear_fragments(context);
-    return false;
-  }
-
-  /* Copy from the fragment context info buffer first */
-  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].first_frag,
-         frag_info[context].first_frag_len);
-
-  /* Ensure that no previous data is used for reassembly in case of missing fragments. */
-  memset((uint8_t *)UIP_IP_BUF + frag_info[context].first_frag_len, 0,
-         frag_info[context].len - frag_info[context].first_frag_len);
-
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    /* And also copy all matching fragments */
-    if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
-      if((frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
-        LOG_WARN("input: invalid fragment offset\n");
-        clear_fragments(context);
-        return false;
+  for(i = 0; i < SICSLOWPAN_FRAG_FORWARDING_ENTRIES; i++) {
+    if(vrb_table[i].len > 0 &&
+       (vrb_table[i].out_len > 0 || vrb_table[i].discard) &&
+       vrb_table[i].tag == tag &&
+       linkaddr_cmp(&vrb_table[i].sender, sender)) {
+      if(timer_expired(&vrb_table[i].timer)) {
+        vrb_table[i].len = 0;
+        return NULL;
       }
-      memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
-             (uint8_t *)frag_buf[i].data, frag_buf[i].len);
+      return &vrb_table[i];
     }
   }
-  /* deallocate all the fragments for this context */
-  clear_fragments(context);
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct sicslowpan_vrb *
+vrb_alloc(void)
+{
+  int i;
 
-  return true;
+  for(i = 0; i < SICSLOWPAN_FRAG_FORWARDING_ENTRIES; i++) {
+    if(vrb_table[i].len == 0 ||
+       vrb_table[i].forwarded_len >= vrb_table[i].len ||
+       timer_expired(&vrb_table[i].timer)) {
+      memset(&vrb_table[i], 0, sizeof(vrb_table[i]));
+      timer_set(&vrb_table[i].timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+      return &vrb_table[i];
+    }
+  }
+  return NULL;
 }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 #endif /* SICSLOWPAN_CONF_FRAG */
+/*---------------------------------------------------------------------------*/
+const struct sicslowpan_reass_stats *
+sicslowpan_get_reass_stats(void)
+{
+  return &reass_stats;
+}
 
 /* -------------------------------------------------------------------------- */
 
@@ -513,6 +735,31 @@ static struct sicslowpan_addr_context
 addr_contexts[SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS];
 #endif
 
+/* Cache the context that matches each recently compressed address
+ * prefix, or the absence of one, instead of comparing the prefix with
+ * every context. A power of two, zero to disable. */
+#ifdef SICSLOWPAN_CONF_ADDR_CONTEXT_CACHE_SIZE
+#define SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE SICSLOWPAN_CONF_ADDR_CONTEXT_CACHE_SIZE
+#else
+#define SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE 0
+#endif
+
+#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 && SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0
+#if (SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE & (SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE - 1)) != 0
+#error "SICSLOWPAN_CONF_ADDR_CONTEXT_CACHE_SIZE must be a power of two"
+#endif
+/* A direct-mapped cache entry */
+struct addr_context_cache_entry {
+  /** The first 64 bits of the address */
+  uint8_t prefix[8];
+  /** Index of the matching context plus two, one if no context
+      matches, or zero if the entry is empty */
+  uint8_t context;
+};
+static struct addr_context_cache_entry
+addr_context_cache[SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE];
+#endif
+
 /** pointer to an address context. */
 static struct sicslowpan_addr_context *context;
 
@@ -552,17 +799,58 @@ static const uint8_t ttl_values[] = {0, 1, 64, 255};
 /** \name IPHC related functions
  * @{                                                                 */
 /*--------------------------------------------------------------------*/
-/** \brief find the context corresponding to prefix ipaddr */
+#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+/** \brief forget the cached context matches, after the contexts changed */
+static void
+addr_context_cache_flush(void)
+{
+#if SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0
+  memset(addr_context_cache, 0, sizeof(addr_context_cache));
+#endif /* SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0 */
+}
+/*--------------------------------------------------------------------*/
+/** \brief check that a context has not expired, and remove it if it has */
+static struct sicslowpan_addr_context *
+addr_context_check_lifetime(struct sicslowpan_addr_context *c)
+{
+  if(c != NULL && !c->isinfinite && stimer_expired(&c->lifetime)) {
+    LOG_INFO("context %u expired\n", c->number);
+    c->used = 0;
+    addr_context_cache_flush();
+    return NULL;
+  }
+  return c;
+}
+#endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+/*--------------------------------------------------------------------*/
+/** \brief find the context to compress the prefix of ipaddr with */
 static struct sicslowpan_addr_context*
 addr_context_lookup_by_prefix(uip_ipaddr_t *ipaddr)
 {
 /* Remove code to avoid warnings and save flash if no context is used */
 #if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
   int i;
+#if SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0
+  uint32_t hash = addr_hash_fnv1a(ADDR_HASH_FNV1A_INIT, ipaddr->u8, 8);
+  struct addr_context_cache_entry *e;
+
+  e = &addr_context_cache[addr_hash_fold(hash,
+                            SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE - 1)];
+  if(e->context != 0 && memcmp(e->prefix, ipaddr->u8, 8) == 0) {
+    return e->context == 1 ? NULL :
+      addr_context_check_lifetime(&addr_contexts[e->context - 2]);
+  }
+  memcpy(e->prefix, ipaddr->u8, 8);
+  e->context = 1;
+#endif /* SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0 */
+
   for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
-    if((addr_contexts[i].used == 1) &&
+    if((addr_contexts[i].used == 1) && addr_contexts[i].compress &&
        uip_ipaddr_prefixcmp(&addr_contexts[i].prefix, ipaddr, 64)) {
-      return &addr_contexts[i];
+#if SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0
+      e->context = i + 2;
+#endif /* SICSLOWPAN_ADDR_CONTEXT_CACHE_SIZE > 0 */
+      return addr_context_check_lifetime(&addr_contexts[i]);
     }
   }
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
@@ -579,13 +867,72 @@ addr_context_lookup_by_number(uint8_t number)
   for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
     if((addr_contexts[i].used == 1) &&
        addr_contexts[i].number == number) {
-      return &addr_contexts[i];
+      return addr_context_check_lifetime(&addr_contexts[i]);
     }
   }
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
   return NULL;
 }
 /*--------------------------------------------------------------------*/
+int
+sicslowpan_addr_context_set(uint8_t number, const uip_ipaddr_t *prefix,
+                            uint8_t compress, unsigned long lifetime)
+{
+#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  struct sicslowpan_addr_context *c;
+  int i;
+
+  if(number > 15) {
+    return 0;
+  }
+
+  c = addr_context_lookup_by_number(number);
+  for(i = 0; c == NULL && i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
+    if(addr_contexts[i].used == 0) {
+      c = &addr_contexts[i];
+    }
+  }
+  if(c == NULL) {
+    LOG_WARN("no room for context %u\n", number);
+    return 0;
+  }
+
+  c->used = 1;
+  c->number = number;
+  memcpy(c->prefix, prefix->u8, sizeof(c->prefix));
+  c->compress = compress;
+  c->isinfinite = lifetime == 0;
+  if(lifetime != 0) {
+    stimer_set(&c->lifetime, lifetime);
+  }
+  addr_context_cache_flush();
+  return 1;
+#else /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+  return 0;
+#endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+}
+/*--------------------------------------------------------------------*/
+int
+sicslowpan_addr_context_rm(uint8_t number)
+{
+  struct sicslowpan_addr_context *c = addr_context_lookup_by_number(number);
+
+  if(c == NULL) {
+    return 0;
+  }
+  c->used = 0;
+#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  addr_context_cache_flush();
+#endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+const struct sicslowpan_addr_context *
+sicslowpan_addr_context_get(uint8_t number)
+{
+  return addr_context_lookup_by_number(number);
+}
+/*--------------------------------------------------------------------*/
 static uint8_t
 compress_addr_64(uint8_t bitpos, uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr)
 {
@@ -688,6 +1035,7 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
   uint8_t tmp, iphc0, iphc1, *next_hdr, *next_nhc;
   int ext_hdr_len;
   struct uip_udp_hdr *udp_buf;
+  struct sicslowpan_addr_context *src_context, *dest_context;
 
   if(LOG_DBG_ENABLED) {
     uint16_t ndx;
@@ -734,11 +1082,14 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
    */
 
 
-  /* check if dest context exists (for allocating third byte) */
-  /* TODO: fix this so that it remembers the looked up values for
-     avoiding two lookups - or set the lookup values immediately */
-  if(addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr) != NULL ||
-     addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr) != NULL) {
+  /* Look up the contexts of the addresses. The third byte with the
+     context numbers is only needed if one is not context 0. */
+  src_context = uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr) ? NULL :
+    addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr);
+  dest_context = uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ? NULL :
+    addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr);
+  if((src_context != NULL && src_context->number != 0) ||
+     (dest_context != NULL && dest_context->number != 0)) {
     /* set context flag and increase hc06_ptr */
     LOG_DBG("compression: dest or src ipaddr - setting CID\n");
     iphc1 |= SICSLOWPAN_IPHC_CID;
@@ -830,13 +1181,14 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
     LOG_DBG("compression: addr unspecified - setting SAC\n");
     iphc1 |= SICSLOWPAN_IPHC_SAC;
     iphc1 |= SICSLOWPAN_IPHC_SAM_00;
-  } else if((context = addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr))
-     != NULL) {
-    /* elide the prefix - indicate by CID and set context + SAC */
-    LOG_DBG("compression: src with context - setting CID & SAC ctx: %d\n",
-           context->number);
-    iphc1 |= SICSLOWPAN_IPHC_CID | SICSLOWPAN_IPHC_SAC;
-    PACKETBUF_IPHC_BUF[2] |= context->number << 4;
+  } else if(src_context != NULL) {
+    /* elide the prefix - indicate by SAC and the context number */
+    LOG_DBG("compression: src with context - setting SAC ctx: %d\n",
+           src_context->number);
+    iphc1 |= SICSLOWPAN_IPHC_SAC;
+    if(iphc1 & SICSLOWPAN_IPHC_CID) {
+      PACKETBUF_IPHC_BUF[2] |= src_context->number << 4;
+    }
     /* compession compare with this nodes address (source) */
 
     iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_SAM_BIT,
@@ -884,10 +1236,12 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
     }
   } else {
     /* Address is unicast, try to compress */
-    if((context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr)) != NULL) {
+    if(dest_context != NULL) {
       /* elide the prefix */
       iphc1 |= SICSLOWPAN_IPHC_DAC;
-      PACKETBUF_IPHC_BUF[2] |= context->number;
+      if(iphc1 & SICSLOWPAN_IPHC_CID) {
+        PACKETBUF_IPHC_BUF[2] |= dest_context->number;
+      }
       /* compession compare with link adress (destination) */
 
       iphc1 |= compress_addr_64(SICSLOWPAN_IPHC_DAM_BIT,
@@ -1297,6 +1651,12 @@ uncompress_hdr_iphc(uint8_t *buf, uint16_t buf_size, uint16_t ip_len)
     struct uip_udp_hdr *udp_buf = (struct uip_udp_hdr *)ip_payload;
     uint16_t udp_len;
     uint8_t checksum_compressed;
+
+    /* Check that there is enough room to write the UDP header. */
+    if((ip_payload - buf) + UIP_UDPH_LEN > buf_size) {
+      LOG_WARN("uncompression: cannot write UDP header beyond target buffer\n");
+      return;
+    }
     *last_nextheader = UIP_PROTO_UDP;
     checksum_compressed = *hc06_ptr & SICSLOWPAN_NHC_UDP_CHECKSUMC;
     LOG_DBG("uncompression: incoming header value: %i\n", *hc06_ptr);
@@ -1551,6 +1911,8 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
   /* Restore packetbuf from queuebuf */
   queuebuf_to_packetbuf(q);
   queuebuf_free(q);
+  /* The next fragment is written in place, so get a writable copy */
+  packetbuf_ptr = packetbuf_dataptr();
 
   /* Check tx result. */
   if((last_tx_status == MAC_TX_COLLISION) ||
@@ -1561,6 +1923,222 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
   }
   return 1;
 }
+#if SICSLOWPAN_FRAG_FORWARDING
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Send the first fragment of a packet that is forwarded fragment
+ * by fragment. uip_buf holds the part of the packet received in the
+ * first incoming fragment, with its headers already compressed in
+ * packetbuf.
+ * \param dest the link layer destination address of the packet
+ * \return 1 if success, 0 otherwise
+ */
+static uint8_t
+vrb_output_first_fragment(linkaddr_t *dest)
+{
+  uint16_t out_len = uipbuf_get_len_field(UIP_IP_BUF) + UIP_IPH_LEN;
+
+  if(vrb_pending == NULL ||
+     !uipbuf_is_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT)) {
+    LOG_WARN("output: packet shorter than its IP header reports, dropping\n");
+    return 0;
+  }
+
+  /* The following fragments keep their payload, so the headers may only
+     have changed by whole units of fragment offset */
+  if(out_len > 0x7ff || ((out_len - vrb_pending->len) & 7) != 0) {
+    LOG_WARN("output: cannot forward fragments of packet with len %u -> %u\n",
+             vrb_pending->len, out_len);
+    return 0;
+  }
+
+  if(uip_len - uncomp_hdr_len + packetbuf_hdr_len + SICSLOWPAN_FRAG1_HDR_LEN >
+     mac_max_payload) {
+    LOG_WARN("output: first fragment does not fit in a frame after compression\n");
+    return 0;
+  }
+
+  vrb_pending->out_tag = my_tag++;
+  vrb_pending->out_len = out_len;
+  linkaddr_copy(&vrb_pending->next_hop, dest);
+  vrb_pending->max_mac_transmissions =
+    packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS);
+#if LLSEC802154_USES_AUX_HEADER
+  vrb_pending->security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  vrb_pending->key_index = packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  /* Move IPHC/IPv6 header to make room for FRAG1 header */
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr, packetbuf_hdr_len);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | out_len));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, vrb_pending->out_tag);
+
+  memcpy(packetbuf_ptr + packetbuf_hdr_len, (uint8_t *)UIP_IP_BUF + uncomp_hdr_len,
+         uip_len - uncomp_hdr_len);
+  packetbuf_set_datalen(uip_len - uncomp_hdr_len + packetbuf_hdr_len);
+
+  LOG_INFO("output: forwarding first fragment (tag %d -> %d, len %d -> %d)\n",
+           vrb_pending->tag, vrb_pending->out_tag, vrb_pending->len, out_len);
+  send_packet(dest);
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Relay a non-first fragment of a packet whose first fragment was
+ * forwarded. The fragment is in packetbuf, its header is rewritten in
+ * place.
+ * \param vrb the entry of the packet
+ * \param frag_offset the offset of the fragment, in units of 8 bytes
+ * \param payload_len the payload length of the fragment
+ */
+static void
+vrb_forward_fragment(struct sicslowpan_vrb *vrb, uint8_t frag_offset,
+                     uint16_t payload_len)
+{
+  linkaddr_t next_hop;
+  int offset = (frag_offset << 3) + vrb->out_len - vrb->len;
+
+  switch(mark_received(vrb->received, &vrb->forwarded_len,
+                       frag_offset << 3, payload_len)) {
+  case 0:
+    LOG_INFO("input: duplicate fragment, not forwarded (tag %d, offset %d)\n",
+             vrb->tag, frag_offset << 3);
+    reass_stats.duplicates++;
+    return;
+  case -1:
+    LOG_WARN("input: overlapping fragment, dropping packet (tag %d, offset %d)\n",
+             vrb->tag, frag_offset << 3);
+    reass_stats.overlaps++;
+    vrb->len = 0;
+    return;
+  }
+
+  if(vrb->discard) {
+    LOG_INFO("input: dropping fragment of rejected packet (tag %d, offset %d)\n",
+             vrb->tag, frag_offset << 3);
+    return;
+  }
+
+  if(offset < 0 || (offset >> 3) > 0xff) {
+    LOG_WARN("input: cannot forward fragment at offset %d\n", offset);
+    vrb->len = 0;
+    return;
+  }
+
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAGN << 8) | vrb->out_len));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, vrb->out_tag);
+  PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] = offset >> 3;
+
+  /* Replace the attributes of the incoming frame with those of the
+     first outgoing fragment */
+  linkaddr_copy(&next_hop, &vrb->next_hop);
+  packetbuf_attr_clear();
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS,
+                     vrb->max_mac_transmissions);
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, vrb->security_level);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX, vrb->key_index);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  if(packetbuf_datalen() > NETSTACK_MAC.max_payload()) {
+    LOG_WARN("input: fragment too large for the next hop, dropping packet\n");
+    vrb->len = 0;
+    return;
+  }
+
+  LOG_INFO("input: forwarding fragment (tag %d -> %d, offset %d -> %d)\n",
+           vrb->tag, vrb->out_tag, frag_offset << 3, offset);
+  reass_stats.forwarded_fragments++;
+  send_packet(&next_hop);
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Try to forward the first fragment of a packet that is not for
+ * us, instead of waiting for the whole packet. The fragment goes
+ * through the IP stack like a packet, flagged with
+ * UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT, and output() sends it as the first
+ * fragment of a packet to the next hop. The following fragments are
+ * then relayed as they arrive. If the first fragment is not sent, the
+ * packet is reassembled and forwarded as a whole instead, unless the IP
+ * stack answered it with an ICMPv6 error: then the packet is dropped.
+ * \param context the reassembly context of the packet, which holds only
+ * the first fragment
+ */
+static void
+vrb_forward_first_fragment(int context)
+{
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  struct sicslowpan_vrb *vrb;
+  /* Regions of the reassembly buffer are aligned */
+  struct uip_ip_hdr *packet =
+    (struct uip_ip_hdr *)&reass_buf.u8[info->buf_offset];
+
+  /* Only packets that uip_process() forwards on their destination
+     address qualify. A packet addressed to us is reassembled even if a
+     source routing header sends it on: uip_process() updates the
+     routing header only in its extension header loop, which a first
+     fragment never reaches. Downward traffic in RPL non-storing mode
+     is thus forwarded as whole packets by every hop. */
+  if(uip_is_addr_mcast(&packet->destipaddr) ||
+     uip_is_addr_linklocal(&packet->destipaddr) ||
+     uip_ds6_is_my_addr(&packet->destipaddr)) {
+    return;
+  }
+
+  vrb = vrb_alloc();
+  if(vrb == NULL) {
+    LOG_INFO("input: no free entry to forward fragments, reassembling\n");
+    return;
+  }
+  linkaddr_copy(&vrb->sender, &info->sender);
+  vrb->tag = info->tag;
+  vrb->len = info->len;
+  vrb->forwarded_len = info->reassembled_len;
+  memcpy(vrb->received, info->received, sizeof(vrb->received));
+
+  memcpy(UIP_IP_BUF, packet, info->reassembled_len);
+  uip_len = info->reassembled_len;
+  uipbuf_set_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT);
+#if LLSEC802154_USES_AUX_HEADER
+  uipbuf_set_attr(UIPBUF_ATTR_LLSEC_LEVEL,
+    packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL));
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uipbuf_set_attr(UIPBUF_ATTR_LLSEC_KEY_ID,
+    packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX));
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /*  LLSEC802154_USES_AUX_HEADER */
+
+  vrb_pending = vrb;
+  tcpip_input();
+  vrb_pending = NULL;
+
+  if(vrb->discard) {
+    /* The IP stack answered the first fragment with an ICMPv6 error:
+       it would do the same for the whole packet, so do not reassemble
+       it, and drop the other fragments as they arrive */
+    LOG_INFO("input: first fragment rejected, dropping packet (tag %d)\n",
+             info->tag);
+    free_context(context);
+    return;
+  }
+  if(vrb->out_len == 0) {
+    LOG_INFO("input: first fragment not forwarded, reassembling (tag %d)\n",
+             info->tag);
+    vrb->len = 0;
+    return;
+  }
+  free_context(context);
+  reass_stats.forwarded++;
+}
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 #endif /* SICSLOWPAN_CONF_FRAG */
 /*--------------------------------------------------------------------*/
 /** \brief Take an IP packet and format it to be sent on an 802.15.4
@@ -1656,6 +2234,19 @@ output(const linkaddr_t *localdest)
 
   packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &dest);
 
+#if SICSLOWPAN_FRAG_FORWARDING
+  if(uip_len < uipbuf_get_len_field(UIP_IP_BUF) + UIP_IPH_LEN) {
+    /* Only the first fragment of the packet is in uip_buf */
+    return vrb_output_first_fragment(&dest);
+  }
+  if(vrb_pending != NULL &&
+     !uipbuf_is_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT)) {
+    /* uip_icmp6_error_output() clears the flag: the IP stack sends an
+       error in response to the first fragment */
+    vrb_pending->discard = 1;
+  }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
   frag_needed = (int)uip_len - (int)uncomp_hdr_len + (int)packetbuf_hdr_len > mac_max_payload;
   LOG_INFO("output: header len %d -> %d, total len %d -> %d, MAC max payload %d, frag_needed %d\n",
             uncomp_hdr_len, packetbuf_hdr_len,
@@ -1821,7 +2412,10 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   uint8_t is_fragment = 0;
-  int8_t frag_context = 0;
+  int frag_context = 0;
+#if SICSLOWPAN_FRAG_FORWARDING
+  struct sicslowpan_vrb *vrb;
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 
   /* tag of the fragment */
   uint16_t frag_tag = 0;
@@ -1872,16 +2466,25 @@ input(void)
       LOG_INFO("input: received first element of a fragmented packet (tag %d, len %d)\n",
              frag_tag, frag_size);
 
-      /* Add the fragment to the fragmentation context */
-      frag_context = add_fragment(frag_tag, frag_size, frag_offset);
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(vrb_lookup(packetbuf_addr(PACKETBUF_ADDR_SENDER), frag_tag) != NULL) {
+        LOG_INFO("input: first fragment already forwarded (tag %d)\n", frag_tag);
+        reass_stats.duplicates++;
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
+      /* Get the reassembly context. The headers are uncompressed
+         directly into its buffer. */
+      frag_context = get_context(frag_tag, frag_size);
 
       if(frag_context == -1) {
         LOG_ERR("input: failed to allocate new reassembly context\n");
         return;
       }
 
-      buffer = frag_info[frag_context].first_frag;
-      buffer_size = SICSLOWPAN_FIRST_FRAGMENT_SIZE;
+      buffer = &reass_buf.u8[frag_info[frag_context].buf_offset];
+      buffer_size = frag_size;
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
       /*
@@ -1893,22 +2496,28 @@ input(void)
       frag_size = GET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE) & 0x07ff;
       packetbuf_hdr_len += SICSLOWPAN_FRAGN_HDR_LEN;
 
-      /* Add the fragment to the fragmentation context (this will also
-         copy the payload) */
-      frag_context = add_fragment(frag_tag, frag_size, frag_offset);
-
-      if(frag_context == -1) {
-        LOG_ERR("input: reassembly context not found (tag %d)\n", frag_tag);
+#if SICSLOWPAN_FRAG_FORWARDING
+      /* Relay the fragment if its first fragment was forwarded */
+      vrb = vrb_lookup(packetbuf_addr(PACKETBUF_ADDR_SENDER), frag_tag);
+      if(vrb != NULL && vrb->len == frag_size &&
+         packetbuf_datalen() > packetbuf_hdr_len) {
+        vrb_forward_fragment(vrb, frag_offset,
+                             packetbuf_datalen() - packetbuf_hdr_len);
         return;
       }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 
-      /* Ok - add_fragment will store the fragment automatically - so
-         we should not store more */
-      buffer = NULL;
+      /* Get the reassembly context, which may not exist yet if
+         the first fragment has not been received */
+      frag_context = get_context(frag_tag, frag_size);
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
-        last_fragment = 1;
+      if(frag_context == -1) {
+        LOG_ERR("input: failed to allocate reassembly context (tag %d)\n", frag_tag);
+        return;
       }
+
+      buffer = &reass_buf.u8[frag_info[frag_context].buf_offset];
+      buffer_size = frag_size;
       is_fragment = 1;
       break;
     default:
@@ -1980,97 +2589,109 @@ input(void)
   {
     int req_size = uncomp_hdr_len + (uint16_t)(frag_offset << 3)
         + packetbuf_payload_len;
-    if(req_size > sizeof(uip_buf)) {
+    if(req_size > buffer_size) {
 #if SICSLOWPAN_CONF_FRAG
-      LOG_ERR(
-          "input: packet and fragment context %u dropped, minimum required IP_BUF size: %d+%d+%d=%d (current size: %u)\n",
-          frag_context,
-          uncomp_hdr_len, (uint16_t)(frag_offset << 3),
-          packetbuf_payload_len, req_size, (unsigned)sizeof(uip_buf));
-      /* Discard all fragments for this contex, as reassembling this particular fragment would
-       * cause an overflow in uipbuf */
-      clear_fragments(frag_context);
+      if(is_fragment) {
+        LOG_ERR(
+            "input: packet and fragment context %u dropped, fragment ends at %d+%d+%d=%d (packet size: %u)\n",
+            frag_context,
+            uncomp_hdr_len, (uint16_t)(frag_offset << 3),
+            packetbuf_payload_len, req_size, buffer_size);
+        /* Discard the packet, as this fragment does not belong to it */
+        reass_stats.invalid++;
+        free_context(frag_context);
+        return;
+      }
 #endif /* SICSLOWPAN_CONF_FRAG */
+      LOG_ERR("input: packet dropped, minimum required IP_BUF size: %d+%d=%d (current size: %u)\n",
+              uncomp_hdr_len, packetbuf_payload_len, req_size, buffer_size);
       return;
     }
   }
 
-  /* copy the payload if buffer is non-null - which is only the case with first fragment
-     or packets that are non fragmented */
-  if(buffer != NULL) {
-    memcpy((uint8_t *)buffer + uncomp_hdr_len, packetbuf_ptr + packetbuf_hdr_len, packetbuf_payload_len);
+#if SICSLOWPAN_CONF_FRAG
+  if(is_fragment) {
+    switch(mark_received(frag_info[frag_context].received,
+                         &frag_info[frag_context].reassembled_len,
+                         frag_offset << 3,
+                         uncomp_hdr_len + packetbuf_payload_len)) {
+    case 0:
+      LOG_INFO("input: duplicate fragment (tag %d, offset %d)\n",
+               frag_tag, frag_offset << 3);
+      reass_stats.duplicates++;
+      return;
+    case -1:
+      LOG_WARN("input: overlapping fragment, dropping packet (tag %d, offset %d)\n",
+               frag_tag, frag_offset << 3);
+      reass_stats.overlaps++;
+      free_context(frag_context);
+      return;
+    }
+    last_fragment = frag_info[frag_context].reassembled_len == frag_size;
   }
+#endif /* SICSLOWPAN_CONF_FRAG */
+
+  /* Copy the payload. Uncompressed headers, if any, are already in
+     place, and fragments go directly at their offset in the packet. */
+  memcpy((uint8_t *)buffer + uncomp_hdr_len + (uint16_t)(frag_offset << 3),
+         packetbuf_ptr + packetbuf_hdr_len, packetbuf_payload_len);
 
-  /* update processed_ip_in_len if fragment, sicslowpan_len otherwise */
+  uip_len = packetbuf_payload_len + uncomp_hdr_len;
 
 #if SICSLOWPAN_CONF_FRAG
-  if(frag_size > 0) {
-    /* Add the size of the header only for the first fragment. */
-    if(first_fragment != 0) {
-      frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
-      frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
-    }
-    /* For the last fragment, we are OK if there is extrenous bytes at
-       the end of the packet. */
-    if(last_fragment != 0) {
-      frag_info[frag_context].reassembled_len = frag_size;
-      /* copy to uip */
-      if(!copy_frags2uip(frag_context)) {
-        return;
+  if(is_fragment) {
+    if(!last_fragment) {
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(first_fragment &&
+         frag_info[frag_context].reassembled_len == uip_len) {
+        vrb_forward_first_fragment(frag_context);
       }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+      /* Wait for the rest of the packet */
+      return;
     }
+    /* The packet is complete, move it to uip */
+    memcpy(UIP_IP_BUF, buffer, frag_size);
+    uip_len = frag_size;
+    free_context(frag_context);
+    reass_stats.reassembled++;
   }
-
-  /*
-   * If we have a full IP packet in sicslowpan_buf, deliver it to
-   * the IP stack
-   */
-  if(!is_fragment || last_fragment) {
-    /* packet is in uip already - just set length */
-    if(is_fragment != 0 && last_fragment != 0) {
-      uip_len = frag_size;
-    } else {
-      uip_len = packetbuf_payload_len + uncomp_hdr_len;
-    }
-#else
-    uip_len = packetbuf_payload_len + uncomp_hdr_len;
 #endif /* SICSLOWPAN_CONF_FRAG */
-    LOG_INFO("input: received IPv6 packet with len %d\n",
-             uip_len);
-
-    if(LOG_DBG_ENABLED) {
-      uint16_t ndx;
-      LOG_DBG("uncompression: after (%u):", UIP_IP_BUF->len[1]);
-      for (ndx = 0; ndx < UIP_IP_BUF->len[1] + 40; ndx++) {
-        uint8_t data = ((uint8_t *) (UIP_IP_BUF))[ndx];
-        LOG_DBG_("%02x", data);
-      }
-      LOG_DBG_("\n");
-    }
 
-    /* if callback is set then set attributes and call */
-    if(callback) {
-      set_packet_attrs();
-      callback->input_callback();
+  /* We have a full IP packet in uip_buf, deliver it to the IP stack */
+  LOG_INFO("input: received IPv6 packet with len %d\n",
+           uip_len);
+
+  if(LOG_DBG_ENABLED) {
+    uint16_t ndx;
+    LOG_DBG("uncompression: after (%u):", UIP_IP_BUF->len[1]);
+    for (ndx = 0; ndx < UIP_IP_BUF->len[1] + 40; ndx++) {
+      uint8_t data = ((uint8_t *) (UIP_IP_BUF))[ndx];
+      LOG_DBG_("%02x", data);
     }
+    LOG_DBG_("\n");
+  }
+
+  /* if callback is set then set attributes and call */
+  if(callback) {
+    set_packet_attrs();
+    callback->input_callback();
+  }
 
 #if LLSEC802154_USES_AUX_HEADER
-    /*
-     * Assuming that the last packet in packetbuf is containing
-     *  the LLSEC state so that it can be copied to uipbuf.
-     */
-    uipbuf_set_attr(UIPBUF_ATTR_LLSEC_LEVEL,
-      packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL));
+  /*
+   * Assuming that the last packet in packetbuf is containing
+   *  the LLSEC state so that it can be copied to uipbuf.
+   */
+  uipbuf_set_attr(UIPBUF_ATTR_LLSEC_LEVEL,
+    packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL));
 #if LLSEC802154_USES_EXPLICIT_KEYS
-    uipbuf_set_attr(UIPBUF_ATTR_LLSEC_KEY_ID,
-      packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX));
+  uipbuf_set_attr(UIPBUF_ATTR_LLSEC_KEY_ID,
+    packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX));
 #endif /* LLSEC802154_USES_EXPLICIT_KEYS */
 #endif /*  LLSEC802154_USES_AUX_HEADER */
 
-    tcpip_input();
-#if SICSLOWPAN_CONF_FRAG
-  }
-#endif /* SICSLOWPAN_CONF_FRAG */
+  tcpip_input();
 }
 /** @} */
 
@@ -2088,6 +2709,13 @@ sicslowpan_init(void)
  * #define SICSLOWPAN_CONF_ADDR_CONTEXT_0 {addr_contexts[0].prefix[0]=0xbb;addr_contexts[0].prefix[1]=0xbb;}
  */
 #if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  {
+    int i;
+    for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
+      addr_contexts[i].compress = 1;
+      addr_contexts[i].isinfinite = 1;
+    }
+  }
   addr_contexts[0].used   = 1;
   addr_contexts[0].number = 0;
 #ifdef SICSLOWPAN_CONF_ADDR_CONTEXT_0
@@ -51,6 +51,7 @@
 
 #include "net/ipv6/uip.h"
 #include "net/mac/mac.h"
+#include "sys/stimer.h"
 
 /**
  * \name General sicslowpan defines
@@ -240,6 +241,11 @@ struct sicslowpan_addr_context {
   uint8_t used; /* possibly use as prefix-length */
   uint8_t number;
   uint8_t prefix[8];
+  /** Use the context for compression, not only for decompression
+      (the C flag of the 6LoWPAN Context Option, RFC 6775) */
+  uint8_t compress;
+  uint8_t isinfinite;
+  struct stimer lifetime;
 };
 
 /**
@@ -338,6 +344,52 @@ struct sicslowpan_nh_compressor {
 
 int sicslowpan_get_last_rssi(void);
 
+/**
+ * Statistics of the reassembly of fragmented packets
+ */
+struct sicslowpan_reass_stats {
+  uint32_t reassembled; /**< Packets reassembled and delivered */
+  uint32_t timeouts;    /**< Packets dropped after SICSLOWPAN_REASS_MAXAGE */
+  uint32_t no_context;  /**< Fragments dropped for lack of a context or buffer space */
+  uint32_t duplicates;  /**< Duplicate fragments ignored */
+  uint32_t overlaps;    /**< Packets dropped on overlapping fragments */
+  uint32_t invalid;     /**< Packets dropped on inconsistent sizes or offsets */
+  uint32_t forwarded;   /**< Packets forwarded fragment by fragment */
+  uint32_t forwarded_fragments; /**< Non-first fragments relayed */
+};
+
+/**
+ * \brief Get the statistics of the reassembly of fragmented packets
+ * \return The statistics, counted since the system started
+ */
+const struct sicslowpan_reass_stats *sicslowpan_get_reass_stats(void);
+
+/**
+ * \brief Add or update an address context for IPHC
+ * \param number The context identifier, 0 to 15
+ * \param prefix The context prefix; only its first 64 bits are used
+ * \param compress Nonzero to compress with the context, zero to only
+ * decompress with it
+ * \param lifetime The context lifetime in seconds, 0 for infinite
+ * \retval 1 if the context was set, 0 if there is no room for it
+ */
+int sicslowpan_addr_context_set(uint8_t number, const uip_ipaddr_t *prefix,
+                                uint8_t compress, unsigned long lifetime);
+
+/**
+ * \brief Remove an address context
+ * \param number The context identifier
+ * \retval 1 if the context was removed, 0 if it did not exist
+ */
+int sicslowpan_addr_context_rm(uint8_t number);
+
+/**
+ * \brief Get an address context
+ * \param number The context identifier
+ * \return The context, or NULL if it does not exist or has expired
+ */
+const struct sicslowpan_addr_context *sicslowpan_addr_context_get(uint8_t number);
+
 extern const struct network_driver sicslowpan_driver;
 
 #endif /* SICSLOWPAN_H_ */
@@ -72,6 +72,13 @@ static struct etimer periodic;
 extern struct etimer uip_reass_timer;
 #endif
 
+#if UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0
+/* Incoming packets waiting for tcpip_process */
+static struct uip_packetqueue_handle input_queue;
+/* Incoming packets dropped because the queue was full */
+static uint32_t input_queue_drops;
+#endif /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
+
 #if UIP_TCP
 /**
  * \internal Structure for holding a TCP port and a process ID.
@@ -438,6 +445,26 @@ eventhandler(process_event_t ev, process_data_t data)
   case PACKET_INPUT:
     packet_input();
     break;
+
+#if UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0
+  case PROCESS_EVENT_POLL:
+    /* Process one queued packet at a time, so that other processes get
+       to run during a burst */
+    if(uip_packetqueue_buflen(&input_queue) != 0) {
+      uip_len = uip_packetqueue_buflen(&input_queue);
+      memcpy(UIP_IP_BUF, uip_packetqueue_buf(&input_queue), uip_len);
+      uip_packetqueue_pop(&input_queue);
+      if(netstack_process_ip_callback(NETSTACK_IP_INPUT, NULL) ==
+         NETSTACK_IP_PROCESS) {
+        packet_input();
+      }
+      uipbuf_clear();
+    }
+    if(uip_packetqueue_buflen(&input_queue) != 0) {
+      process_poll(&tcpip_process);
+    }
+    break;
+#endif /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
   };
 }
 /*---------------------------------------------------------------------------*/
@@ -451,10 +478,63 @@ tcpip_input(void)
   uipbuf_clear();
 }
 /*---------------------------------------------------------------------------*/
+void
+tcpip_input_enqueue(void)
+{
+#if UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0
+  struct uip_packetqueue_packet *p;
+
+  if(uip_len > 0 &&
+     uip_packetqueue_count(&input_queue) < UIP_CONF_IPV6_INPUT_QUEUE_LEN &&
+     (p = uip_packetqueue_alloc(&input_queue, 0)) != NULL) {
+    memcpy(p->queue_buf, UIP_IP_BUF, uip_len);
+    p->queue_buf_len = uip_len;
+    process_poll(&tcpip_process);
+    uipbuf_clear();
+    return;
+  }
+  if(uip_len > 0) {
+    /* Processing the packet at once would pass it ahead of the queued
+       ones */
+    LOG_WARN("input: queue full, dropping packet\n");
+    input_queue_drops++;
+    UIP_STAT(++uip_stat.ip.drop);
+    uipbuf_clear();
+    return;
+  }
+#endif /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+int
+tcpip_input_queue_space(void)
+{
+#if UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0
+  return UIP_CONF_IPV6_INPUT_QUEUE_LEN - uip_packetqueue_count(&input_queue);
+#else /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
+  return 1;
+#endif /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tcpip_input_queue_drops(void)
+{
+#if UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0
+  return input_queue_drops;
+#else /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
+  return 0;
+#endif /* UIP_CONF_IPV6_INPUT_QUEUE_LEN > 0 */
+}
+/*---------------------------------------------------------------------------*/
 static void
 output_fallback(void)
 {
 #ifdef UIP_FALLBACK_INTERFACE
+  if(uipbuf_is_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT)) {
+    /* The fallback interface needs the whole packet */
+    LOG_INFO("fallback: not forwarding a first fragment\n");
+    return;
+  }
   uip_last_proto = *((uint8_t *)UIP_IP_BUF + 40);
   LOG_INFO("fallback: removing ext hdrs & setting proto %d %d\n",
          uip_ext_len, uip_last_proto);
@@ -561,11 +641,19 @@ queue_packet(uip_ds6_nbr_t *nbr)
 {
   /* Copy outgoing pkt in the queuing buffer for later transmit. */
 #if UIP_CONF_IPV6_QUEUE_PKT
-  if(uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-    memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF, uip_len);
-    uip_packetqueue_set_buflen(&nbr->packethandle, uip_len);
+  struct uip_packetqueue_packet *p;
+
+  if(uipbuf_is_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT)) {
+    /* Cannot be sent later, once the rest of the packet has moved on */
+    return 1;
+  }
+  if(uip_packetqueue_count(&nbr->packethandle) < UIP_CONF_IPV6_QUEUE_PKT_PER_NBR &&
+     (p = uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME)) != NULL) {
+    memcpy(p->queue_buf, UIP_IP_BUF, uip_len);
+    p->queue_buf_len = uip_len;
     return 0;
   }
+  LOG_WARN("output: no room to queue packet for neighbor\n");
 #endif
 
   return 1;
@@ -582,10 +670,10 @@ send_queued(uip_ds6_nbr_t *nbr)
    * NA after sendiong a NS, you receive a NS with SLLAO: the entry moves
    * to STALE, and you must both send a NA and the queued packet.
    */
-  if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
+  while(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_pop(&nbr->packethandle);
     tcpip_output(uip_ds6_nbr_get_ll(nbr));
   }
 #endif /*UIP_CONF_IPV6_QUEUE_PKT*/
@@ -810,6 +898,10 @@ PROCESS_THREAD(tcpip_process, ev, data)
 {
   PROCESS_BEGIN();
 
+  /* Deliver events posted to the IP stack (etimer expirations,
+     TCP_POLL and UDP_POLL) ahead of queued application events */
+  process_set_prio(&tcpip_process, PROCESS_PRIO_HIGH);
+
 #if UIP_TCP
   memset(s.listenports, 0, UIP_LISTENPORTS*sizeof(*(s.listenports)));
   s.p = PROCESS_CURRENT();
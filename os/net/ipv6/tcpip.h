@@ -336,6 +336,38 @@ extern process_event_t tcpip_event;
  */
 void tcpip_input(void);
 
+/**
+ * \brief      Queue an incoming packet for the TCP/IP stack
+ *
+ *             Like tcpip_input(), but the packet in uip_buf is copied
+ *             to a queue of UIP_CONF_IPV6_INPUT_QUEUE_LEN packets and
+ *             processed later by the TCP/IP process. This lets drivers
+ *             that receive bursts of packets take them in without
+ *             waiting for each to be processed. When the queue is
+ *             full, the packet is dropped, so that packets are always
+ *             processed in the order they arrived. When the queue is
+ *             disabled, the packet is processed at once.
+ */
+void tcpip_input_enqueue(void);
+
+/**
+ * \brief      Get the room left in the input queue
+ * \return     The number of packets tcpip_input_enqueue() can still
+ *             queue. Without an input queue, packets are processed at
+ *             once and this is always 1.
+ *
+ *             Drivers that read several packets per wakeup can stop
+ *             reading when the queue is full, rather than have the
+ *             packets dropped.
+ */
+int tcpip_input_queue_space(void);
+
+/**
+ * \brief      Get the number of packets dropped by tcpip_input_enqueue()
+ *             because the input queue was full
+ */
+uint32_t tcpip_input_queue_drops(void);
+
 /**
  * \brief Output packet to layer 2
  * The eventual parameter is the MAC address of the destination.
@@ -44,6 +44,7 @@
 
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/addr-hash.h"
 #include "net/nbr-table.h"
 
 /* Log configuration */
@@ -91,6 +92,28 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_HASH_INDEX
+/* Routes are indexed in a hash table, keyed by their prefix and prefix
+   length. A lookup probes the table once for each prefix length in
+   use, from the longest to the shortest. Each slot holds a route index
+   plus one, or zero if empty. */
+#define ROUTE_HASH_SIZE ADDR_HASH_SIZE_AT_LEAST(2 * UIP_DS6_ROUTE_NB)
+
+#if UIP_DS6_ROUTE_NB > 8191
+#error "UIP_DS6_ROUTE_HASH_INDEX supports up to 8191 routes"
+#elif UIP_DS6_ROUTE_NB < 255
+typedef uint8_t route_slot_t;
+#else
+typedef uint16_t route_slot_t;
+#endif
+
+static unsigned route_home(unsigned entry);
+ADDR_HASH(route_hash, ROUTE_HASH_SIZE, route_slot_t, route_home);
+/* Number of routes per prefix length, and a bitmap of the lengths in use */
+static route_slot_t length_count[129];
+static uint32_t length_map[(129 + 31) / 32];
+#endif /* UIP_DS6_ROUTE_HASH_INDEX */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -174,6 +197,11 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_HASH_INDEX
+  addr_hash_clear(&route_hash);
+  memset(length_count, 0, sizeof(length_count));
+  memset(length_map, 0, sizeof(length_map));
+#endif /* UIP_DS6_ROUTE_HASH_INDEX */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -261,23 +289,123 @@ uip_ds6_route_num_routes(void)
   return 0;
 #endif /* (UIP_MAX_ROUTES != 0) */
 }
+#if (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_HASH_INDEX
+/*---------------------------------------------------------------------------*/
+static route_slot_t
+route_index(const uip_ds6_route_t *r)
+{
+  return r - (uip_ds6_route_t *)routememb.mem;
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_from_entry(unsigned entry)
+{
+  return (uip_ds6_route_t *)routememb.mem + entry - 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the home slot of a prefix. Only whole bytes of the prefix are
+   hashed, as uip_ipaddr_prefixcmp() only compares whole bytes. */
+static unsigned
+prefix_slot(const uip_ipaddr_t *addr, uint8_t length)
+{
+  uint32_t hash = addr_hash_fnv1a(ADDR_HASH_FNV1A_INIT ^ length,
+                                  addr, length >> 3);
+
+  return addr_hash_fold(hash, route_hash.mask);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+route_home(unsigned entry)
+{
+  uip_ds6_route_t *r = route_from_entry(entry);
+
+  return prefix_slot(&r->ipaddr, r->length);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+highest_bit(uint32_t word)
+{
+#ifdef __GNUC__
+  return sizeof(unsigned long) * 8 - 1 - __builtin_clzl(word);
+#else
+  unsigned bit;
+
+  for(bit = 31; !(word & ((uint32_t)1 << bit)); bit--);
+  return bit;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(uip_ds6_route_t *r)
+{
+  addr_hash_insert(&route_hash, prefix_slot(&r->ipaddr, r->length),
+                   route_index(r) + 1);
+
+  if(length_count[r->length]++ == 0) {
+    length_map[r->length / 32] |= (uint32_t)1 << (r->length % 32);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_rm(uip_ds6_route_t *r)
+{
+  if(addr_hash_remove(&route_hash, prefix_slot(&r->ipaddr, r->length),
+                      route_index(r) + 1) &&
+     --length_count[r->length] == 0) {
+    length_map[r->length / 32] &= ~((uint32_t)1 << (r->length % 32));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+index_lookup(const uip_ipaddr_t *addr)
+{
+  int word;
+  uint32_t lengths;
+  uint8_t length;
+  unsigned slot;
+  unsigned entry;
+  uip_ds6_route_t *r;
+
+  for(word = sizeof(length_map) / sizeof(length_map[0]) - 1; word >= 0; word--) {
+    for(lengths = length_map[word]; lengths != 0;
+        lengths &= ~((uint32_t)1 << (length % 32))) {
+      length = word * 32 + highest_bit(lengths);
+      for(slot = prefix_slot(addr, length);
+          (entry = addr_hash_get(&route_hash, slot)) != 0;
+          slot = addr_hash_next(&route_hash, slot)) {
+        r = route_from_entry(entry);
+        if(r->length == length &&
+           uip_ipaddr_prefixcmp(addr, &r->ipaddr, length)) {
+          return r;
+        }
+      }
+    }
+  }
+  return NULL;
+}
+#endif /* (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_HASH_INDEX */
 /*---------------------------------------------------------------------------*/
 uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_HASH_INDEX
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_HASH_INDEX */
 
-  LOG_INFO("Looking up route for ");
-  LOG_INFO_6ADDR(addr);
-  LOG_INFO_("\n");
+  LOG_DBG("Looking up route for ");
+  LOG_DBG_6ADDR(addr);
+  LOG_DBG_("\n");
 
   if(addr == NULL) {
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_HASH_INDEX
+  found_route = index_lookup(addr);
+#else /* UIP_DS6_ROUTE_HASH_INDEX */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -293,17 +421,24 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_HASH_INDEX */
 
-  if(found_route != NULL) {
-    LOG_INFO("Found route: ");
-    LOG_INFO_6ADDR(addr);
-    LOG_INFO_(" via ");
-    LOG_INFO_6ADDR(uip_ds6_route_nexthop(found_route));
-    LOG_INFO_("\n");
-  } else {
-    LOG_WARN("No route found\n");
+  if(LOG_DBG_ENABLED) {
+    if(found_route != NULL) {
+      LOG_DBG("Found route: ");
+      LOG_DBG_6ADDR(addr);
+      LOG_DBG_(" via ");
+      LOG_DBG_6ADDR(uip_ds6_route_nexthop(found_route));
+      LOG_DBG_("\n");
+    } else {
+      LOG_DBG("No route found\n");
+    }
   }
 
+#if !UIP_DS6_ROUTE_HASH_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the hash index, the list order only matters for the removal
+     of the least recently used route. Otherwise, the linear list
+     update below is skipped. */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -313,6 +448,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_HASH_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -455,6 +591,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_HASH_INDEX
+  index_add(r);
+#endif /* UIP_DS6_ROUTE_HASH_INDEX */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -500,6 +639,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_HASH_INDEX
+    index_rm(route);
+#endif /* UIP_DS6_ROUTE_HASH_INDEX */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -111,6 +111,15 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/** \brief Index the routes in a hash table per prefix length, so that
+ *  uip_ds6_route_lookup() does not scan the whole routing table. Meant
+ *  for storing-mode roots and routers with many routes. */
+#ifdef UIP_DS6_ROUTE_CONF_HASH_INDEX
+#define UIP_DS6_ROUTE_HASH_INDEX UIP_DS6_ROUTE_CONF_HASH_INDEX
+#else /* UIP_DS6_ROUTE_CONF_HASH_INDEX */
+#define UIP_DS6_ROUTE_HASH_INDEX 0
+#endif /* UIP_DS6_ROUTE_CONF_HASH_INDEX */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -175,6 +175,11 @@ uip_icmp6_error_output(uint8_t type, uint8_t code, uint32_t param)
     LOG_WARN("Unable to remove ext header before sending ICMPv6 ERROR message\n");
   }
 
+  /* The error is a packet of its own, even if the invoking packet is
+     only the first fragment of one that 6LoWPAN forwards fragment by
+     fragment */
+  uipbuf_clr_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT);
+
   /* remember data of original packet before shifting */
   uip_ipaddr_copy(&tmp_ipaddr, &UIP_IP_BUF->destipaddr);
 
@@ -75,6 +75,9 @@
 #include "net/ipv6/uip-ds6.h"
 #include "net/ipv6/uip-nameserver.h"
 #include "lib/random.h"
+#if UIP_ND6_RA_6CO
+#include "net/ipv6/sicslowpan.h"
+#endif /* UIP_ND6_RA_6CO */
 
 /* Log configuration */
 #include "sys/log.h"
@@ -98,6 +101,7 @@
 #define ND6_OPT_PREFIX_BUF(opt)    ((uip_nd6_opt_prefix_info *)ND6_OPT(opt))
 #define ND6_OPT_MTU_BUF(opt)               ((uip_nd6_opt_mtu *)ND6_OPT(opt))
 #define ND6_OPT_RDNSS_BUF(opt)             ((uip_nd6_opt_dns *)ND6_OPT(opt))
+#define ND6_OPT_6CO_BUF(opt)               ((uip_nd6_opt_6co *)ND6_OPT(opt))
 /** @} */
 
 #if UIP_ND6_SEND_NS || UIP_ND6_SEND_NA || UIP_ND6_SEND_RA || !UIP_CONF_ROUTER
@@ -585,7 +589,7 @@ na_input(void)
   if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_pop(&nbr->packethandle);
     return;
   }
 
@@ -784,6 +788,32 @@ uip_nd6_ra_output(uip_ipaddr_t * dest)
   }
 #endif /* UIP_ND6_RA_RDNSS */
 
+#if UIP_ND6_RA_6CO
+  {
+    uint8_t cid;
+    const struct sicslowpan_addr_context *c;
+    unsigned long lifetime;
+    for(cid = 0; cid <= UIP_ND6_6CO_CID_MASK; cid++) {
+      if((c = sicslowpan_addr_context_get(cid)) == NULL || !c->compress) {
+        continue;
+      }
+      lifetime = c->isinfinite ? 0xffff :
+        (stimer_remaining((struct stimer *)&c->lifetime) + 59) / 60;
+      ND6_OPT_6CO_BUF(nd6_opt_offset)->type = UIP_ND6_OPT_6CO;
+      ND6_OPT_6CO_BUF(nd6_opt_offset)->len = UIP_ND6_OPT_6CO_LEN >> 3;
+      ND6_OPT_6CO_BUF(nd6_opt_offset)->context_len = 64;
+      ND6_OPT_6CO_BUF(nd6_opt_offset)->flag_cid = UIP_ND6_6CO_FLAG_C | cid;
+      ND6_OPT_6CO_BUF(nd6_opt_offset)->reserved = 0;
+      ND6_OPT_6CO_BUF(nd6_opt_offset)->lifetime =
+        uip_htons(lifetime > 0xffff ? 0xffff : (uint16_t)lifetime);
+      memcpy(ND6_OPT_6CO_BUF(nd6_opt_offset)->prefix, c->prefix,
+             sizeof(c->prefix));
+      uip_len += UIP_ND6_OPT_6CO_LEN;
+      nd6_opt_offset += UIP_ND6_OPT_6CO_LEN;
+    }
+  }
+#endif /* UIP_ND6_RA_6CO */
+
   uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
 
   /*ICMP checksum */
@@ -1031,6 +1061,40 @@ ra_input(void)
       }
       break;
 #endif /* UIP_ND6_RA_RDNSS */
+#if UIP_ND6_RA_6CO
+    case UIP_ND6_OPT_6CO:
+      {
+        uip_nd6_opt_6co *co = ND6_OPT_6CO_BUF(nd6_opt_offset);
+        uint8_t cid = co->flag_cid & UIP_ND6_6CO_CID_MASK;
+        uint16_t lifetime = uip_ntohs(co->lifetime);
+        uip_ipaddr_t ctx_prefix;
+
+        LOG_DBG("Processing 6CO option, context %u lifetime %u min\n",
+                cid, lifetime);
+        if(lifetime == 0) {
+          sicslowpan_addr_context_rm(cid);
+          break;
+        }
+        if(co->len < 2 || co->context_len == 0) {
+          LOG_WARN("Invalid 6CO option\n");
+          break;
+        }
+        /* Only the first 64 bits of a context are used; clear the bits
+           beyond a shorter context length */
+        memset(&ctx_prefix, 0, sizeof(ctx_prefix));
+        memcpy(ctx_prefix.u8, co->prefix, sizeof(co->prefix));
+        if(co->context_len < 64) {
+          uint8_t i;
+          for(i = co->context_len; i < 64; i++) {
+            ctx_prefix.u8[i >> 3] &= ~(0x80 >> (i & 7));
+          }
+        }
+        sicslowpan_addr_context_set(cid, &ctx_prefix,
+                                    (co->flag_cid & UIP_ND6_6CO_FLAG_C) != 0,
+                                    (unsigned long)lifetime * 60);
+      }
+      break;
+#endif /* UIP_ND6_RA_6CO */
     default:
       LOG_ERR("ND option not supported in RA\n");
       break;
@@ -1069,7 +1133,7 @@ ra_input(void)
   if(nbr != NULL && uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_pop(&nbr->packethandle);
     return;
   }
 
@@ -6,8 +6,7 @@
 
 #include "net/ipv6/uip-packetqueue.h"
 
-#define MAX_NUM_QUEUED_PACKETS 2
-MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
+MEMB(packets_memb, struct uip_packetqueue_packet, UIP_CONF_PACKETQUEUE_NUM_PACKETS);
 
 #define DEBUG 0
 #if DEBUG
@@ -17,15 +16,30 @@ MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static void
+packet_remove(struct uip_packetqueue_handle *handle,
+              struct uip_packetqueue_packet *p)
+{
+  struct uip_packetqueue_packet **pp;
+
+  for(pp = &handle->packet; *pp != NULL; pp = &(*pp)->next) {
+    if(*pp == p) {
+      *pp = p->next;
+      break;
+    }
+  }
+  ctimer_stop(&p->lifetimer);
+  memb_free(&packets_memb, p);
+}
 /*---------------------------------------------------------------------------*/
 static void
 packet_timedout(void *ptr)
 {
-  struct uip_packetqueue_handle *h = ptr;
+  struct uip_packetqueue_packet *p = ptr;
 
-  PRINTF("uip_packetqueue_free timed out %p\n", h);
-  memb_free(&packets_memb, h->packet);
-  h->packet = NULL;
+  PRINTF("uip_packetqueue_free timed out %p\n", p->handle);
+  packet_remove(p->handle, p);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -38,30 +52,67 @@ uip_packetqueue_new(struct uip_packetqueue_handle *handle)
 struct uip_packetqueue_packet *
 uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime)
 {
+  struct uip_packetqueue_packet *p, **pp;
+
   PRINTF("uip_packetqueue_alloc %p\n", handle);
-  if(handle->packet != NULL) {
-    PRINTF("alloced\n");
+  p = memb_alloc(&packets_memb);
+  if(p == NULL) {
+    PRINTF("uip_packetqueue_alloc failed\n");
     return NULL;
   }
-  handle->packet = memb_alloc(&packets_memb);
-  if(handle->packet != NULL) {
-    ctimer_set(&handle->packet->lifetimer, lifetime,
-               packet_timedout, handle);
+  p->next = NULL;
+  p->queue_buf_len = 0;
+  p->handle = handle;
+  if(lifetime != 0) {
+    ctimer_set(&p->lifetimer, lifetime, packet_timedout, p);
   } else {
-    PRINTF("uip_packetqueue_alloc failed\n");
+    ctimer_stop(&p->lifetimer);
   }
-  return handle->packet;
+  for(pp = &handle->packet; *pp != NULL; pp = &(*pp)->next);
+  *pp = p;
+  return p;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle)
 {
   PRINTF("uip_packetqueue_free %p\n", handle);
+  while(handle->packet != NULL) {
+    packet_remove(handle, handle->packet);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_pop(struct uip_packetqueue_handle *handle)
+{
   if(handle->packet != NULL) {
-    ctimer_stop(&handle->packet->lifetimer);
-    memb_free(&packets_memb, handle->packet);
-    handle->packet = NULL;
+    packet_remove(handle, handle->packet);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_move(struct uip_packetqueue_handle *to,
+                     struct uip_packetqueue_handle *from)
+{
+  struct uip_packetqueue_packet *p;
+
+  to->packet = from->packet;
+  from->packet = NULL;
+  for(p = to->packet; p != NULL; p = p->next) {
+    p->handle = to;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_packetqueue_count(struct uip_packetqueue_handle *handle)
+{
+  struct uip_packetqueue_packet *p;
+  int n = 0;
+
+  for(p = handle->packet; p != NULL; p = p->next) {
+    n++;
   }
+  return n;
 }
 /*---------------------------------------------------------------------------*/
 uint8_t *
@@ -6,27 +6,42 @@
 struct uip_packetqueue_handle;
 
 struct uip_packetqueue_packet {
-  struct uip_ds6_queued_packet *next;
+  struct uip_packetqueue_packet *next;
   uint8_t queue_buf[UIP_BUFSIZE];
   uint16_t queue_buf_len;
   struct ctimer lifetimer;
   struct uip_packetqueue_handle *handle;
 };
 
+/* A FIFO queue of packets, with buffers from a shared pool of
+   UIP_CONF_PACKETQUEUE_NUM_PACKETS */
 struct uip_packetqueue_handle {
   struct uip_packetqueue_packet *packet;
 };
 
 void uip_packetqueue_new(struct uip_packetqueue_handle *handle);
 
-
+/* Appends a packet to the queue, to be freed after lifetime unless
+   it is zero. Returns NULL if the pool is empty. */
 struct uip_packetqueue_packet *
 uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime);
 
-
+/* Frees all packets of the queue */
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle);
 
+/* Frees the first packet of the queue */
+void
+uip_packetqueue_pop(struct uip_packetqueue_handle *handle);
+
+/* Moves the packets of a queue to another, empty, queue */
+void
+uip_packetqueue_move(struct uip_packetqueue_handle *to,
+                     struct uip_packetqueue_handle *from);
+
+int uip_packetqueue_count(struct uip_packetqueue_handle *handle);
+
+/* The first packet of the queue */
 uint8_t *uip_packetqueue_buf(struct uip_packetqueue_handle *h);
 uint16_t uip_packetqueue_buflen(struct uip_packetqueue_handle *h);
 void uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len);
@@ -45,6 +45,7 @@
 #include "net/routing/routing.h"
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/addr-hash.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -58,6 +59,30 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+/* Incremented whenever a node is added or removed, or changes parent */
+static uint32_t generation;
+
+/* The last path returned by uip_sr_get_path() */
+static uip_sr_path_t cached_path;
+static uint32_t cached_path_generation;
+
+#if UIP_SR_HASH_INDEX
+/* Hash index over the graph and link identifier of the nodes. Each slot
+ * holds a node index plus one, or zero if empty. */
+#define HASH_SIZE ADDR_HASH_SIZE_AT_LEAST(2 * UIP_SR_LINK_NUM)
+
+#if UIP_SR_LINK_NUM > 8191
+#error "UIP_SR_HASH_INDEX supports up to 8191 nodes"
+#elif UIP_SR_LINK_NUM < 255
+typedef uint8_t hash_slot_t;
+#else
+typedef uint16_t hash_slot_t;
+#endif
+
+static unsigned hash_home(unsigned entry);
+ADDR_HASH(hash_index, HASH_SIZE, hash_slot_t, hash_home);
+#endif /* UIP_SR_HASH_INDEX */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -65,11 +90,20 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+uint32_t
+uip_sr_generation(void)
+{
+  return generation;
+}
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t *addr)
 {
   if(node == NULL || addr == NULL || graph != node->graph) {
     return 0;
+  } else if(memcmp(node->link_identifier, &addr->u8[8], 8) != 0) {
+    /* Only the prefix is provided by the routing protocol */
+    return 0;
   } else {
     uip_ipaddr_t node_ipaddr;
     NETSTACK_ROUTING.get_sr_node_ipaddr(&node_ipaddr, node);
@@ -77,30 +111,103 @@ node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_HASH_INDEX
+static uip_sr_node_t *
+node_from_entry(unsigned entry)
+{
+  return (uip_sr_node_t *)nodememb.mem + entry - 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the home slot of a graph and link identifier in the hash index */
+static unsigned
+hash_slot(const void *graph, const unsigned char *link_identifier)
+{
+  uint32_t seed = ADDR_HASH_FNV1A_INIT ^ (uint32_t)(uintptr_t)graph;
+  uint32_t hash = addr_hash_fnv1a(seed, link_identifier, 8);
+
+  return addr_hash_fold(hash, hash_index.mask);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+hash_home(unsigned entry)
+{
+  uip_sr_node_t *node = node_from_entry(entry);
+
+  return hash_slot(node->graph, node->link_identifier);
+}
+/*---------------------------------------------------------------------------*/
+/* Add a node to the hash index */
+static void
+hash_insert(uip_sr_node_t *node)
+{
+  addr_hash_insert(&hash_index, hash_slot(node->graph, node->link_identifier),
+                   node - (uip_sr_node_t *)nodememb.mem + 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a node from the hash index */
+static void
+hash_remove(uip_sr_node_t *node)
+{
+  addr_hash_remove(&hash_index, hash_slot(node->graph, node->link_identifier),
+                   node - (uip_sr_node_t *)nodememb.mem + 1);
+}
+#endif /* UIP_SR_HASH_INDEX */
+/*---------------------------------------------------------------------------*/
+static void
+remove_node(uip_sr_node_t *node)
+{
+#if UIP_SR_HASH_INDEX
+  hash_remove(node);
+#endif /* UIP_SR_HASH_INDEX */
+  list_remove(nodelist, node);
+  memb_free(&nodememb, node);
+  num_nodes--;
+  generation++;
+}
+/*---------------------------------------------------------------------------*/
 uip_sr_node_t *
 uip_sr_get_node(void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_HASH_INDEX
+  unsigned slot;
+  unsigned entry;
+
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(slot = hash_slot(graph, &addr->u8[8]);
+      (entry = addr_hash_get(&hash_index, slot)) != 0;
+      slot = addr_hash_next(&hash_index, slot)) {
+    l = node_from_entry(entry);
+    if(node_matches_address(graph, l, addr)) {
+      return l;
+    }
+  }
+#else /* UIP_SR_HASH_INDEX */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
     }
   }
+#endif /* UIP_SR_HASH_INDEX */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
-int
-uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr)
+static uip_sr_node_t *
+get_root_node(void *graph)
 {
-  int max_depth = UIP_SR_LINK_NUM;
   uip_ipaddr_t root_ipaddr;
-  uip_sr_node_t *node;
-  uip_sr_node_t *root_node;
 
   NETSTACK_ROUTING.get_root_ipaddr(&root_ipaddr);
-  node = uip_sr_get_node(graph, addr);
-  root_node = uip_sr_get_node(graph, &root_ipaddr);
+  return uip_sr_get_node(graph, &root_ipaddr);
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_node_reachable(uip_sr_node_t *node, const uip_sr_node_t *root_node)
+{
+  int max_depth = UIP_SR_LINK_NUM;
 
   while(node != NULL && node != root_node && max_depth > 0) {
     node = node->parent;
@@ -109,6 +216,61 @@ uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr)
   return node != NULL && node == root_node;
 }
 /*---------------------------------------------------------------------------*/
+int
+uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr)
+{
+  return is_node_reachable(uip_sr_get_node(graph, addr), get_root_node(graph));
+}
+/*---------------------------------------------------------------------------*/
+/* Count the number of leading bytes two addresses have in common */
+static uint8_t
+count_common_bytes(const uip_ipaddr_t *a, const uip_ipaddr_t *b)
+{
+  uint8_t i;
+
+  for(i = 0; i < 16 && a->u8[i] == b->u8[i]; i++);
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+const uip_sr_path_t *
+uip_sr_get_path(void *graph, const uip_ipaddr_t *addr)
+{
+  uip_sr_node_t *dest_node;
+  uip_sr_node_t *root_node;
+  uip_sr_node_t *node;
+  uip_ipaddr_t node_addr;
+  uint8_t common_bytes;
+
+  if(cached_path.node != NULL && cached_path_generation == generation
+     && node_matches_address(graph, cached_path.node, addr)) {
+    return &cached_path;
+  }
+
+  cached_path.node = NULL;
+  dest_node = uip_sr_get_node(graph, addr);
+  root_node = get_root_node(graph);
+  if(dest_node == root_node || !is_node_reachable(dest_node, root_node)) {
+    return NULL;
+  }
+
+  cached_path.first_hop = dest_node;
+  cached_path.len = 0;
+  cached_path.common_bytes = 15;
+  for(node = dest_node->parent; node != root_node; node = node->parent) {
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+    common_bytes = count_common_bytes(&node_addr, addr);
+    if(common_bytes < cached_path.common_bytes) {
+      cached_path.common_bytes = common_bytes;
+    }
+    cached_path.first_hop = node;
+    cached_path.len++;
+  }
+
+  cached_path.node = dest_node;
+  cached_path_generation = generation;
+  return &cached_path;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_sr_expire_parent(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *parent)
 {
@@ -125,6 +287,7 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
   uip_sr_node_t *child_node = uip_sr_get_node(graph, child);
   uip_sr_node_t *parent_node = uip_sr_get_node(graph, parent);
   uip_sr_node_t *old_parent_node;
+  uip_sr_node_t *root_node;
 
   if(parent != NULL) {
     /* No node for the parent, add one with infinite lifetime */
@@ -148,22 +311,27 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
       return NULL;
     }
     child_node->parent = NULL;
+    child_node->graph = graph;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
     list_add(nodelist, child_node);
+#if UIP_SR_HASH_INDEX
+    hash_insert(child_node);
+#endif /* UIP_SR_HASH_INDEX */
     num_nodes++;
+    generation++;
   }
 
   /* Initialize node */
-  child_node->graph = graph;
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+  old_parent_node = child_node->parent;
+  root_node = get_root_node(graph);
 
   /* Is the node reachable before the update? */
-  if(uip_sr_is_addr_reachable(graph, child)) {
-    old_parent_node = child_node->parent;
+  if(is_node_reachable(child_node, root_node)) {
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
-    if(!uip_sr_is_addr_reachable(graph, child)) {
+    if(!is_node_reachable(child_node, root_node)) {
       /* The new parent makes the node unreachable, restore old parent.
        * We will take the update next time, with chances we know more of
        * the topology and the loop is gone. */
@@ -173,6 +341,10 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
     child_node->parent = parent_node;
   }
 
+  if(child_node->parent != old_parent_node) {
+    generation++;
+  }
+
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
   LOG_INFO_(", parent ");
@@ -188,6 +360,10 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_HASH_INDEX
+  addr_hash_clear(&hash_index);
+#endif /* UIP_SR_HASH_INDEX */
+  generation++;
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -226,9 +402,7 @@ uip_sr_periodic(unsigned seconds)
         LOG_INFO_("\n");
       }
       /* No child found, deallocate node */
-      list_remove(nodelist, l);
-      memb_free(&nodememb, l);
-      num_nodes--;
+      remove_node(l);
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
     }
@@ -242,9 +416,7 @@ uip_sr_free_all(void)
   uip_sr_node_t *next;
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
-    list_remove(nodelist, l);
-    memb_free(&nodememb, l);
-    num_nodes--;
+    remove_node(l);
   }
 }
 /*---------------------------------------------------------------------------*/
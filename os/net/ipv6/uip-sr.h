@@ -85,6 +85,15 @@
 
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
+/* Keep a hash index of the nodes, keyed by graph and link identifier, for
+ * constant-time lookups at roots of large networks. Costs 2 to 4 bytes of
+ * RAM per node. */
+#ifdef UIP_SR_CONF_HASH_INDEX
+#define UIP_SR_HASH_INDEX UIP_SR_CONF_HASH_INDEX
+#else /* UIP_SR_CONF_HASH_INDEX */
+#define UIP_SR_HASH_INDEX 0
+#endif /* UIP_SR_CONF_HASH_INDEX */
+
 /********** Data Structures  **********/
 
 /** \brief A node in a source routing graph, stored at the root and representing
@@ -100,6 +109,22 @@ typedef struct uip_sr_node {
   struct uip_sr_node *parent;
 } uip_sr_node_t;
 
+/** \brief A path from the root down to a node of a source routing graph */
+typedef struct uip_sr_path {
+  /* The destination node */
+  uip_sr_node_t *node;
+  /* The first hop from the root, i.e. the node of the path whose parent
+  is the root. Equal to node for direct children of the root. */
+  uip_sr_node_t *first_hop;
+  /* The number of nodes between the root and the destination, excluding
+  both */
+  uint16_t len;
+  /* The number of leading bytes that the addresses of the nodes between
+  the root and the destination have in common with the destination
+  address, at most 15 */
+  uint8_t common_bytes;
+} uip_sr_path_t;
+
 /********** Public functions **********/
 
 /**
@@ -109,6 +134,15 @@ typedef struct uip_sr_node {
 */
 int uip_sr_num_nodes(void);
 
+/**
+ * Tells the generation of the graph, which changes whenever a node is
+ * added or removed, or changes parent. Used to invalidate state derived
+ * from the graph, such as cached source routes.
+ *
+ * \return The generation of the graph
+*/
+uint32_t uip_sr_generation(void);
+
 /**
  * Expires a given child-parent link
  *
@@ -162,6 +196,18 @@ uip_sr_node_t *uip_sr_get_node(void *graph, const uip_ipaddr_t *addr);
 */
 int uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr);
 
+/**
+ * Gets the path from the root to a node. The last path is cached until
+ * the source routing graph changes, so that successive packets to the
+ * same destination do not walk the graph again.
+ *
+ * \param graph The graph where to look up for the node
+ * \param addr The target IPv6 global address
+ * \return A pointer to the path, valid until the next call, or NULL if
+ * the node is unknown or not reachable
+*/
+const uip_sr_path_t *uip_sr_get_path(void *graph, const uip_ipaddr_t *addr);
+
 /**
  * A function called periodically. Used to age the links (decrease lifetime
  * and expire links accordingly)
@@ -80,6 +80,7 @@
 #include "net/ipv6/uip-ds6.h"
 #include "net/ipv6/multicast/uip-mcast6.h"
 #include "net/routing/routing.h"
+#include "lib/ip-chksum.h"
 
 #if UIP_ND6_SEND_NS
 #include "net/ipv6/uip-ds6-nbr.h"
@@ -278,41 +279,10 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
-static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
-{
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
-}
-/*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
 {
-  return uip_htons(chksum(0, (uint8_t *)data, len));
+  return uip_htons(IP_CHKSUM(0, (uint8_t *)data, len));
 }
 /*---------------------------------------------------------------------------*/
 #ifndef UIP_ARCH_IPCHKSUM
@@ -321,7 +291,7 @@ uip_ipchksum(void)
 {
   uint16_t sum;
 
-  sum = chksum(0, uip_buf, UIP_IPH_LEN);
+  sum = IP_CHKSUM(0, uip_buf, UIP_IPH_LEN);
   LOG_DBG("uip_ipchksum: sum 0x%04x\n", sum);
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -351,10 +321,10 @@ upper_layer_chksum(uint8_t proto)
   /* IP protocol and length fields. This addition cannot carry. */
   sum = upper_layer_len + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
+  sum = IP_CHKSUM(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
   /* Sum upper-layer header and data. */
-  sum = chksum(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
+  sum = IP_CHKSUM(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -1139,22 +1109,33 @@ uip_process(uint8_t flag)
    * If the size of uip_len is larger than the size reported in the IP
    * packet header, the packet has been padded, and we set uip_len to
    * the correct value.
+   *
+   * The first fragment of a packet that 6LoWPAN forwards fragment by
+   * fragment is shorter by design; it is only routed, never delivered.
    */
-  if(uip_len < uipbuf_get_len_field(UIP_IP_BUF)) {
-    UIP_STAT(++uip_stat.ip.drop);
-    LOG_ERR("packet shorter than reported in IP header\n");
-    goto drop;
-  }
+  if(uipbuf_is_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT)) {
+    if(uip_len > uipbuf_get_len_field(UIP_IP_BUF) + UIP_IPH_LEN) {
+      UIP_STAT(++uip_stat.ip.drop);
+      LOG_ERR("first fragment longer than reported in IP header\n");
+      goto drop;
+    }
+  } else {
+    if(uip_len < uipbuf_get_len_field(UIP_IP_BUF)) {
+      UIP_STAT(++uip_stat.ip.drop);
+      LOG_ERR("packet shorter than reported in IP header\n");
+      goto drop;
+    }
 
-  /*
-   * The length reported in the IPv6 header is the length of the
-   * payload that follows the header. However, uIP uses the uip_len
-   * variable for holding the size of the entire packet, including the
-   * IP header. For IPv4 this is not a problem as the length field in
-   * the IPv4 header contains the length of the entire packet. But for
-   * IPv6 we need to add the size of the IPv6 header (40 bytes).
-   */
-  uip_len = uipbuf_get_len_field(UIP_IP_BUF) + UIP_IPH_LEN;
+    /*
+     * The length reported in the IPv6 header is the length of the
+     * payload that follows the header. However, uIP uses the uip_len
+     * variable for holding the size of the entire packet, including the
+     * IP header. For IPv4 this is not a problem as the length field in
+     * the IPv4 header contains the length of the entire packet. But for
+     * IPv6 we need to add the size of the IPv6 header (40 bytes).
+     */
+    uip_len = uipbuf_get_len_field(UIP_IP_BUF) + UIP_IPH_LEN;
+  }
 
   /* Check that the packet length is acceptable given our IP buffer size. */
   if(uip_len > sizeof(uip_buf)) {
@@ -1285,6 +1266,12 @@ uip_process(uint8_t flag)
   process:
 #endif /* UIP_IPV6_MULTICAST && UIP_CONF_ROUTER */
 
+  if(uipbuf_is_attr_flag(UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT)) {
+    LOG_ERR("Dropping first fragment, not forwarded\n");
+    UIP_STAT(++uip_stat.ip.drop);
+    goto drop;
+  }
+
   /* IPv6 extension header processing: loop until reaching upper-layer protocol */
   uip_ext_bitmap = 0;
   for(next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
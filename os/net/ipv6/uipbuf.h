@@ -186,6 +186,9 @@ void uipbuf_init(void);
 #define UIPBUF_ATTR_FLAGS_6LOWPAN_NO_NHC_COMPRESSION      0x01
 /* Avoid using prefix compression on the packet (6LoWPAN) */
 #define UIPBUF_ATTR_FLAGS_6LOWPAN_NO_PREFIX_COMPRESSION   0x02
+/* uip_buf holds only the first fragment of a packet that is forwarded
+   fragment by fragment (6LoWPAN). It may be routed, but not delivered */
+#define UIPBUF_ATTR_FLAGS_FIRST_FRAGMENT                  0x04
 
 /* MAC will set the default for this packet */
 #define UIPBUF_ATTR_LLSEC_LEVEL_MAC_DEFAULT               0xffff
@@ -232,6 +232,25 @@ void uip_log(char *msg);
 #define UIP_CONF_IPV6_QUEUE_PKT       0
 #endif
 
+#ifndef UIP_CONF_IPV6_QUEUE_PKT_PER_NBR
+/** How many packets each %neighbor can have queued during address
+    resolution (default: 1) */
+#define UIP_CONF_IPV6_QUEUE_PKT_PER_NBR 1
+#endif
+
+#ifndef UIP_CONF_IPV6_INPUT_QUEUE_LEN
+/** How many incoming packets tcpip_input_enqueue() holds until the
+    stack gets to them, dropping those that arrive when it is full
+    (default: 0, they are processed at once) */
+#define UIP_CONF_IPV6_INPUT_QUEUE_LEN 0
+#endif
+
+#ifndef UIP_CONF_PACKETQUEUE_NUM_PACKETS
+/** The number of packet buffers shared by the %neighbor and input
+    queues */
+#define UIP_CONF_PACKETQUEUE_NUM_PACKETS (2 + UIP_CONF_IPV6_INPUT_QUEUE_LEN)
+#endif
+
 #ifndef UIP_CONF_IPV6_CHECKS
 /** Do we do IPv6 consistency checks (highly recommended, default: yes) */
 #define UIP_CONF_IPV6_CHECKS          1
@@ -40,6 +40,7 @@
  */
 
 #include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
 #include "net/mac/csma/csma-security.h"
 #include "net/packetbuf.h"
 #include "net/queuebuf.h"
@@ -50,8 +51,11 @@
 #include "net/netstack.h"
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/addr-hash.h"
 #include "lib/assert.h"
 
+#include <string.h>
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "CSMA"
@@ -92,6 +96,9 @@ struct qbuf_metadata {
   mac_callback_t sent;
   void *cptr;
   uint8_t max_transmissions;
+#if CSMA_QUEUE_STATS || CSMA_AQM
+  clock_time_t enqueue_time;
+#endif /* CSMA_QUEUE_STATS || CSMA_AQM */
 };
 
 /* Every neighbor has its own packet queue */
@@ -101,6 +108,24 @@ struct neighbor_queue {
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions;
+  uint8_t depth;
+#if CSMA_BURST_MAX_FRAMES > 1
+  /* The number of frames already sent in the current burst */
+  uint8_t burst_frames;
+#endif /* CSMA_BURST_MAX_FRAMES > 1 */
+#if CSMA_QUEUE_STATS
+  uint16_t drops;
+  clock_time_t sojourn_max;
+#endif /* CSMA_QUEUE_STATS */
+#if CSMA_AQM
+  /* CoDel state, see RFC 8289 */
+  clock_time_t first_above_time;
+  clock_time_t drop_next;
+  uint8_t above_target;
+  uint8_t dropping;
+  uint16_t drop_count;
+  uint16_t last_drop_count;
+#endif /* CSMA_AQM */
   LIST_STRUCT(packet_queue);
 };
 
@@ -120,6 +145,14 @@ struct neighbor_queue {
 
 #define MAX_QUEUED_PACKETS QUEUEBUF_NUM
 
+/* With active queue management, the number of packets of the pool that a
+   single neighbor cannot take, so that other neighbors always find room */
+#ifdef CSMA_CONF_AQM_RESERVE
+#define CSMA_AQM_RESERVE CSMA_CONF_AQM_RESERVE
+#else /* CSMA_CONF_AQM_RESERVE */
+#define CSMA_AQM_RESERVE (MAX_QUEUED_PACKETS / 4)
+#endif /* CSMA_CONF_AQM_RESERVE */
+
 /* Neighbor packet queue */
 struct packet_queue {
   struct packet_queue *next;
@@ -131,16 +164,88 @@ MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
+/* The length of neighbor_list */
+static unsigned num_neighbors;
+
+#if CSMA_QUEUE_INDEX
+/* Hash index over the addresses of the neighbor queues. Each slot holds
+ * the position of the queue in neighbor_memb plus one, or zero if
+ * empty. */
+#define INDEX_SIZE ADDR_HASH_SIZE_AT_LEAST(2 * CSMA_MAX_NEIGHBOR_QUEUES)
+
+#if CSMA_MAX_NEIGHBOR_QUEUES > 127
+#error "CSMA_QUEUE_INDEX supports up to 127 neighbor queues"
+#endif
+
+static unsigned index_home(unsigned entry);
+ADDR_HASH(queue_index, INDEX_SIZE, uint8_t, index_home);
+#endif /* CSMA_QUEUE_INDEX */
+
+#if CSMA_BURST_MAX_FRAMES > 1
+/* Set when the queue whose packet was just sent continues its burst */
+static struct neighbor_queue *burst_next;
+#endif /* CSMA_BURST_MAX_FRAMES > 1 */
+
+#if CSMA_QUEUE_STATS
+static struct csma_queue_stats stats;
+#define STATS_ADD(x, n) stats.x += (n)
+#else /* CSMA_QUEUE_STATS */
+#define STATS_ADD(x, n)
+#endif /* CSMA_QUEUE_STATS */
 
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
     int status,
     int num_transmissions);
 static void transmit_from_queue(void *ptr);
+static void tx_done(int status, struct packet_queue *q,
+                    struct neighbor_queue *n);
+/*---------------------------------------------------------------------------*/
+#if CSMA_QUEUE_INDEX
+/* Get the home slot of a link-layer address in the index */
+static unsigned
+index_slot(const linkaddr_t *addr)
+{
+  uint32_t hash = addr_hash_fnv1a(ADDR_HASH_FNV1A_INIT, addr, LINKADDR_SIZE);
+
+  return addr_hash_fold(hash, queue_index.mask);
+}
+/*---------------------------------------------------------------------------*/
+static struct neighbor_queue *
+queue_from_entry(unsigned entry)
+{
+  return (struct neighbor_queue *)neighbor_memb.mem + entry - 1;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+index_home(unsigned entry)
+{
+  return index_slot(&queue_from_entry(entry)->addr);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+queue_entry(struct neighbor_queue *n)
+{
+  return n - (struct neighbor_queue *)neighbor_memb.mem + 1;
+}
+#endif /* CSMA_QUEUE_INDEX */
 /*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
+#if CSMA_QUEUE_INDEX
+  unsigned slot;
+  unsigned entry;
+
+  for(slot = index_slot(addr);
+      (entry = addr_hash_get(&queue_index, slot)) != 0;
+      slot = addr_hash_next(&queue_index, slot)) {
+    if(linkaddr_cmp(&queue_from_entry(entry)->addr, addr)) {
+      return queue_from_entry(entry);
+    }
+  }
+  return NULL;
+#else /* CSMA_QUEUE_INDEX */
   struct neighbor_queue *n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
@@ -149,8 +254,125 @@ neighbor_queue_from_addr(const linkaddr_t *addr)
     n = list_item_next(n);
   }
   return NULL;
+#endif /* CSMA_QUEUE_INDEX */
 }
 /*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_free(struct neighbor_queue *n)
+{
+#if CSMA_QUEUE_INDEX
+  addr_hash_remove(&queue_index, index_slot(&n->addr), queue_entry(n));
+#endif /* CSMA_QUEUE_INDEX */
+  list_remove(neighbor_list, n);
+  num_neighbors--;
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_AQM
+/* Whether clock time t has been reached, robust to wrap-around */
+static int
+time_reached(clock_time_t now, clock_time_t t)
+{
+  return (clock_time_t)(now - t) < (((clock_time_t)~0) >> 1);
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+isqrt(uint32_t x)
+{
+  uint32_t r = 0;
+  uint32_t b = 1UL << 30;
+
+  while(b > x) {
+    b >>= 2;
+  }
+  while(b != 0) {
+    if(x >= r + b) {
+      x -= r + b;
+      r = (r >> 1) + b;
+    } else {
+      r >>= 1;
+    }
+    b >>= 2;
+  }
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+/* The CoDel control law: drops get closer as sqrt(count) grows */
+static clock_time_t
+control_law(clock_time_t t, uint16_t count)
+{
+  return t + CSMA_AQM_INTERVAL / isqrt(count);
+}
+/*---------------------------------------------------------------------------*/
+/* The number of packets a neighbor may hold: an equal share of the pool
+ * between the neighbors that have packets queued, but never the reserve */
+static int
+aqm_fair_share(void)
+{
+  int share = MAX_QUEUED_PACKETS / num_neighbors;
+
+  share = MIN(share, MAX_QUEUED_PACKETS - CSMA_AQM_RESERVE);
+  return MAX(share, 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Whether the sojourn time has been above target for a whole interval.
+ * The last packet of a queue is never dropped. */
+static int
+aqm_ok_to_drop(struct neighbor_queue *n, struct packet_queue *q,
+               clock_time_t now)
+{
+  struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+
+  if(now - metadata->enqueue_time < CSMA_AQM_TARGET || n->depth <= 1) {
+    n->above_target = 0;
+    return 0;
+  }
+  if(!n->above_target) {
+    n->above_target = 1;
+    n->first_above_time = now + CSMA_AQM_INTERVAL;
+    return 0;
+  }
+  return time_reached(now, n->first_above_time);
+}
+/*---------------------------------------------------------------------------*/
+/* Decide whether to drop the packet at the head of a queue, instead of
+ * transmitting it. Follows the CoDel dequeue logic of RFC 8289, with at
+ * most one drop per transmission opportunity. */
+static int
+aqm_should_drop(struct neighbor_queue *n, struct packet_queue *q)
+{
+  clock_time_t now = clock_time();
+  int ok_to_drop = aqm_ok_to_drop(n, q, now);
+  uint16_t delta;
+
+  if(n->dropping) {
+    if(!ok_to_drop) {
+      n->dropping = 0;
+    } else if(time_reached(now, n->drop_next)) {
+      n->drop_count++;
+      n->drop_next = control_law(n->drop_next, n->drop_count);
+      return 1;
+    }
+    return 0;
+  }
+  if(ok_to_drop) {
+    n->dropping = 1;
+    /* Start from the previous drop rate if dropping stopped recently */
+    delta = n->drop_count - n->last_drop_count;
+    if(delta > 1 &&
+       !time_reached(now, n->drop_next + 16 * CSMA_AQM_INTERVAL)) {
+      n->drop_count = delta;
+    } else {
+      n->drop_count = 1;
+    }
+    n->last_drop_count = n->drop_count;
+    n->drop_next = control_law(now, n->drop_count);
+    return 1;
+  }
+  return 0;
+}
+#endif /* CSMA_AQM */
+/*---------------------------------------------------------------------------*/
 static clock_time_t
 backoff_period(void)
 {
@@ -253,22 +475,59 @@ send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
   return last_sent_ok;
 }
 /*---------------------------------------------------------------------------*/
+/* Send, or drop, the packet at the head of a queue */
 static void
-transmit_from_queue(void *ptr)
+transmit_head(struct neighbor_queue *n)
 {
-  struct neighbor_queue *n = ptr;
-  if(n) {
-    struct packet_queue *q = list_head(n->packet_queue);
-    if(q != NULL) {
-      LOG_INFO("preparing packet for ");
+  struct packet_queue *q = list_head(n->packet_queue);
+  if(q != NULL) {
+#if CSMA_AQM
+    if(aqm_should_drop(n, q)) {
+      LOG_INFO("AQM dropping packet for ");
       LOG_INFO_LLADDR(&n->addr);
-      LOG_INFO_(", seqno %u, tx %u, queue %d\n",
-        queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
-        n->transmissions, list_length(n->packet_queue));
-      /* Send first packet in the neighbor queue */
+      LOG_INFO_(", queue %u\n", n->depth);
+      STATS_ADD(drop_aqm, 1);
+#if CSMA_QUEUE_STATS
+      n->drops++;
+#endif /* CSMA_QUEUE_STATS */
+      /* The sent callback of the dropped packet expects it in the
+         packetbuf. The next packet is scheduled when freeing this one. */
       queuebuf_to_packetbuf(q->buf);
-      send_one_packet(n, q);
+      tx_done(MAC_TX_ERR, q, n);
+      return;
     }
+#endif /* CSMA_AQM */
+    LOG_INFO("preparing packet for ");
+    LOG_INFO_LLADDR(&n->addr);
+    LOG_INFO_(", seqno %u, tx %u, queue %d\n",
+      queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
+      n->transmissions, n->depth);
+    /* Send first packet in the neighbor queue */
+    queuebuf_to_packetbuf(q->buf);
+#if CSMA_BURST_MAX_FRAMES > 1
+    /* Announce the next frame of the burst */
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_FRAME_PENDING,
+                       !packetbuf_holds_broadcast() && n->depth > 1 &&
+                       n->burst_frames + 1 < CSMA_BURST_MAX_FRAMES);
+#endif /* CSMA_BURST_MAX_FRAMES > 1 */
+    send_one_packet(n, q);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+transmit_from_queue(void *ptr)
+{
+  struct neighbor_queue *n = ptr;
+  if(n) {
+#if CSMA_BURST_MAX_FRAMES > 1
+    /* The frames of a burst are sent back-to-back */
+    do {
+      burst_next = NULL;
+      transmit_head(n);
+    } while(burst_next == n);
+#else /* CSMA_BURST_MAX_FRAMES > 1 */
+    transmit_head(n);
+#endif /* CSMA_BURST_MAX_FRAMES > 1 */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -289,6 +548,10 @@ schedule_transmission(struct neighbor_queue *n)
 
   LOG_DBG("scheduling transmission in %u ticks, NB=%u, BE=%u\n",
       (unsigned)delay, n->collisions, backoff_exponent);
+#if CSMA_BURST_MAX_FRAMES > 1
+  /* Contending for the channel again ends the burst */
+  n->burst_frames = 0;
+#endif /* CSMA_BURST_MAX_FRAMES > 1 */
   ctimer_set(&n->transmit_timer, delay, transmit_from_queue, n);
 }
 /*---------------------------------------------------------------------------*/
@@ -298,23 +561,33 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
   if(p != NULL) {
     /* Remove packet from queue and deallocate */
     list_remove(n->packet_queue, p);
+    n->depth--;
 
     queuebuf_free(p->buf);
     memb_free(&metadata_memb, p->ptr);
     memb_free(&packet_memb, p);
     LOG_DBG("free_queued_packet, queue length %d, free packets %d\n",
-           list_length(n->packet_queue), memb_numfree(&packet_memb));
+           n->depth, memb_numfree(&packet_memb));
     if(list_head(n->packet_queue) != NULL) {
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_MAX_FRAMES > 1
+      if(status == MAC_TX_OK && !linkaddr_cmp(&n->addr, &linkaddr_null) &&
+         n->burst_frames + 1 < CSMA_BURST_MAX_FRAMES) {
+        /* Send it right away, as part of the burst */
+        n->burst_frames++;
+        STATS_ADD(burst_frames, 1);
+        burst_next = n;
+        return;
+      }
+#endif /* CSMA_BURST_MAX_FRAMES > 1 */
       /* Schedule next transmissions */
       schedule_transmission(n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_free(n);
     }
   }
 }
@@ -332,6 +605,21 @@ tx_done(int status, struct packet_queue *q, struct neighbor_queue *n)
   cptr = metadata->cptr;
   ntx = n->transmissions;
 
+#if CSMA_QUEUE_STATS
+  {
+    clock_time_t sojourn = clock_time() - metadata->enqueue_time;
+
+    stats.dequeued++;
+    stats.sojourn_total += sojourn;
+    if(sojourn > stats.sojourn_max) {
+      stats.sojourn_max = sojourn;
+    }
+    if(sojourn > n->sojourn_max) {
+      n->sojourn_max = sojourn;
+    }
+  }
+#endif /* CSMA_QUEUE_STATS */
+
   LOG_INFO("packet sent to ");
   LOG_INFO_LLADDR(&n->addr);
   LOG_INFO_(", seqno %u, status %u, tx %u, coll %u\n",
@@ -467,19 +755,27 @@ csma_output_packet(mac_callback_t sent, void *ptr)
     n = memb_alloc(&neighbor_memb);
     if(n != NULL) {
       /* Init neighbor entry */
+      memset(n, 0, sizeof(*n));
       linkaddr_copy(&n->addr, addr);
-      n->transmissions = 0;
-      n->collisions = 0;
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
       list_add(neighbor_list, n);
+      num_neighbors++;
+#if CSMA_QUEUE_INDEX
+      addr_hash_insert(&queue_index, index_slot(&n->addr), queue_entry(n));
+#endif /* CSMA_QUEUE_INDEX */
     }
   }
 
   if(n != NULL) {
     /* Add packet to the neighbor's queue */
-    if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
+    if(n->depth < CSMA_MAX_PACKET_PER_NEIGHBOR
+#if CSMA_AQM
+       /* Leave room in the packet pool for the other neighbors */
+       && n->depth < aqm_fair_share()
+#endif /* CSMA_AQM */
+       ) {
       q = memb_alloc(&packet_memb);
       if(q != NULL) {
         q->ptr = memb_alloc(&metadata_memb);
@@ -495,14 +791,24 @@ csma_output_packet(mac_callback_t sent, void *ptr)
             }
             metadata->sent = sent;
             metadata->cptr = ptr;
+#if CSMA_QUEUE_STATS || CSMA_AQM
+            metadata->enqueue_time = clock_time();
+#endif /* CSMA_QUEUE_STATS || CSMA_AQM */
             list_add(n->packet_queue, q);
+            n->depth++;
+            STATS_ADD(enqueued, 1);
+#if CSMA_QUEUE_STATS
+            if(n->depth > stats.depth_max) {
+              stats.depth_max = n->depth;
+            }
+#endif /* CSMA_QUEUE_STATS */
 
             LOG_INFO("sending to ");
             LOG_INFO_LLADDR(addr);
             LOG_INFO_(", len %u, seqno %u, queue length %d, free packets %d\n",
                     packetbuf_datalen(),
                     packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
-                    list_length(n->packet_queue), memb_numfree(&packet_memb));
+                    n->depth, memb_numfree(&packet_memb));
             /* If q is the first packet in the neighbor's queue, send asap */
             if(list_head(n->packet_queue) == q) {
               schedule_transmission(n);
@@ -515,17 +821,22 @@ csma_output_packet(mac_callback_t sent, void *ptr)
         memb_free(&packet_memb, q);
         LOG_WARN("could not allocate queuebuf, dropping packet\n");
       }
+      STATS_ADD(drop_nomem, 1);
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
-      if(list_length(n->packet_queue) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+      if(n->depth == 0) {
+        neighbor_queue_free(n);
       }
     } else {
       LOG_WARN("Neighbor queue full\n");
+      STATS_ADD(drop_full, 1);
+#if CSMA_QUEUE_STATS
+      n->drops++;
+#endif /* CSMA_QUEUE_STATS */
     }
     LOG_WARN("could not allocate packet, dropping packet\n");
   } else {
     LOG_WARN("could not allocate neighbor, dropping packet\n");
+    STATS_ADD(drop_nomem, 1);
   }
   mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
 }
@@ -537,3 +848,42 @@ csma_output_init(void)
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
 }
+/*---------------------------------------------------------------------------*/
+const struct csma_queue_stats *
+csma_queue_get_stats(void)
+{
+#if CSMA_QUEUE_STATS
+  return &stats;
+#else /* CSMA_QUEUE_STATS */
+  static const struct csma_queue_stats no_stats;
+  return &no_stats;
+#endif /* CSMA_QUEUE_STATS */
+}
+/*---------------------------------------------------------------------------*/
+int
+csma_queue_get_neighbor_info(unsigned i, struct csma_neighbor_queue_info *info)
+{
+  struct neighbor_queue *n;
+
+  for(n = list_head(neighbor_list); n != NULL && i > 0;
+      n = list_item_next(n)) {
+    i--;
+  }
+  if(n == NULL) {
+    return 0;
+  }
+
+  memset(info, 0, sizeof(*info));
+  linkaddr_copy(&info->addr, &n->addr);
+  info->depth = n->depth;
+#if CSMA_QUEUE_STATS
+  info->drops = n->drops;
+  info->sojourn_max = n->sojourn_max;
+  if(list_head(n->packet_queue) != NULL) {
+    struct packet_queue *q = list_head(n->packet_queue);
+    info->head_sojourn = clock_time() -
+      ((struct qbuf_metadata *)q->ptr)->enqueue_time;
+  }
+#endif /* CSMA_QUEUE_STATS */
+  return 1;
+}
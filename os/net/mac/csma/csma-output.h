@@ -44,8 +44,104 @@
 
 #include "contiki.h"
 #include "net/mac/mac.h"
+#include "net/linkaddr.h"
+
+/* Look up the neighbor queues through a hash index rather than by walking
+   the list of queues */
+#ifdef CSMA_CONF_QUEUE_INDEX
+#define CSMA_QUEUE_INDEX CSMA_CONF_QUEUE_INDEX
+#else /* CSMA_CONF_QUEUE_INDEX */
+#define CSMA_QUEUE_INDEX 0
+#endif /* CSMA_CONF_QUEUE_INDEX */
+
+/* Keep queue depth, sojourn time and drop statistics */
+#ifdef CSMA_CONF_QUEUE_STATS
+#define CSMA_QUEUE_STATS CSMA_CONF_QUEUE_STATS
+#else /* CSMA_CONF_QUEUE_STATS */
+#define CSMA_QUEUE_STATS 0
+#endif /* CSMA_CONF_QUEUE_STATS */
+
+/* Active queue management. Packets that waited longer than
+   CSMA_AQM_TARGET for a whole CSMA_AQM_INTERVAL are dropped from the
+   head of their neighbor queue, CoDel-style. A neighbor also cannot queue
+   more than its fair share of the packet pool, and never takes the last
+   CSMA_CONF_AQM_RESERVE packets of it. */
+#ifdef CSMA_CONF_AQM
+#define CSMA_AQM CSMA_CONF_AQM
+#else /* CSMA_CONF_AQM */
+#define CSMA_AQM 0
+#endif /* CSMA_CONF_AQM */
+
+#ifdef CSMA_CONF_AQM_TARGET
+#define CSMA_AQM_TARGET CSMA_CONF_AQM_TARGET
+#else /* CSMA_CONF_AQM_TARGET */
+#define CSMA_AQM_TARGET (CLOCK_SECOND / 8)
+#endif /* CSMA_CONF_AQM_TARGET */
+
+#ifdef CSMA_CONF_AQM_INTERVAL
+#define CSMA_AQM_INTERVAL CSMA_CONF_AQM_INTERVAL
+#else /* CSMA_CONF_AQM_INTERVAL */
+#define CSMA_AQM_INTERVAL CLOCK_SECOND
+#endif /* CSMA_CONF_AQM_INTERVAL */
+
+/* The maximum number of frames sent back-to-back to a neighbor. After an
+   acknowledged frame, the next queued frame to the same neighbor is sent
+   at once, without a new backoff, until the burst reaches this length.
+   The frame pending bit tells the receiver that more frames follow.
+   1 disables bursts. */
+#ifdef CSMA_CONF_BURST_MAX_FRAMES
+#define CSMA_BURST_MAX_FRAMES CSMA_CONF_BURST_MAX_FRAMES
+#else /* CSMA_CONF_BURST_MAX_FRAMES */
+#define CSMA_BURST_MAX_FRAMES 1
+#endif /* CSMA_CONF_BURST_MAX_FRAMES */
+
+/** Aggregate statistics of the CSMA queues */
+struct csma_queue_stats {
+  uint32_t enqueued;
+  uint32_t dequeued;
+  /** Packets refused because their neighbor queue was full */
+  uint32_t drop_full;
+  /** Packets refused for lack of a neighbor queue, packet or queuebuf */
+  uint32_t drop_nomem;
+  /** Packets dropped by active queue management */
+  uint32_t drop_aqm;
+  /** The sum of the sojourn times of the dequeued packets, in clock ticks */
+  uint32_t sojourn_total;
+  clock_time_t sojourn_max;
+  uint16_t depth_max;
+  /** Frames sent within a burst, without a backoff of their own */
+  uint32_t burst_frames;
+};
+
+/** The state of a neighbor queue */
+struct csma_neighbor_queue_info {
+  linkaddr_t addr;
+  uint8_t depth;
+  uint16_t drops;
+  /** How long the packet at the head of the queue has been waiting */
+  clock_time_t head_sojourn;
+  clock_time_t sojourn_max;
+};
 
 void csma_output_packet(mac_callback_t sent, void *ptr);
 void csma_output_init(void);
 
+/**
+ * \brief Get the aggregate statistics of the CSMA queues
+ *
+ * Only counted when CSMA_QUEUE_STATS is enabled.
+ */
+const struct csma_queue_stats *csma_queue_get_stats(void);
+
+/**
+ * \brief Get the state of a neighbor queue
+ * \param i The position of the queue, from zero
+ * \param info Filled in with the state of the queue
+ * \return 1 if there is an i-th queue, 0 otherwise
+ *
+ * Drops and sojourn times are only counted when CSMA_QUEUE_STATS is enabled.
+ */
+int csma_queue_get_neighbor_info(unsigned i,
+                                 struct csma_neighbor_queue_info *info);
+
 #endif /* CSMA_OUTPUT_H_ */
@@ -296,11 +296,11 @@ frame80215e_create_ie_tsch_timeslot(uint8_t *buf, int len,
   if(ies == NULL) {
     return -1;
   }
-  /* Only ID if ID == 0, else full timing description */
-  ie_len = ies->ie_tsch_timeslot_id == 0 ? 1 : 25;
+  /* Only ID if ID == 0 or if requested, else full timing description */
+  ie_len = (ies->ie_tsch_timeslot_id == 0 || ies->ie_tsch_timeslot_id_only) ? 1 : 25;
   if(len >= 2 + ie_len) {
     buf[2] = ies->ie_tsch_timeslot_id;
-    if(ies->ie_tsch_timeslot_id != 0) {
+    if(ie_len == 25) {
       int i;
       for(i = 0; i < tsch_ts_elements_count; i++) {
         WRITE16(buf + 3 + 2 * i, ies->ie_tsch_timeslot[i]);
@@ -424,6 +424,7 @@ frame802154e_parse_mlme_short_ie(const uint8_t *buf, int len,
       if(len == 1 || len == 25) {
         if(ies != NULL) {
           ies->ie_tsch_timeslot_id = buf[0];
+          ies->ie_tsch_timeslot_id_only = len == 1;
           if(len == 25) {
             int i;
             for(i = 0; i < tsch_ts_elements_count; i++) {
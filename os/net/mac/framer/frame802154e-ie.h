@@ -78,6 +78,8 @@ struct ieee802154_ies {
   struct tsch_asn_t ie_asn;
   uint8_t ie_join_priority;
   uint8_t ie_tsch_timeslot_id;
+  /* Non-zero if the timeslot IE carries the template ID only */
+  uint8_t ie_tsch_timeslot_id_only;
   uint16_t ie_tsch_timeslot[tsch_ts_elements_count];
   struct tsch_slotframe_and_links ie_tsch_slotframe_and_link;
   /* Payload Long MLME IEs */
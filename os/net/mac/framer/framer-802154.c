@@ -103,13 +103,15 @@ create_frame(int do_create)
   linkaddr_copy((linkaddr_t *)&params.src_addr,
                 packetbuf_addr(PACKETBUF_ADDR_SENDER));
 
-  params.payload = packetbuf_dataptr();
   params.payload_len = packetbuf_datalen();
   hdr_len = frame802154_hdrlen(&params);
   if(!do_create) {
     /* Only calculate header length */
     return hdr_len;
   } else if(packetbuf_hdralloc(hdr_len)) {
+    /* Get the payload pointer after the header allocation, which may
+       move the payload */
+    params.payload = packetbuf_dataptr();
     frame802154_create(&params, packetbuf_hdrptr());
 
     LOG_INFO("Out: %2X ", params.fcf.frame_type);
@@ -139,7 +141,7 @@ framer_802154_setup_params(packetbuf_attr_t (*get_attr)(uint8_t type),
 
   /* Build the FCF. */
   params->fcf.frame_type = get_attr(PACKETBUF_ATTR_FRAME_TYPE);
-  params->fcf.frame_pending = 0;
+  params->fcf.frame_pending = get_attr(PACKETBUF_ATTR_MAC_FRAME_PENDING) & 1;
   if(dest_is_broadcast) {
     params->fcf.ack_required = 0;
     /* Suppress seqno on broadcast if supported (frame v2 or more) */
@@ -241,6 +243,7 @@ parse(void)
   if(hdr_len && packetbuf_hdrreduce(hdr_len)) {
     packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, frame.fcf.frame_type);
     packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, frame.fcf.ack_required);
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_FRAME_PENDING, frame.fcf.frame_pending);
 
     if(frame.fcf.dest_addr_mode) {
       if(frame.dest_pid != frame802154_get_pan_id() &&
@@ -232,6 +232,20 @@
 #define TSCH_PACKET_EB_WITH_TIMESLOT_TIMING 0
 #endif
 
+/* TSCH EB: advertise the timeslot timing by template ID only, when it
+ * matches a known template (see TSCH_TIMESLOT_TEMPLATE_ID_*)? Joining nodes
+ * then adopt the template. Takes precedence over the full timing IE. A
+ * timing that matches no template is advertised as a full timing IE if
+ * TSCH_PACKET_EB_WITH_TIMESLOT_TIMING is also enabled, and as ID 0 (the
+ * joining node's platform default) otherwise.
+ * Nodes that predate template IDs read a non-zero ID-only IE as an all-zero
+ * timing: do not enable this in networks that also contain such nodes. */
+#ifdef TSCH_PACKET_CONF_EB_WITH_TIMESLOT_TEMPLATE_ID
+#define TSCH_PACKET_EB_WITH_TIMESLOT_TEMPLATE_ID TSCH_PACKET_CONF_EB_WITH_TIMESLOT_TEMPLATE_ID
+#else
+#define TSCH_PACKET_EB_WITH_TIMESLOT_TEMPLATE_ID 0
+#endif
+
 /* TSCH EB: include hopping sequence Information Element? */
 #ifdef TSCH_PACKET_CONF_EB_WITH_HOPPING_SEQUENCE
 #define TSCH_PACKET_EB_WITH_HOPPING_SEQUENCE TSCH_PACKET_CONF_EB_WITH_HOPPING_SEQUENCE
@@ -280,6 +294,16 @@
 #define TSCH_MAX_INCOMING_PACKETS 4
 #endif
 
+/* The maximum number of packets taken from each of the input and dequeued
+ * ring buffers every time the TSCH pending events process runs. When
+ * packets remain, the process polls itself again, so that other processes
+ * get to run in between. 0 for no limit. */
+#ifdef TSCH_CONF_PENDING_BATCH_SIZE
+#define TSCH_PENDING_BATCH_SIZE TSCH_CONF_PENDING_BATCH_SIZE
+#else
+#define TSCH_PENDING_BATCH_SIZE 0
+#endif
+
 /* The maximum number of outgoing packets towards each neighbor
  * Must be power of two to enable atomic ringbuf operations.
  * Note: the total number of outgoing packets in the system (for
@@ -314,6 +338,17 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep bitmaps of the neighbors that have packets queued and of those in
+ * backoff, so that the slot operation finds a neighbor to transmit to on a
+ * shared cell, and decrements backoff windows, without walking all
+ * neighbors. For a constant-time neighbor lookup by address, also set
+ * NBR_TABLE_CONF_HASH_INDEX. */
+#ifdef TSCH_QUEUE_CONF_WITH_BITMAP
+#define TSCH_QUEUE_WITH_BITMAP TSCH_QUEUE_CONF_WITH_BITMAP
+#else
+#define TSCH_QUEUE_WITH_BITMAP 0
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -353,6 +388,15 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links sorted by timeslot in an index, so that the next active
+ * link is found by binary search in each slotframe rather than by walking
+ * all links. Costs one pointer per link. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_INDEX
+#define TSCH_SCHEDULE_WITH_INDEX TSCH_SCHEDULE_CONF_WITH_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_INDEX 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
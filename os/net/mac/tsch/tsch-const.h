@@ -67,6 +67,12 @@
 /* 1 channel, sequence length 1 */
 #define TSCH_HOPPING_SEQUENCE_1_1 (uint8_t[]){ 20 }
 
+/* Timeslot timing template IDs, as advertised in the EB timeslot IE.
+ * ID 0 stands for the default timing of the platform */
+#define TSCH_TIMESLOT_TEMPLATE_ID_10000 1
+#define TSCH_TIMESLOT_TEMPLATE_ID_7000  2
+#define TSCH_TIMESLOT_TEMPLATE_ID_5000  3
+
 /* Max TSCH packet length equal to the length of the packet buffer */
 #define TSCH_PACKET_MAX_LEN PACKETBUF_SIZE
 
@@ -230,8 +230,12 @@ tsch_packet_create_eb(uint8_t *hdr_len, uint8_t *tsch_sync_ie_offset)
   memset(&ies, 0, sizeof(ies));
 
   /* Add TSCH timeslot timing IE. */
+#if TSCH_PACKET_EB_WITH_TIMESLOT_TEMPLATE_ID
+  ies.ie_tsch_timeslot_id = tsch_timeslot_timing_get_template_id(tsch_timing_us);
+  ies.ie_tsch_timeslot_id_only = ies.ie_tsch_timeslot_id != 0;
+#endif /* TSCH_PACKET_EB_WITH_TIMESLOT_TEMPLATE_ID */
 #if TSCH_PACKET_EB_WITH_TIMESLOT_TIMING
-  {
+  if(!ies.ie_tsch_timeslot_id_only) {
     int i;
     ies.ie_tsch_timeslot_id = 1;
     for(i = 0; i < tsch_ts_elements_count; i++) {
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Source file for the TSCH slot profiler
+ */
+
+/**
+ * \addtogroup tsch
+ * @{
+*/
+
+#include "contiki.h"
+#include "lib/ringbufindex.h"
+#include "net/mac/tsch/tsch.h"
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+#if TSCH_PROFILER_ON
+/*---------------------------------------------------------------------------*/
+
+/* Check if TSCH_PROFILER_RING_SIZE is power of two */
+#if (TSCH_PROFILER_RING_SIZE & (TSCH_PROFILER_RING_SIZE - 1)) != 0
+#error TSCH_PROFILER_RING_SIZE must be power of two
+#endif
+
+static const char *const phase_names[tsch_phase_count] = {
+  "slot-start", "tx-prepared", "tx-cca", "tx-sent", "tx-ack",
+  "rx-listen", "rx-detected", "rx-idle", "rx-received", "rx-verified",
+  "rx-ack-sent", "slot-done", "next-scheduled"
+};
+
+static struct tsch_profiler_stats stats;
+/* The slot in progress, if any */
+static struct tsch_profiler_record current;
+static rtimer_clock_t current_start;
+static uint8_t in_slot;
+/* Records of the past slots, filled by the slot operation, read from
+ * process context */
+static struct ringbufindex records_ringbuf;
+static struct tsch_profiler_record records[TSCH_PROFILER_RING_SIZE];
+
+/*---------------------------------------------------------------------------*/
+void
+tsch_profiler_init(void)
+{
+  tsch_profiler_reset();
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_profiler_slot_start(const struct tsch_asn_t *asn, int is_tx,
+                         rtimer_clock_t slot_start)
+{
+  current.asn = *asn;
+  current.is_tx = is_tx;
+  current.overrun = 0;
+  current.reached = 0;
+  current_start = slot_start;
+  in_slot = 1;
+  tsch_profiler_mark(tsch_phase_slot_start);
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_profiler_mark(enum tsch_profiler_phase phase)
+{
+  current.time[phase] = RTIMER_NOW() - current_start;
+  current.reached |= 1 << phase;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_profiler_slot_end(void)
+{
+  rtimer_clock_t elapsed;
+  rtimer_clock_t bin_width;
+  int16_t put_index;
+  unsigned phase;
+  unsigned bin;
+
+  if(!in_slot) {
+    /* The slot was skipped or idle */
+    return;
+  }
+  in_slot = 0;
+
+  tsch_profiler_mark(tsch_phase_next_scheduled);
+  elapsed = current.time[tsch_phase_next_scheduled];
+  current.overrun = elapsed > tsch_timing[tsch_ts_timeslot_length];
+
+  stats.slots++;
+  if(current.overrun) {
+    stats.overruns++;
+    TSCH_LOG_ADD(tsch_log_message,
+        snprintf(log->message, sizeof(log->message),
+            "!slot overrun %s %u/%u", current.is_tx ? "tx" : "rx",
+            (unsigned)elapsed, (unsigned)tsch_timing[tsch_ts_timeslot_length]);
+    );
+  }
+
+  bin_width = MAX(tsch_timing[tsch_ts_timeslot_length] / TSCH_PROFILER_BINS, 1);
+  for(phase = 0; phase < tsch_phase_count; phase++) {
+    if(current.reached & (1 << phase)) {
+      stats.max[phase] = MAX(stats.max[phase], current.time[phase]);
+      bin = MIN(current.time[phase] / bin_width, TSCH_PROFILER_BINS - 1);
+      if(stats.hist[phase][bin] != UINT16_MAX) {
+        stats.hist[phase][bin]++;
+      }
+    }
+  }
+
+  put_index = ringbufindex_peek_put(&records_ringbuf);
+  if(put_index != -1) {
+    records[put_index] = current;
+    ringbufindex_put(&records_ringbuf);
+  } else {
+    stats.records_lost++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_profiler_deadline_miss(void)
+{
+  stats.deadline_misses++;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_profiler_read(struct tsch_profiler_record *record)
+{
+  int16_t get_index = ringbufindex_peek_get(&records_ringbuf);
+
+  if(get_index == -1) {
+    return 0;
+  }
+  *record = records[get_index];
+  ringbufindex_get(&records_ringbuf);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_profiler_stats *
+tsch_profiler_get_stats(void)
+{
+  return &stats;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_profiler_reset(void)
+{
+  memset(&stats, 0, sizeof(stats));
+  ringbufindex_init(&records_ringbuf, TSCH_PROFILER_RING_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+const char *
+tsch_profiler_phase_name(enum tsch_profiler_phase phase)
+{
+  return phase < tsch_phase_count ? phase_names[phase] : "?";
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_PROFILER_ON */
+/** @} */
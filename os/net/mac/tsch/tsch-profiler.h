@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the TSCH slot profiler. Records the time at which
+ *         each phase of the TX and RX slots is reached, relative to the
+ *         start of the slot, and flags slots that overran the timeslot.
+ */
+
+/**
+ * \addtogroup tsch
+ * @{
+*/
+
+#ifndef __TSCH_PROFILER_H__
+#define __TSCH_PROFILER_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "sys/rtimer.h"
+#include "net/mac/tsch/tsch-asn.h"
+
+/************ Constants ***********/
+
+/* Enable the slot profiler? */
+#ifdef TSCH_PROFILER_CONF_ON
+#define TSCH_PROFILER_ON TSCH_PROFILER_CONF_ON
+#else
+#define TSCH_PROFILER_ON 0
+#endif
+
+/* The number of slot records kept until read. Must be power of two */
+#ifdef TSCH_PROFILER_CONF_RING_SIZE
+#define TSCH_PROFILER_RING_SIZE TSCH_PROFILER_CONF_RING_SIZE
+#else
+#define TSCH_PROFILER_RING_SIZE 8
+#endif
+
+/* The number of histogram bins per phase, spread over the timeslot length */
+#ifdef TSCH_PROFILER_CONF_BINS
+#define TSCH_PROFILER_BINS TSCH_PROFILER_CONF_BINS
+#else
+#define TSCH_PROFILER_BINS 10
+#endif
+
+/************ Types ***********/
+
+/* The phases of a slot, in the order they are reached */
+enum tsch_profiler_phase {
+  tsch_phase_slot_start,     /* Slot operation woken up */
+  tsch_phase_tx_prepared,    /* Frame secured and copied to the radio */
+  tsch_phase_tx_cca,         /* CCA done */
+  tsch_phase_tx_sent,        /* Frame transmitted */
+  tsch_phase_tx_ack,         /* ACK received, or ACK wait over */
+  tsch_phase_rx_listen,      /* Radio listening */
+  tsch_phase_rx_detected,    /* Frame detected */
+  tsch_phase_rx_idle,        /* Guard time over, no frame detected */
+  tsch_phase_rx_received,    /* Frame read from the radio */
+  tsch_phase_rx_verified,    /* Frame parsed and authenticated */
+  tsch_phase_rx_ack_sent,    /* ACK transmitted */
+  tsch_phase_slot_done,      /* TX or RX slot over */
+  tsch_phase_next_scheduled, /* Next slot scheduled */
+  tsch_phase_count
+};
+
+/* The profile of one slot */
+struct tsch_profiler_record {
+  struct tsch_asn_t asn;
+  /* Was the slot a TX slot? */
+  uint8_t is_tx;
+  /* Did the slot end after the timeslot length? */
+  uint8_t overrun;
+  /* The phases reached, one bit per phase */
+  uint16_t reached;
+  /* When each phase was reached, since the start of the slot */
+  rtimer_clock_t time[tsch_phase_count];
+};
+
+struct tsch_profiler_stats {
+  /* The number of slots profiled */
+  uint32_t slots;
+  /* Slots that ended after the timeslot length */
+  uint32_t overruns;
+  /* Deadlines missed while scheduling within or between slots */
+  uint32_t deadline_misses;
+  /* Records lost because the ring was full */
+  uint32_t records_lost;
+  /* The latest time each phase was reached */
+  rtimer_clock_t max[tsch_phase_count];
+  /* Histogram of the times each phase was reached. Bin i counts
+   * the times in [i, i + 1) * timeslot length / TSCH_PROFILER_BINS,
+   * the last bin also counts later times. */
+  uint16_t hist[tsch_phase_count][TSCH_PROFILER_BINS];
+};
+
+/************ Functions ***********/
+
+#if TSCH_PROFILER_ON
+
+void tsch_profiler_init(void);
+
+/* Called from the slot operation: at the start of an active slot, when
+ * reaching a phase, after scheduling the next slot, and on deadline miss */
+void tsch_profiler_slot_start(const struct tsch_asn_t *asn, int is_tx,
+                              rtimer_clock_t slot_start);
+void tsch_profiler_mark(enum tsch_profiler_phase phase);
+void tsch_profiler_slot_end(void);
+void tsch_profiler_deadline_miss(void);
+
+/**
+ * \brief Read the oldest slot record
+ * \param record Where to store the record
+ * \return 1 if a record was read, 0 if there is none
+ */
+int tsch_profiler_read(struct tsch_profiler_record *record);
+/**
+ * \brief Get the profiler counters and histograms
+ */
+const struct tsch_profiler_stats *tsch_profiler_get_stats(void);
+/**
+ * \brief Reset the profiler counters and histograms
+ */
+void tsch_profiler_reset(void);
+/**
+ * \brief Get the name of a phase
+ */
+const char *tsch_profiler_phase_name(enum tsch_profiler_phase phase);
+
+#else /* TSCH_PROFILER_ON */
+
+#define tsch_profiler_init()
+#define tsch_profiler_slot_start(asn, is_tx, slot_start)
+#define tsch_profiler_mark(phase)
+#define tsch_profiler_slot_end()
+#define tsch_profiler_deadline_miss()
+
+#endif /* TSCH_PROFILER_ON */
+
+#endif /* __TSCH_PROFILER_H__ */
+/** @} */
@@ -75,6 +75,78 @@ NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_BITMAP
+#define BITS_PER_WORD 32
+#define BITMAP_WORDS ((NBR_TABLE_MAX_NEIGHBORS + BITS_PER_WORD - 1) / BITS_PER_WORD)
+/* Neighbors that may have packets queued. Bits are set when adding a
+ * packet and cleared by the slot operation once it finds the queue empty,
+ * so that the map never misses a neighbor with packets. */
+static uint32_t queued_map[BITMAP_WORDS];
+/* Neighbors with a non-zero backoff window. Only updated from the slot
+ * operation, or with the TSCH lock held, like the backoff windows. */
+static uint32_t backoff_map[BITMAP_WORDS];
+/* Where the next search for a ready neighbor starts, so that neighbors
+ * take turns on shared cells */
+static unsigned ready_next;
+#endif /* TSCH_QUEUE_WITH_BITMAP */
+
+#if TSCH_QUEUE_WITH_BITMAP
+/*---------------------------------------------------------------------------*/
+static unsigned
+nbr_index(const struct tsch_neighbor *n)
+{
+  return n - (const struct tsch_neighbor *)tsch_neighbors->data;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bitmap_set(uint32_t *map, unsigned i)
+{
+  map[i / BITS_PER_WORD] |= (uint32_t)1 << (i % BITS_PER_WORD);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bitmap_clear(uint32_t *map, unsigned i)
+{
+  map[i / BITS_PER_WORD] &= ~((uint32_t)1 << (i % BITS_PER_WORD));
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+lowest_bit(uint32_t word)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(word);
+#else
+  unsigned bit;
+
+  for(bit = 0; !(word & 1); bit++) {
+    word >>= 1;
+  }
+  return bit;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the first neighbor index in [from, to) whose bit is set in map,
+ * and not set in mask if any, or to if there is none */
+static unsigned
+bitmap_next(const uint32_t *map, const uint32_t *mask,
+            unsigned from, unsigned to)
+{
+  while(from < to) {
+    unsigned w = from / BITS_PER_WORD;
+    uint32_t bits = map[w] & ((uint32_t)~0 << (from % BITS_PER_WORD));
+    if(mask != NULL) {
+      bits &= ~mask[w];
+    }
+    if(bits != 0) {
+      from = w * BITS_PER_WORD + lowest_bit(bits);
+      return MIN(from, to);
+    }
+    from = (w + 1) * BITS_PER_WORD;
+  }
+  return to;
+}
+#endif /* TSCH_QUEUE_WITH_BITMAP */
+
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -213,6 +285,13 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
   if(n != NULL) {
     if(tsch_get_lock()) {
 
+#if TSCH_QUEUE_WITH_BITMAP
+      /* Take the entry out of the bitmaps before it is freed, so that neither
+         the backoff update nor the queue scans visit it again */
+      bitmap_clear(queued_map, nbr_index(n));
+      bitmap_clear(backoff_map, nbr_index(n));
+#endif /* TSCH_QUEUE_WITH_BITMAP */
+
       tsch_release_lock();
 
       /* Flush queue */
@@ -260,6 +339,11 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
+#if TSCH_QUEUE_WITH_BITMAP
+            /* After the put, so that the slot operation does not clear
+             * the bit before seeing the packet */
+            bitmap_set(queued_map, nbr_index(n));
+#endif /* TSCH_QUEUE_WITH_BITMAP */
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
             return p;
@@ -451,6 +535,45 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_WITH_BITMAP
+    struct tsch_neighbor *curr_nbr;
+    struct tsch_packet *p = NULL;
+    /* Neighbors in backoff may only transmit on dedicated links */
+    const uint32_t *mask = link != NULL && (link->link_options & LINK_OPTION_SHARED)
+      ? backoff_map : NULL;
+    unsigned start = ready_next;
+    unsigned end = NBR_TABLE_MAX_NEIGHBORS;
+    unsigned i = start;
+
+    /* Only visit neighbors with packets and no backoff, starting after the
+     * last one served and wrapping around once */
+    while(1) {
+      i = bitmap_next(queued_map, mask, i, end);
+      if(i == end) {
+        if(end == start) {
+          break;
+        }
+        i = 0;
+        end = start;
+        continue;
+      }
+      curr_nbr = (struct tsch_neighbor *)tsch_neighbors->data + i;
+      if(ringbufindex_empty(&curr_nbr->tx_ringbuf)) {
+        bitmap_clear(queued_map, i);
+      } else if(!curr_nbr->is_broadcast && curr_nbr->tx_links_count == 0) {
+        /* Only look up for non-broadcast neighbors we do not have a tx link to */
+        p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+        if(p != NULL) {
+          if(n != NULL) {
+            *n = curr_nbr;
+          }
+          ready_next = (i + 1) % NBR_TABLE_MAX_NEIGHBORS;
+          return p;
+        }
+      }
+      i++;
+    }
+#else /* TSCH_QUEUE_WITH_BITMAP */
     struct tsch_neighbor *curr_nbr = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
     struct tsch_packet *p = NULL;
     while(curr_nbr != NULL) {
@@ -466,6 +589,7 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
       }
       curr_nbr = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, curr_nbr);
     }
+#endif /* TSCH_QUEUE_WITH_BITMAP */
   }
   return NULL;
 }
@@ -483,6 +607,9 @@ tsch_queue_backoff_reset(struct tsch_neighbor *n)
 {
   n->backoff_window = 0;
   n->backoff_exponent = TSCH_MAC_MIN_BE;
+#if TSCH_QUEUE_WITH_BITMAP
+  bitmap_clear(backoff_map, nbr_index(n));
+#endif /* TSCH_QUEUE_WITH_BITMAP */
 }
 /*---------------------------------------------------------------------------*/
 /* Increment backoff exponent, pick a new window */
@@ -498,6 +625,9 @@ tsch_queue_backoff_inc(struct tsch_neighbor *n)
   /* Add one to the window as we will decrement it at the end of the current slot
    * through tsch_queue_update_all_backoff_windows */
   n->backoff_window++;
+#if TSCH_QUEUE_WITH_BITMAP
+  bitmap_set(backoff_map, nbr_index(n));
+#endif /* TSCH_QUEUE_WITH_BITMAP */
 }
 /*---------------------------------------------------------------------------*/
 /* Decrement backoff window for all queues directed at dest_addr */
@@ -506,15 +636,49 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 {
   if(!tsch_is_locked()) {
     int is_broadcast = linkaddr_cmp(dest_addr, &tsch_broadcast_address);
-    struct tsch_neighbor *n = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
-    while(n != NULL) {
-      if(n->backoff_window != 0 /* Is the queue in backoff state? */
-         && ((n->tx_links_count == 0 && is_broadcast)
-             || (n->tx_links_count > 0 && linkaddr_cmp(dest_addr, tsch_queue_get_nbr_address(n))))) {
-        n->backoff_window--;
+    struct tsch_neighbor *n;
+#if TSCH_QUEUE_WITH_BITMAP
+    unsigned i = 0;
+#else /* TSCH_QUEUE_WITH_BITMAP */
+    if(is_broadcast) {
+      n = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
+      while(n != NULL) {
+        if(n->backoff_window != 0 /* Is the queue in backoff state? */
+           && (n->tx_links_count == 0
+               || linkaddr_cmp(dest_addr, tsch_queue_get_nbr_address(n)))) {
+          n->backoff_window--;
+        }
+        n = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
+      }
+      return;
+    }
+#endif /* TSCH_QUEUE_WITH_BITMAP */
+    /* The neighbor with this address, if we have a tx link to it */
+    n = tsch_queue_get_nbr(dest_addr);
+    if(n != NULL && n->backoff_window != 0 && n->tx_links_count > 0) {
+      n->backoff_window--;
+#if TSCH_QUEUE_WITH_BITMAP
+      if(n->backoff_window == 0) {
+        bitmap_clear(backoff_map, nbr_index(n));
+      }
+#endif /* TSCH_QUEUE_WITH_BITMAP */
+    }
+#if TSCH_QUEUE_WITH_BITMAP
+    if(is_broadcast) {
+      /* All neighbors in backoff state we do not have a tx link to */
+      while((i = bitmap_next(backoff_map, NULL, i, NBR_TABLE_MAX_NEIGHBORS))
+            < NBR_TABLE_MAX_NEIGHBORS) {
+        n = (struct tsch_neighbor *)tsch_neighbors->data + i;
+        if(n->tx_links_count == 0) {
+          n->backoff_window--;
+          if(n->backoff_window == 0) {
+            bitmap_clear(backoff_map, i);
+          }
+        }
+        i++;
       }
-      n = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
     }
+#endif /* TSCH_QUEUE_WITH_BITMAP */
   }
 }
 /*---------------------------------------------------------------------------*/
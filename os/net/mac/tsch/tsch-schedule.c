@@ -68,6 +68,77 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_INDEX
+/* The links of all slotframes, sorted by timeslot. Each slotframe owns a
+ * contiguous segment, in the order of slotframe_list. Links with the same
+ * timeslot stay in the order they were added, as in links_list. */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t link_index_count;
+
+/*---------------------------------------------------------------------------*/
+/* Position of the first link of a slotframe with a timeslot at least as
+ * large as the given one (strictly larger if after is set) */
+static uint16_t
+index_search(const struct tsch_slotframe *sf, uint16_t timeslot, int after)
+{
+  uint16_t lo = sf->index_start;
+  uint16_t hi = sf->index_start + sf->index_count;
+
+  while(lo < hi) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    if(link_index[mid]->timeslot < timeslot ||
+       (after && link_index[mid]->timeslot == timeslot)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the segments of the slotframes that follow sf by one position */
+static void
+index_shift_after(struct tsch_slotframe *sf, int delta)
+{
+  struct tsch_slotframe *next;
+
+  for(next = list_item_next(sf); next != NULL; next = list_item_next(next)) {
+    next->index_start += delta;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos = index_search(sf, l->timeslot, 1);
+
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (link_index_count - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  link_index_count++;
+  sf->index_count++;
+  index_shift_after(sf, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t end = sf->index_start + sf->index_count;
+  uint16_t pos;
+
+  for(pos = index_search(sf, l->timeslot, 0); pos < end; pos++) {
+    if(link_index[pos] == l) {
+      memmove(&link_index[pos], &link_index[pos + 1],
+              (link_index_count - pos - 1) * sizeof(link_index[0]));
+      link_index_count--;
+      sf->index_count--;
+      index_shift_after(sf, -1);
+      return;
+    }
+  }
+}
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -88,6 +159,11 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+      /* The new slotframe comes last, and so does its segment */
+      sf->index_start = link_index_count;
+      sf->index_count = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -256,6 +332,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_INDEX
+        index_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -309,6 +388,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_("\n");
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_WITH_INDEX
+      index_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -341,6 +423,15 @@ tsch_schedule_remove_link_by_timeslot(struct tsch_slotframe *slotframe,
   int ret = 0;
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_INDEX
+      struct tsch_link *l;
+      /* Remove all matching links, found through the index */
+      while((l = tsch_schedule_get_link_by_timeslot(slotframe, timeslot,
+                                                    channel_offset)) != NULL
+            && tsch_schedule_remove_link(slotframe, l)) {
+        ret = 1;
+      }
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items and remove all matching links */
       while(l != NULL) {
@@ -352,6 +443,7 @@ tsch_schedule_remove_link_by_timeslot(struct tsch_slotframe *slotframe,
         }
         l = next;
       }
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     }
   }
   return ret;
@@ -364,6 +456,18 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_INDEX
+      uint16_t end = slotframe->index_start + slotframe->index_count;
+      uint16_t i;
+      /* The links of the timeslot are next to each other in the index */
+      for(i = index_search(slotframe, timeslot, 0);
+          i < end && link_index[i]->timeslot == timeslot; i++) {
+        if(link_index[i]->channel_offset == channel_offset) {
+          return link_index[i];
+        }
+      }
+      return NULL;
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot and channel_offset */
       while(l != NULL) {
@@ -373,6 +477,7 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     }
   }
   return NULL;
@@ -400,6 +505,59 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Selects between the current best link and a link occurring in
+ * time_to_timeslot slots, maintaining the backup link */
+static void
+select_link(struct tsch_link *l, uint16_t time_to_timeslot,
+            struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+            struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != (*curr_best)->slotframe_handle) {
+        if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(*curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    /* Check if 'l' best can be used as backup */
+    if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+      if(*curr_backup == NULL || l->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = l;
+      }
+    }
+    /* Check if curr_best can be used as backup */
+    if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+      if(*curr_backup == NULL || (*curr_best)->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
@@ -418,59 +576,37 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_INDEX
+      if(sf->index_count > 0) {
+        uint16_t end = sf->index_start + sf->index_count;
+        uint16_t i = index_search(sf, timeslot, 1);
+        uint16_t next_timeslot;
+        if(i == end) {
+          /* No link until the end of the slotframe: wrap around */
+          i = sf->index_start;
+        }
+        /* Only the links of the earliest timeslot can be selected */
+        next_timeslot = link_index[i]->timeslot;
+        for(; i < end && link_index[i]->timeslot == next_timeslot; i++) {
+          select_link(link_index[i],
+                      next_timeslot > timeslot ?
+                      next_timeslot - timeslot :
+                      sf->size.val + next_timeslot - timeslot,
+                      &curr_best, &time_to_curr_best, &curr_backup);
+        }
+      }
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          /* Check if 'l' best can be used as backup */
-          if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-            if(curr_backup == NULL || l->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = l;
-            }
-          }
-          /* Check if curr_best can be used as backup */
-          if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-            if(curr_backup == NULL || curr_best->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(l, time_to_timeslot,
+                    &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
@@ -491,6 +627,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+    link_index_count = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     tsch_release_lock();
     return 1;
   } else {
@@ -126,6 +126,7 @@ struct tsch_packet *dequeued_array[TSCH_DEQUEUED_ARRAY_SIZE];
  * Will be processed layer by tsch_rx_process_pending */
 struct ringbufindex input_ringbuf;
 struct input_packet input_array[TSCH_MAX_INCOMING_PACKETS];
+struct tsch_ringbuf_stats tsch_ringbuf_stats;
 
 /* Updates and reads of the next two variables must be atomic (i.e. both together) */
 /* Last time we received Sync-IE (ACK or data packet from a time source) */
@@ -307,6 +308,7 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
   int missed = check_timer_miss(ref_time, offset - RTIMER_GUARD, now);
 
   if(missed) {
+    tsch_profiler_deadline_miss();
     TSCH_LOG_ADD(tsch_log_message,
                 snprintf(log->message, sizeof(log->message),
                     "!dl-miss %s %d %d",
@@ -562,6 +564,8 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       if(packet_ready && NETSTACK_RADIO.prepare(packet, packet_len) == 0) { /* 0 means success */
         static rtimer_clock_t tx_duration;
 
+        tsch_profiler_mark(tsch_phase_tx_prepared);
+
 #if TSCH_CCA_ENABLED
         cca_status = 1;
         /* delay before CCA */
@@ -572,6 +576,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
         RTIMER_BUSYWAIT_UNTIL_ABS(!(cca_status &= NETSTACK_RADIO.channel_clear()),
                            current_slot_start, tsch_timing[tsch_ts_cca_offset] + tsch_timing[tsch_ts_cca]);
         TSCH_DEBUG_TX_EVENT();
+        tsch_profiler_mark(tsch_phase_tx_cca);
         /* there is not enough time to turn radio off */
         /*  NETSTACK_RADIO.off(); */
         if(cca_status == 0) {
@@ -584,6 +589,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
           TSCH_DEBUG_TX_EVENT();
           /* send packet already in radio tx buffer */
           mac_tx_status = NETSTACK_RADIO.transmit(packet_len);
+          tsch_profiler_mark(tsch_phase_tx_sent);
           tx_count++;
           /* Save tx timestamp */
           tx_start_time = current_slot_start + tsch_timing[tsch_ts_tx_offset];
@@ -627,6 +633,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
                                  ack_start_time, tsch_timing[tsch_ts_max_ack]);
               TSCH_DEBUG_TX_EVENT();
               tsch_radio_off(TSCH_RADIO_CMD_OFF_WITHIN_TIMESLOT);
+              tsch_profiler_mark(tsch_phase_tx_ack);
 
 #if TSCH_HW_FRAME_FILTERING
               /* Leaving promiscuous mode */
@@ -722,6 +729,8 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
     if(in_queue == 0) {
       dequeued_array[dequeued_index] = current_packet;
       ringbufindex_put(&dequeued_ringbuf);
+      tsch_ringbuf_stats.dequeued_max = MAX(tsch_ringbuf_stats.dequeued_max,
+                                            ringbufindex_elements(&dequeued_ringbuf));
     }
 
     /* If this is an unicast packet to timesource, update stats */
@@ -748,6 +757,8 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
 
     /* Poll process for later processing of packet sent events and logs */
     process_poll(&tsch_pending_events_process);
+  } else {
+    tsch_ringbuf_stats.dequeued_full++;
   }
 
   TSCH_DEBUG_TX_EVENT();
@@ -780,6 +791,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
   input_index = ringbufindex_peek_put(&input_ringbuf);
   if(input_index == -1) {
     input_queue_drop++;
+    tsch_ringbuf_stats.input_full++;
   } else {
     static struct input_packet *current_input;
     /* Estimated drift based on RX time */
@@ -802,6 +814,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 
     /* Start radio for at least guard time */
     tsch_radio_on(TSCH_RADIO_CMD_ON_WITHIN_TIMESLOT);
+    tsch_profiler_mark(tsch_phase_rx_listen);
     packet_seen = NETSTACK_RADIO.receiving_packet() || NETSTACK_RADIO.pending_packet();
     if(!packet_seen) {
       /* Check if receiving within guard time */
@@ -809,9 +822,11 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
           current_slot_start, tsch_timing[tsch_ts_rx_offset] + tsch_timing[tsch_ts_rx_wait] + RADIO_DELAY_BEFORE_DETECT);
     }
     if(!packet_seen) {
+      tsch_profiler_mark(tsch_phase_rx_idle);
       /* no packets on air */
       tsch_radio_off(TSCH_RADIO_CMD_OFF_FORCE);
     } else {
+      tsch_profiler_mark(tsch_phase_rx_detected);
       TSCH_DEBUG_RX_EVENT();
       /* Save packet timestamp */
       rx_start_time = RTIMER_NOW() - RADIO_DELAY_BEFORE_DETECT;
@@ -831,6 +846,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 
         /* Read packet */
         current_input->len = NETSTACK_RADIO.read((void *)current_input->payload, TSCH_PACKET_MAX_LEN);
+        tsch_profiler_mark(tsch_phase_rx_received);
         NETSTACK_RADIO.get_value(RADIO_PARAM_LAST_RSSI, &radio_last_rssi);
         current_input->rx_asn = tsch_current_asn;
         current_input->rssi = (signed)radio_last_rssi;
@@ -880,6 +896,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
           }
         }
 #endif /* LLSEC802154_ENABLED */
+        tsch_profiler_mark(tsch_phase_rx_verified);
 
         if(frame_valid) {
           /* Check that frome is for us or broadcast, AND that it is not from
@@ -936,6 +953,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
                 TSCH_DEBUG_RX_EVENT();
                 NETSTACK_RADIO.transmit(ack_len);
                 tsch_radio_off(TSCH_RADIO_CMD_OFF_WITHIN_TIMESLOT);
+                tsch_profiler_mark(tsch_phase_rx_ack_sent);
 
                 /* Schedule a burst link iff the frame pending bit was set */
                 burst_link_scheduled = tsch_packet_get_frame_pending(current_input->payload, current_input->len);
@@ -959,6 +977,8 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 
             /* Add current input to ringbuf */
             ringbufindex_put(&input_ringbuf);
+            tsch_ringbuf_stats.input_max = MAX(tsch_ringbuf_stats.input_max,
+                                               ringbufindex_elements(&input_ringbuf));
 
             /* If the neighbor is known, update its stats */
             if(n != NULL) {
@@ -1055,6 +1075,8 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
       }
       is_active_slot = current_packet != NULL || (current_link->link_options & LINK_OPTION_RX);
       if(is_active_slot) {
+        tsch_profiler_slot_start(&tsch_current_asn, current_packet != NULL,
+                                 current_slot_start);
         /* If we are in a burst, we stick to current channel instead of
          * doing channel hopping, as per IEEE 802.15.4-2015 */
         if(burst_link_scheduled) {
@@ -1083,6 +1105,7 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
           static struct pt slot_rx_pt;
           PT_SPAWN(&slot_operation_pt, &slot_rx_pt, tsch_rx_slot(&slot_rx_pt, t));
         }
+        tsch_profiler_mark(tsch_phase_slot_done);
       } else {
         /* Make sure to end the burst in cast, for some reason, we were
          * in a burst but now without any more packet to send. */
@@ -1152,6 +1175,7 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
         prev_slot_start = current_slot_start;
         current_slot_start += time_to_next_active_slot;
       } while(!tsch_schedule_slot_operation(t, prev_slot_start, time_to_next_active_slot, "main"));
+      tsch_profiler_slot_end();
     }
 
     tsch_in_slot_operation = 0;
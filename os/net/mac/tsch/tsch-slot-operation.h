@@ -45,6 +45,21 @@
 #include "contiki.h"
 #include "lib/ringbufindex.h"
 
+/********** Data types **********/
+
+/** \brief Counters of the ring buffers between the slot operation and the
+ * TSCH pending events process */
+struct tsch_ringbuf_stats {
+  /* Receive slots skipped because the input ringbuf was full */
+  uint32_t input_full;
+  /* Transmit slots skipped because the dequeued ringbuf was full */
+  uint32_t dequeued_full;
+  /* Highest number of packets in the input ringbuf */
+  uint16_t input_max;
+  /* Highest number of packets in the dequeued ringbuf */
+  uint16_t dequeued_max;
+};
+
 /***** External Variables *****/
 
 /* A ringbuf storing outgoing packets after they were dequeued.
@@ -55,6 +70,8 @@ extern struct tsch_packet *dequeued_array[TSCH_DEQUEUED_ARRAY_SIZE];
  * Will be processed layer by tsch_rx_process_pending */
 extern struct ringbufindex input_ringbuf;
 extern struct input_packet input_array[TSCH_MAX_INCOMING_PACKETS];
+/* Counters of the input and dequeued ringbufs */
+extern struct tsch_ringbuf_stats tsch_ringbuf_stats;
 /* Last clock_time_t where synchronization happened */
 extern clock_time_t tsch_last_sync_time;
 /* Counts the length of the current burst */
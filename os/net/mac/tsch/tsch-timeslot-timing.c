@@ -46,6 +46,8 @@
 #include "contiki.h"
 #include "net/mac/tsch/tsch.h"
 
+#include <string.h>
+
 /**
  * \brief TSCH timing attributes and description. All timings are in usec.
  *
@@ -93,4 +95,133 @@ const tsch_timeslot_timing_usec tsch_timeslot_timing_us_10000 = {
   10000, /* TimeslotLength */
 };
 
+/**
+ * Shorter timeslot templates, for 2.4 GHz O-QPSK (250 kbps) radios on
+ * platforms fast enough to load (and secure) a frame within about 1 ms
+ * of the slot start and to turn an ACK around within TxAckDelay.
+ *
+ * Both templates trade the maximum frame length and the guard time for
+ * slot length. MaxTx bounds the longest frame that fits the slot,
+ * see tsch_timeslot_timing_max_frame_len(): the MAC reports a reduced
+ * max_payload accordingly so that 6LoWPAN fragments to fit. The
+ * narrower Rx guard time calls for frequent resynchronization, e.g.
+ * TSCH_CONF_ADAPTIVE_TIMESYNC or a shorter TSCH_CONF_KEEPALIVE_TIMEOUT.
+ *
+ * 7 ms: frames of up to 97 bytes, 1200 us guard time.
+ */
+const tsch_timeslot_timing_usec tsch_timeslot_timing_us_7000 = {
+   1200, /* CCAOffset */
+    128, /* CCA */
+   1500, /* TxOffset */
+  (1500 - (1200 / 2)), /* RxOffset */
+    600, /* RxAckDelay */
+    800, /* TxAckDelay */
+   1200, /* RxWait */
+    400, /* AckWait */
+    192, /* RxTx */
+   1248, /* MaxAck */
+   3200, /* MaxTx */
+   7000, /* TimeslotLength */
+};
+
+/* 5 ms: frames of up to 63 bytes, 800 us guard time. */
+const tsch_timeslot_timing_usec tsch_timeslot_timing_us_5000 = {
+    700, /* CCAOffset */
+    128, /* CCA */
+   1000, /* TxOffset */
+  (1000 - (800 / 2)), /* RxOffset */
+    400, /* RxAckDelay */
+    600, /* TxAckDelay */
+    800, /* RxWait */
+    400, /* AckWait */
+    192, /* RxTx */
+   1056, /* MaxAck */
+   2112, /* MaxTx */
+   5000, /* TimeslotLength */
+};
+
+/* Templates that can be advertised by ID, indexed by template ID - 1 */
+static const uint16_t *const templates[] = {
+  tsch_timeslot_timing_us_10000, /* TSCH_TIMESLOT_TEMPLATE_ID_10000 */
+  tsch_timeslot_timing_us_7000,  /* TSCH_TIMESLOT_TEMPLATE_ID_7000 */
+  tsch_timeslot_timing_us_5000,  /* TSCH_TIMESLOT_TEMPLATE_ID_5000 */
+};
+/*---------------------------------------------------------------------------*/
+const uint16_t *
+tsch_timeslot_timing_get_template(uint8_t id)
+{
+  if(id == 0 || id > sizeof(templates) / sizeof(templates[0])) {
+    return NULL;
+  }
+  return templates[id - 1];
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+tsch_timeslot_timing_get_template_id(const uint16_t *timing_us)
+{
+  uint8_t i;
+  for(i = 0; i < sizeof(templates) / sizeof(templates[0]); i++) {
+    if(memcmp(timing_us, templates[i], sizeof(tsch_timeslot_timing_usec)) == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_timeslot_timing_is_valid(const uint16_t *timing_us)
+{
+  uint32_t tx_end;
+
+  if(timing_us[tsch_ts_timeslot_length] == 0
+     || timing_us[tsch_ts_max_tx] == 0) {
+    return 0;
+  }
+  /* CCA must complete before the frame goes out */
+  if((uint32_t)timing_us[tsch_ts_cca_offset] + timing_us[tsch_ts_cca]
+     > timing_us[tsch_ts_tx_offset]) {
+    return 0;
+  }
+  /* The Rx guard window must cover the expected start of frame */
+  if(timing_us[tsch_ts_rx_offset] > timing_us[tsch_ts_tx_offset]
+     || (uint32_t)timing_us[tsch_ts_rx_offset] + timing_us[tsch_ts_rx_wait]
+     < timing_us[tsch_ts_tx_offset]) {
+    return 0;
+  }
+  /* The ACK wait window must cover the expected start of ACK */
+  if(timing_us[tsch_ts_rx_ack_delay] > timing_us[tsch_ts_tx_ack_delay]
+     || (uint32_t)timing_us[tsch_ts_rx_ack_delay] + timing_us[tsch_ts_ack_wait]
+     < timing_us[tsch_ts_tx_ack_delay]) {
+    return 0;
+  }
+  /* A max length frame and its ACK must fit in the slot */
+  tx_end = (uint32_t)timing_us[tsch_ts_tx_offset] + timing_us[tsch_ts_max_tx];
+  if(tx_end + timing_us[tsch_ts_tx_ack_delay] + timing_us[tsch_ts_max_ack]
+     > timing_us[tsch_ts_timeslot_length]) {
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const uint16_t *
+tsch_timeslot_timing_from_ies(const struct ieee802154_ies *ies,
+                              const uint16_t *default_timing_us)
+{
+  if(ies->ie_tsch_timeslot_id == 0) {
+    return default_timing_us;
+  }
+  if(ies->ie_tsch_timeslot_id_only) {
+    return tsch_timeslot_timing_get_template(ies->ie_tsch_timeslot_id);
+  }
+  return tsch_timeslot_timing_is_valid(ies->ie_tsch_timeslot)
+    ? ies->ie_tsch_timeslot : NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_timeslot_timing_max_frame_len(const uint16_t *timing_us)
+{
+  int len = timing_us[tsch_ts_max_tx] / RADIO_BYTE_AIR_TIME - RADIO_PHY_OVERHEAD;
+  return len > 0 ? len : 0;
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
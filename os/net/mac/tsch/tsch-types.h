@@ -91,6 +91,11 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+  /* The links of this slotframe in the schedule index */
+  uint16_t index_start;
+  uint16_t index_count;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 };
 
 /** \brief TSCH packet information */
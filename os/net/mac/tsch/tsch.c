@@ -484,18 +484,33 @@ eb_input(struct input_packet *current_input)
   }
 }
 /*---------------------------------------------------------------------------*/
-/* Process pending input packet(s) */
-static void
+/* Process pending input packet(s). Returns 1 if packets remain. */
+static int
 tsch_rx_process_pending()
 {
   int16_t input_index;
+  unsigned processed = 0;
+#ifdef TSCH_CALLBACK_INPUT_BATCH_START
+  if(!ringbufindex_empty(&input_ringbuf)) {
+    TSCH_CALLBACK_INPUT_BATCH_START(ringbufindex_elements(&input_ringbuf));
+  }
+#endif
   /* Loop on accessing (without removing) a pending input packet */
   while((input_index = ringbufindex_peek_get(&input_ringbuf)) != -1) {
     struct input_packet *current_input = &input_array[input_index];
     frame802154_t frame;
-    uint8_t ret = frame802154_parse(current_input->payload, current_input->len, &frame);
-    int is_data = ret && frame.fcf.frame_type == FRAME802154_DATAFRAME;
-    int is_eb = ret
+    uint8_t ret;
+    int is_data;
+    int is_eb;
+
+    if(TSCH_PENDING_BATCH_SIZE != 0 && processed == TSCH_PENDING_BATCH_SIZE) {
+      break;
+    }
+    processed++;
+
+    ret = frame802154_parse(current_input->payload, current_input->len, &frame);
+    is_data = ret && frame.fcf.frame_type == FRAME802154_DATAFRAME;
+    is_eb = ret
       && frame.fcf.frame_version == FRAME802154_IEEE802154_2015
       && frame.fcf.frame_type == FRAME802154_BEACONFRAME;
 
@@ -517,16 +532,27 @@ tsch_rx_process_pending()
     /* Remove input from ringbuf */
     ringbufindex_get(&input_ringbuf);
   }
+#ifdef TSCH_CALLBACK_INPUT_BATCH_END
+  if(processed > 0) {
+    TSCH_CALLBACK_INPUT_BATCH_END(processed);
+  }
+#endif
+  return input_index != -1;
 }
 /*---------------------------------------------------------------------------*/
-/* Pass sent packets to upper layer */
-static void
+/* Pass sent packets to upper layer. Returns 1 if packets remain. */
+static int
 tsch_tx_process_pending(void)
 {
   int16_t dequeued_index;
+  unsigned processed = 0;
   /* Loop on accessing (without removing) a pending input packet */
   while((dequeued_index = ringbufindex_peek_get(&dequeued_ringbuf)) != -1) {
     struct tsch_packet *p = dequeued_array[dequeued_index];
+    if(TSCH_PENDING_BATCH_SIZE != 0 && processed == TSCH_PENDING_BATCH_SIZE) {
+      break;
+    }
+    processed++;
     /* Put packet into packetbuf for packet_sent callback */
     queuebuf_to_packetbuf(p->qb);
     LOG_INFO("packet sent to ");
@@ -537,11 +563,14 @@ tsch_tx_process_pending(void)
     mac_call_sent_callback(p->sent, p->ptr, p->ret, p->transmissions);
     /* Free packet queuebuf */
     tsch_queue_free_packet(p);
-    /* Free all unused neighbors */
-    tsch_queue_free_unused_neighbors();
     /* Remove dequeued packet from ringbuf */
     ringbufindex_get(&dequeued_ringbuf);
   }
+  if(processed > 0) {
+    /* Free all unused neighbors, once per batch */
+    tsch_queue_free_unused_neighbors();
+  }
+  return dequeued_index != -1;
 }
 /*---------------------------------------------------------------------------*/
 /* Setup TSCH as a coordinator */
@@ -585,6 +614,7 @@ tsch_associate(const struct input_packet *input_eb, rtimer_clock_t timestamp)
   struct ieee802154_ies ies;
   uint8_t hdrlen;
   int i;
+  const uint16_t *timing_us;
 
   if(input_eb == NULL || tsch_packet_parse_eb(input_eb->payload, input_eb->len,
                                               &frame, &ies, &hdrlen, 0) == 0) {
@@ -633,12 +663,17 @@ tsch_associate(const struct input_packet *input_eb, rtimer_clock_t timestamp)
   }
 
   /* TSCH timeslot timing */
-  for(i = 0; i < tsch_ts_elements_count; i++) {
-    if(ies.ie_tsch_timeslot_id == 0) {
-      tsch_timing_us[i] = tsch_default_timing_us[i];
+  timing_us = tsch_timeslot_timing_from_ies(&ies, tsch_default_timing_us);
+  if(timing_us == NULL) {
+    if(ies.ie_tsch_timeslot_id_only) {
+      LOG_ERR("! parse_eb: unknown timeslot template %u\n", ies.ie_tsch_timeslot_id);
     } else {
-      tsch_timing_us[i] = ies.ie_tsch_timeslot[i];
+      LOG_ERR("! parse_eb: inconsistent timeslot timing\n");
     }
+    return 0;
+  }
+  for(i = 0; i < tsch_ts_elements_count; i++) {
+    tsch_timing_us[i] = timing_us[i];
     tsch_timing[i] = US_TO_RTIMERTICKS(tsch_timing_us[i]);
   }
 
@@ -954,16 +989,22 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
  * callbacks, outputs pending logs. */
 PROCESS_THREAD(tsch_pending_events_process, ev, data)
 {
+  int pending;
+
   PROCESS_BEGIN();
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
-    tsch_rx_process_pending();
-    tsch_tx_process_pending();
+    pending = tsch_rx_process_pending();
+    pending |= tsch_tx_process_pending();
     tsch_log_process_pending();
     tsch_keepalive_process_pending();
 #ifdef TSCH_CALLBACK_SELECT_CHANNELS
     TSCH_CALLBACK_SELECT_CHANNELS();
 #endif
+    if(pending) {
+      /* Batch budget used up: continue after other processes have run */
+      process_poll(&tsch_pending_events_process);
+    }
   }
   PROCESS_END();
 }
@@ -985,6 +1026,9 @@ tsch_init(void)
     LOG_ERR("! platform does not provide a timeslot timing template.\n");
     return;
   }
+  if(!tsch_timeslot_timing_is_valid(TSCH_DEFAULT_TIMESLOT_TIMING)) {
+    LOG_WARN("! inconsistent default timeslot timing template\n");
+  }
 
   /* Check that the radio can correctly report its max supported payload */
   if(NETSTACK_RADIO.get_value(RADIO_CONST_MAX_PAYLOAD_LEN, &radio_max_payload_len) != RADIO_RESULT_OK) {
@@ -1060,6 +1104,7 @@ tsch_init(void)
 #endif
 
   tsch_stats_init();
+  tsch_profiler_init();
 }
 /*---------------------------------------------------------------------------*/
 /* Function send for TSCH-MAC, puts the packet in packetbuf in the MAC queue */
@@ -1244,7 +1289,8 @@ max_payload(void)
   }
 
   /* Setup security... before. */
-  return MIN(max_radio_payload_len, TSCH_PACKET_MAX_LEN)
+  return MIN(MIN(max_radio_payload_len, TSCH_PACKET_MAX_LEN),
+             tsch_timeslot_timing_max_frame_len(tsch_timing_us))
     - framer_hdrlen
     - LLSEC802154_PACKETBUF_MIC_LEN();
 }
@@ -61,6 +61,7 @@ frequency hopping for enhanced reliability.
 #include "net/mac/tsch/tsch-security.h"
 #include "net/mac/tsch/tsch-schedule.h"
 #include "net/mac/tsch/tsch-stats.h"
+#include "net/mac/tsch/tsch-profiler.h"
 #if UIP_CONF_IPV6_RPL
 #include "net/mac/tsch/tsch-rpl.h"
 #endif /* UIP_CONF_IPV6_RPL */
@@ -143,6 +144,18 @@ void TSCH_CALLBACK_NEW_TIME_SOURCE(const struct tsch_neighbor *old, const struct
 int TSCH_CALLBACK_PACKET_READY(void);
 #endif
 
+/* Called by TSCH before passing a batch of received frames to the upper
+ * layers, with the number of frames pending */
+#ifdef TSCH_CALLBACK_INPUT_BATCH_START
+void TSCH_CALLBACK_INPUT_BATCH_START(unsigned pending);
+#endif
+
+/* Called by TSCH after passing a batch of received frames to the upper
+ * layers, with the number of frames processed */
+#ifdef TSCH_CALLBACK_INPUT_BATCH_END
+void TSCH_CALLBACK_INPUT_BATCH_END(unsigned processed);
+#endif
+
 /***** External Variables *****/
 
 /* Are we coordinator of the TSCH network? */
@@ -179,6 +192,9 @@ extern int32_t min_drift_seen;
 extern int32_t max_drift_seen;
 /* The TSCH standard 10ms timeslot timing */
 extern const tsch_timeslot_timing_usec tsch_timeslot_timing_us_10000;
+/* Shorter 7ms and 5ms timeslot timings, for fast 2.4 GHz radios */
+extern const tsch_timeslot_timing_usec tsch_timeslot_timing_us_7000;
+extern const tsch_timeslot_timing_usec tsch_timeslot_timing_us_5000;
 
 /* TSCH processes */
 PROCESS_NAME(tsch_process);
@@ -250,6 +266,46 @@ uint64_t tsch_get_network_uptime_ticks(void);
   * Leave the TSCH network we are currently in
   */
 void tsch_disassociate(void);
+/**
+  * Get a timeslot timing template from its ID, as advertised in EBs
+  *
+  * \param id The template ID, one of TSCH_TIMESLOT_TEMPLATE_ID_*
+  * \return The timing template (in micro-seconds), or NULL if unknown
+  */
+const uint16_t *tsch_timeslot_timing_get_template(uint8_t id);
+/**
+  * Get the ID of a timeslot timing template
+  *
+  * \param timing_us The timeslot timing, in micro-seconds
+  * \return The template ID, or 0 if the timing matches no known template
+  */
+uint8_t tsch_timeslot_timing_get_template_id(const uint16_t *timing_us);
+/**
+  * Check the consistency of a timeslot timing: guard windows covering the
+  * expected Tx and ACK, and a max length frame plus its ACK fitting the slot
+  *
+  * \param timing_us The timeslot timing, in micro-seconds
+  * \return 1 if the timing is consistent, 0 otherwise
+  */
+int tsch_timeslot_timing_is_valid(const uint16_t *timing_us);
+/**
+  * Get the timeslot timing advertised by the timeslot IE of an EB
+  *
+  * \param ies The IEs parsed from the EB
+  * \param default_timing_us The timing to use for timeslot template ID 0
+  * \return The timing (in micro-seconds), or NULL if the IE refers to an
+  * unknown template or carries an inconsistent timing
+  */
+const uint16_t *tsch_timeslot_timing_from_ies(const struct ieee802154_ies *ies,
+                                              const uint16_t *default_timing_us);
+/**
+  * Get the longest frame (in bytes, PHY overhead excluded) that fits in
+  * the MaxTx of a timeslot timing
+  *
+  * \param timing_us The timeslot timing, in micro-seconds
+  * \return The max frame length
+  */
+int tsch_timeslot_timing_max_frame_len(const uint16_t *timing_us);
 
 #endif /* __TSCH_H__ */
 /** @} */
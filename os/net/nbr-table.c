@@ -38,6 +38,7 @@
 #include <string.h>
 #include "lib/memb.h"
 #include "lib/list.h"
+#include "lib/addr-hash.h"
 #include "net/nbr-table.h"
 
 #define DEBUG 0
@@ -83,6 +84,23 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_HASH_INDEX
+/* Hash index over the link-layer addresses of the keys. Each slot holds
+ * a neighbor index plus one, or zero if empty. */
+#define HASH_SIZE ADDR_HASH_SIZE_AT_LEAST(2 * NBR_TABLE_MAX_NEIGHBORS)
+
+#if NBR_TABLE_MAX_NEIGHBORS > 2047
+#error "NBR_TABLE_HASH_INDEX supports up to 2047 neighbors"
+#elif NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t hash_slot_t;
+#else
+typedef uint16_t hash_slot_t;
+#endif
+
+static unsigned hash_home(unsigned entry);
+ADDR_HASH(hash_index, HASH_SIZE, hash_slot_t, hash_home);
+#endif /* NBR_TABLE_HASH_INDEX */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -126,16 +144,60 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_HASH_INDEX
+/* Get the home slot of a link-layer address in the hash index */
+static unsigned
+hash_slot(const linkaddr_t *lladdr)
+{
+  uint32_t hash = addr_hash_fnv1a(ADDR_HASH_FNV1A_INIT, lladdr, LINKADDR_SIZE);
+
+  return addr_hash_fold(hash, hash_index.mask);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+hash_home(unsigned entry)
+{
+  return hash_slot(&key_from_index(entry - 1)->lladdr);
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the hash index */
+static void
+hash_insert(nbr_table_key_t *key)
+{
+  addr_hash_insert(&hash_index, hash_slot(&key->lladdr), index_from_key(key) + 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash index */
+static void
+hash_remove(nbr_table_key_t *key)
+{
+  addr_hash_remove(&hash_index, hash_slot(&key->lladdr), index_from_key(key) + 1);
+}
+#endif /* NBR_TABLE_HASH_INDEX */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_HASH_INDEX
+  unsigned slot;
+  unsigned entry;
+#else
   nbr_table_key_t *key;
+#endif
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_HASH_INDEX
+  for(slot = hash_slot(lladdr); (entry = addr_hash_get(&hash_index, slot)) != 0;
+      slot = addr_hash_next(&hash_index, slot)) {
+    if(linkaddr_cmp(lladdr, &key_from_index(entry - 1)->lladdr)) {
+      return entry - 1;
+    }
+  }
+#else
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -143,6 +205,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -195,6 +258,9 @@ remove_key(nbr_table_key_t *least_used_key)
   used_map[index_from_key(least_used_key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+#if NBR_TABLE_HASH_INDEX
+  hash_remove(least_used_key);
+#endif /* NBR_TABLE_HASH_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
@@ -381,6 +447,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_HASH_INDEX
+    hash_insert(key);
+#endif /* NBR_TABLE_HASH_INDEX */
   }
 
   /* Get item in the current table */
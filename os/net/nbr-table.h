@@ -46,6 +46,14 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Keep a hash index of the link-layer addresses, for constant-time
+ * lookups in large tables. Costs 2 to 4 bytes of RAM per neighbor. */
+#ifdef NBR_TABLE_CONF_HASH_INDEX
+#define NBR_TABLE_HASH_INDEX NBR_TABLE_CONF_HASH_INDEX
+#else /* NBR_TABLE_CONF_HASH_INDEX */
+#define NBR_TABLE_HASH_INDEX 0
+#endif /* NBR_TABLE_CONF_HASH_INDEX */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
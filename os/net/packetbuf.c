@@ -62,6 +62,9 @@ static uint8_t hdrlen;
 static uint32_t packetbuf_aligned[(PACKETBUF_SIZE + 3) / 4];
 static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 
+/* Set when packetbuf points to an attached, read-only buffer */
+static packetbuf_release_t attached_release;
+
 #define DEBUG 0
 #if DEBUG
 #include <stdio.h>
@@ -70,10 +73,23 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static void
+release_attached(void)
+{
+  packetbuf_release_t release = attached_release;
+
+  if(release != NULL) {
+    attached_release = NULL;
+    release(packetbuf);
+    packetbuf = (uint8_t *)packetbuf_aligned;
+  }
+}
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_clear(void)
 {
+  release_attached();
   buflen = bufptr = 0;
   hdrlen = 0;
 
@@ -91,6 +107,25 @@ packetbuf_copyfrom(const void *from, uint16_t len)
   buflen = l;
   return l;
 }
+void
+packetbuf_attach(void *data, uint16_t len, packetbuf_release_t release)
+{
+  packetbuf_clear();
+  packetbuf = data;
+  attached_release = release;
+  buflen = MIN(PACKETBUF_SIZE, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_detach(void)
+{
+  const uint8_t *data = packetbuf;
+
+  if(attached_release != NULL) {
+    memcpy(packetbuf_aligned, data, packetbuf_totlen());
+    release_attached();
+  }
+}
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_copyto(void *to)
@@ -98,23 +133,35 @@ packetbuf_copyto(void *to)
   if(hdrlen + buflen > PACKETBUF_SIZE) {
     return 0;
   }
-  memcpy(to, packetbuf_hdrptr(), hdrlen);
-  memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
+  if(to == packetbuf) {
+    /* The packetbuf is attached to the destination buffer: only the data
+       after a header reduced by packetbuf_hdrreduce() has to move */
+    if(bufptr != 0 || hdrlen != 0) {
+      memmove((uint8_t *)to + hdrlen, packetbuf + packetbuf_hdrlen(), buflen);
+      bufptr = 0;
+    }
+    return hdrlen + buflen;
+  }
+  memcpy(to, packetbuf, hdrlen);
+  memcpy((uint8_t *)to + hdrlen, packetbuf + packetbuf_hdrlen(), buflen);
   return hdrlen + buflen;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_hdralloc(int size)
 {
-  int16_t i;
+  const uint8_t *data = packetbuf;
 
   if(size + packetbuf_totlen() > PACKETBUF_SIZE) {
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
-    packetbuf[i + size] = packetbuf[i];
+  /* shift data to the right, copying it out of an attached buffer */
+  if(attached_release != NULL) {
+    memcpy((uint8_t *)packetbuf_aligned + size, data, packetbuf_totlen());
+    release_attached();
+  } else {
+    memmove(packetbuf + size, packetbuf, packetbuf_totlen());
   }
   hdrlen += size;
   return 1;
@@ -142,12 +189,14 @@ packetbuf_set_datalen(uint16_t len)
 void *
 packetbuf_dataptr(void)
 {
+  packetbuf_detach();
   return packetbuf + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_hdrptr(void)
 {
+  packetbuf_detach();
   return packetbuf;
 }
 /*---------------------------------------------------------------------------*/
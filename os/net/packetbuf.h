@@ -192,6 +192,45 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+/**
+ * \brief      Function called when the packetbuf no longer refers to
+ *             an attached buffer
+ * \param data The data pointer that was passed to packetbuf_attach()
+ */
+typedef void (*packetbuf_release_t)(void *data);
+
+/**
+ * \brief         Make the packetbuf refer to a buffer instead of copying it
+ * \param data    A pointer to the packet, which must be 32-bit aligned
+ * \param len     The length of the packet
+ * \param release The function to call when the packetbuf no longer
+ *                refers to the buffer
+ *
+ *                This function clears the packetbuf and makes it hold
+ *                the packet in an external buffer, without copying
+ *                it. The buffer is treated as read-only: it is copied
+ *                into the packetbuf's own storage the first time that
+ *                packetbuf_dataptr(), packetbuf_hdrptr() or
+ *                packetbuf_hdralloc() is called, since the caller may
+ *                then write to the packet. Until the packet is cleared
+ *                or copied, the owner of the buffer must keep it
+ *                unchanged; it is typically reference counted, with
+ *                one reference held by the packetbuf.
+ *
+ */
+void packetbuf_attach(void *data, uint16_t len, packetbuf_release_t release);
+
+/**
+ * \brief      Copy an attached buffer into the packetbuf's own storage
+ *
+ *             This function releases the buffer that the packetbuf
+ *             refers to, if any, after copying the packet into the
+ *             packetbuf. It is called implicitly by all functions that
+ *             return a writable pointer to the packet.
+ *
+ */
+void packetbuf_detach(void);
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
@@ -224,6 +263,7 @@ enum {
   PACKETBUF_ATTR_MAC_METADATA,
   PACKETBUF_ATTR_MAC_NO_SRC_ADDR,
   PACKETBUF_ATTR_MAC_NO_DEST_ADDR,
+  PACKETBUF_ATTR_MAC_FRAME_PENDING,
 #if TSCH_WITH_LINK_SELECTOR
   PACKETBUF_ATTR_TSCH_SLOTFRAME,
   PACKETBUF_ATTR_TSCH_TIMESLOT,
@@ -71,10 +71,13 @@ struct queuebuf {
 #endif
 };
 
-/* The actual queuebuf data */
+/* The actual queuebuf data. The data is also referenced by the
+   packetbuf after queuebuf_to_packetbuf(), hence the reference count
+   and the alignment required by packetbuf_attach(). */
 struct queuebuf_data {
-  uint8_t data[PACKETBUF_SIZE];
+  uint8_t data[PACKETBUF_SIZE] CC_ALIGN(4);
   uint16_t len;
+  uint8_t refs;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
@@ -277,6 +280,18 @@ queuebuf_load_to_ram(struct queuebuf *b)
 }
 #endif /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
+/* Drop a reference to queuebuf data, held either by a queuebuf or by
+   the packetbuf. */
+static void
+queuebuf_data_release(void *data)
+{
+  struct queuebuf_data *buframptr = data;
+
+  if(--buframptr->refs == 0) {
+    memb_free(&buframmem, buframptr);
+  }
+}
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_init(void)
 {
@@ -320,6 +335,15 @@ queuebuf_new_from_packetbuf(void)
     buf->time = clock_time();
 #endif /* QUEUEBUF_DEBUG */
     buf->ram_ptr = memb_alloc(&buframmem);
+    if(buf->ram_ptr == NULL) {
+      /* The packetbuf may hold the last reference to a block, release
+         it by copying the packet. */
+      packetbuf_detach();
+      buf->ram_ptr = memb_alloc(&buframmem);
+    }
+    if(buf->ram_ptr != NULL) {
+      buf->ram_ptr->refs = 1;
+    }
 #if WITH_SWAP
     /* If the allocation failed, store the qbuf in swap files */
     if(buf->ram_ptr != NULL) {
@@ -398,12 +422,12 @@ queuebuf_free(struct queuebuf *buf)
   if(memb_inmemb(&bufmem, buf)) {
 #if WITH_SWAP
     if(buf->location == IN_RAM) {
-      memb_free(&buframmem, buf->ram_ptr);
+      queuebuf_data_release(buf->ram_ptr);
     } else {
       queuebuf_remove_from_file(buf->swap_id);
     }
 #else
-    memb_free(&buframmem, buf->ram_ptr);
+    queuebuf_data_release(buf->ram_ptr);
 #endif
     memb_free(&bufmem, buf);
 #if QUEUEBUF_STATS
@@ -421,7 +445,18 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-    packetbuf_copyfrom(buframptr->data, buframptr->len);
+#if WITH_SWAP
+    if(b->location == IN_CFS) {
+      /* The swap cache is reused, copy the data */
+      packetbuf_copyfrom(buframptr->data, buframptr->len);
+      packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+      return;
+    }
+#endif
+    /* Let the packetbuf refer to the data, which is only copied if
+       the packet is modified */
+    buframptr->refs++;
+    packetbuf_attach(buframptr->data, buframptr->len, queuebuf_data_release);
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
   }
 }
@@ -277,18 +277,6 @@ rpl_ext_header_srh_update(void)
 }
 /*---------------------------------------------------------------------------*/
 static int
-count_matching_bytes(const void *p1, const void *p2, size_t n)
-{
-  int i = 0;
-  for(i = 0; i < n; i++) {
-    if(((uint8_t *)p1)[i] != ((uint8_t *)p2)[i]) {
-      return i;
-    }
-  }
-  return n;
-}
-/*---------------------------------------------------------------------------*/
-static int
 insert_srh_header(void)
 {
   /* Implementation of RFC6554 */
@@ -298,7 +286,7 @@ insert_srh_header(void)
   uint8_t *hop_ptr;
   uint8_t padding;
   uip_sr_node_t *dest_node;
-  uip_sr_node_t *root_node;
+  const uip_sr_path_t *path;
   uip_sr_node_t *node;
   rpl_dag_t *dag;
   uip_ipaddr_t node_addr;
@@ -327,44 +315,23 @@ insert_srh_header(void)
     return 1;
   }
 
-  root_node = uip_sr_get_node(dag, &dag->dag_id);
-  if(root_node == NULL) {
-    LOG_ERR("SRH root node not found\n");
-    return 0;
-  }
-
-  if(!uip_sr_is_addr_reachable(dag, &UIP_IP_BUF->destipaddr)) {
+  path = uip_sr_get_path(dag, &UIP_IP_BUF->destipaddr);
+  if(path == NULL) {
     LOG_ERR("SRH no path found to destination\n");
     return 0;
   }
 
-  /* Compute path length and compression factors (we use cmpri == cmpre) */
-  path_len = 0;
-  node = dest_node->parent;
-  /* For simplicity, we use cmpri = cmpre */
-  cmpri = 15;
-  cmpre = 15;
+  /* Path length and compression factors, computed by uip-sr along with
+   * the path. For simplicity, we use cmpri = cmpre */
+  path_len = path->len;
+  cmpri = path->common_bytes;
+  cmpre = cmpri;
 
-  if(node == root_node) {
+  if(path_len == 0) {
     LOG_DBG("SRH no need to insert SRH\n");
     return 1;
   }
 
-  while(node != NULL && node != root_node) {
-
-    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
-
-    /* How many bytes in common between all nodes in the path? */
-    cmpri = MIN(cmpri, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
-    cmpre = cmpri;
-
-    LOG_DBG("SRH Hop ");
-    LOG_DBG_6ADDR(&node_addr);
-    LOG_DBG_("\n");
-    node = node->parent;
-    path_len++;
-  }
-
   /* Extension header length: fixed headers + (n-1) * (16-ComprI) + (16-ComprE)*/
   ext_len = RPL_RH_LEN + RPL_SRH_LEN
       + (path_len - 1) * (16 - cmpre)
@@ -405,8 +372,11 @@ insert_srh_header(void)
   node = dest_node;
   hop_ptr = ((uint8_t *)rh_hdr) + ext_len - padding; /* Pointer where to write the next hop compressed address */
 
-  while(node != NULL && node->parent != root_node) {
+  while(node != path->first_hop) {
     NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+    LOG_DBG("SRH Hop ");
+    LOG_DBG_6ADDR(&node_addr);
+    LOG_DBG_("\n");
 
     hop_ptr -= (16 - cmpri);
     memcpy(hop_ptr, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
@@ -415,7 +385,7 @@ insert_srh_header(void)
   }
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
-  NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+  NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, path->first_hop);
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field */
@@ -129,6 +129,44 @@
 #define RPL_WITH_DAO_ACK 1
 #endif /* RPL_CONF_WITH_DAO_ACK */
 
+/*
+ * DAO batching at the root. When set to a non-zero value, DAOs are
+ * queued, up to this number, and applied to the source routing graph
+ * together from a timer, after RPL_DAO_BATCH_DELAY, or right away once
+ * the batch is full. A DAO arriving while the batch is still full drops
+ * the oldest queued one. DAOs from the same node replace each other, and
+ * DAO-ACKs are sent once the batch is applied.
+ * */
+#ifdef RPL_CONF_DAO_BATCH_SIZE
+#define RPL_DAO_BATCH_SIZE RPL_CONF_DAO_BATCH_SIZE
+#else
+#define RPL_DAO_BATCH_SIZE 0
+#endif /* RPL_CONF_DAO_BATCH_SIZE */
+
+#ifdef RPL_CONF_DAO_BATCH_DELAY
+#define RPL_DAO_BATCH_DELAY RPL_CONF_DAO_BATCH_DELAY
+#else
+#define RPL_DAO_BATCH_DELAY (CLOCK_SECOND / 16)
+#endif /* RPL_CONF_DAO_BATCH_DELAY */
+
+/*
+ * Source routing header cache at the root. When set to a non-zero value,
+ * the compressed source routes of this number of recent destinations are
+ * kept, until the source routing graph changes. Routes with more than
+ * RPL_SRH_CACHE_MAX_LEN bytes of addresses are not cached.
+ * */
+#ifdef RPL_CONF_SRH_CACHE_SIZE
+#define RPL_SRH_CACHE_SIZE RPL_CONF_SRH_CACHE_SIZE
+#else
+#define RPL_SRH_CACHE_SIZE 0
+#endif /* RPL_CONF_SRH_CACHE_SIZE */
+
+#ifdef RPL_CONF_SRH_CACHE_MAX_LEN
+#define RPL_SRH_CACHE_MAX_LEN RPL_CONF_SRH_CACHE_MAX_LEN
+#else
+#define RPL_SRH_CACHE_MAX_LEN 32
+#endif /* RPL_CONF_SRH_CACHE_MAX_LEN */
+
 /*
  * Setting the RPL_TRICKLE_REFRESH_DAO_ROUTES will make the RPL root
  * increase the DTSN (Destination Advertisement Trigger Sequence Number)
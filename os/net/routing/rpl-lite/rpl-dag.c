@@ -61,6 +61,16 @@ static int process_dio_init_dag(rpl_dio_t *dio);
 /* Allocate instance table. */
 rpl_instance_t curr_instance;
 
+#if RPL_DAO_BATCH_SIZE
+/* DAOs received at the root and not yet applied to the source routing
+ * graph, in order of arrival */
+static struct {
+  uip_ipaddr_t from;
+  rpl_dao_t dao;
+} dao_batch[RPL_DAO_BATCH_SIZE];
+static uint8_t dao_batch_len;
+#endif /* RPL_DAO_BATCH_SIZE */
+
 /*---------------------------------------------------------------------------*/
 
 #ifdef RPL_VALIDATE_DIO_FUNC
@@ -114,6 +124,9 @@ rpl_dag_leave(void)
   /* Remove all neighbors, links and default route */
   rpl_neighbor_remove_all();
   uip_sr_free_all();
+#if RPL_DAO_BATCH_SIZE
+  dao_batch_len = 0;
+#endif /* RPL_DAO_BATCH_SIZE */
 
   /* Stop all timers */
   rpl_timers_stop_dag_timers();
@@ -629,23 +642,93 @@ rpl_process_dis(uip_ipaddr_t *from, int is_multicast)
   }
 }
 /*---------------------------------------------------------------------------*/
-void
-rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
+static int
+update_sr_graph(uip_ipaddr_t *from, rpl_dao_t *dao)
 {
   if(dao->lifetime == 0) {
     uip_sr_expire_parent(NULL, from, &dao->parent_addr);
   } else {
     if(!uip_sr_update_node(NULL, from, &dao->parent_addr, RPL_LIFETIME(dao->lifetime))) {
       LOG_ERR("failed to add link on incoming DAO\n");
-      return;
+      return 0;
     }
   }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_DAO_BATCH_SIZE
+/* Queue a DAO in the batch. When the batch is full, the oldest DAO is
+ * dropped and the batch timer fires right away. The batch is never
+ * applied from here: this runs while uip_buf holds the incoming DAO, and
+ * applying the batch sends DAO-ACKs. */
+static void
+batch_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
+{
+  int i;
+
+  /* A new DAO from the same node replaces the queued one */
+  for(i = 0; i < dao_batch_len; i++) {
+    if(uip_ipaddr_cmp(&dao_batch[i].from, from)) {
+      memmove(&dao_batch[i], &dao_batch[i + 1],
+              (dao_batch_len - i - 1) * sizeof(dao_batch[0]));
+      dao_batch_len--;
+      break;
+    }
+  }
+
+  if(dao_batch_len == RPL_DAO_BATCH_SIZE) {
+    LOG_WARN("DAO batch full, dropping DAO from ");
+    LOG_WARN_6ADDR(&dao_batch[0].from);
+    LOG_WARN_("\n");
+    memmove(&dao_batch[0], &dao_batch[1],
+            (dao_batch_len - 1) * sizeof(dao_batch[0]));
+    dao_batch_len--;
+  }
+
+  uip_ipaddr_copy(&dao_batch[dao_batch_len].from, from);
+  dao_batch[dao_batch_len].dao = *dao;
+  dao_batch_len++;
+  rpl_timers_schedule_dao_batch(dao_batch_len == RPL_DAO_BATCH_SIZE ?
+                                0 : RPL_DAO_BATCH_DELAY);
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_dag_apply_dao_batch(void)
+{
+  int i;
+
+  LOG_DBG("applying %u DAOs\n", dao_batch_len);
+
+  for(i = 0; i < dao_batch_len; i++) {
+    if(update_sr_graph(&dao_batch[i].from, &dao_batch[i].dao)) {
+#if RPL_WITH_DAO_ACK
+      if(dao_batch[i].dao.flags & RPL_DAO_K_FLAG) {
+        rpl_icmp6_dao_ack_output(&dao_batch[i].from, dao_batch[i].dao.sequence,
+                                 RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+      }
+#endif /* RPL_WITH_DAO_ACK */
+    }
+  }
+  dao_batch_len = 0;
+}
+#endif /* RPL_DAO_BATCH_SIZE */
+/*---------------------------------------------------------------------------*/
+void
+rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
+{
+#if RPL_DAO_BATCH_SIZE
+  batch_dao(from, dao);
+#else /* RPL_DAO_BATCH_SIZE */
+  if(!update_sr_graph(from, dao)) {
+    return;
+  }
 
 #if RPL_WITH_DAO_ACK
   if(dao->flags & RPL_DAO_K_FLAG) {
     rpl_timers_schedule_dao_ack(from, dao->sequence);
   }
 #endif /* RPL_WITH_DAO_ACK */
+#endif /* RPL_DAO_BATCH_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 #if RPL_WITH_DAO_ACK
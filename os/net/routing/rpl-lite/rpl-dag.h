@@ -166,6 +166,12 @@ void rpl_process_dio(uip_ipaddr_t *from, rpl_dio_t *dio);
 */
 void rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao);
 
+/**
+ * Applies the queued DAOs to the source routing graph, and sends the
+ * DAO-ACKs they request. Used with RPL_DAO_BATCH_SIZE.
+*/
+void rpl_dag_apply_dao_batch(void);
+
 /**
  * Processes incoming DAO-ACK
  *
@@ -161,19 +161,58 @@ rpl_ext_header_srh_update(void)
   return 1;
 }
 /*---------------------------------------------------------------------------*/
-/* Utility function for SRH. Counts the number of bytes in common between
- * two addresses at p1 and p2. */
-static int
-count_matching_bytes(const void *p1, const void *p2, size_t n)
+#if RPL_SRH_CACHE_SIZE
+/* The compressed source routes of recent destinations. An entry is valid
+ * as long as the source routing graph keeps the generation it was built
+ * in. */
+static struct srh_cache_entry {
+  uip_sr_node_t *node;
+  uip_sr_node_t *first_hop;
+  uint32_t generation;
+  uint8_t path_len;
+  uint8_t cmpr;
+  uint8_t addresses_len;
+  uint8_t addresses[RPL_SRH_CACHE_MAX_LEN];
+} srh_cache[RPL_SRH_CACHE_SIZE];
+/* The entry to be replaced next */
+static uint8_t srh_cache_next;
+/*---------------------------------------------------------------------------*/
+static struct srh_cache_entry *
+srh_cache_lookup(const uip_sr_node_t *node)
 {
-  int i = 0;
-  for(i = 0; i < n; i++) {
-    if(((uint8_t *)p1)[i] != ((uint8_t *)p2)[i]) {
-      return i;
+  int i;
+
+  for(i = 0; i < RPL_SRH_CACHE_SIZE; i++) {
+    if(srh_cache[i].node == node
+       && srh_cache[i].generation == uip_sr_generation()) {
+      return &srh_cache[i];
     }
   }
-  return n;
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+srh_cache_add(uip_sr_node_t *node, uip_sr_node_t *first_hop,
+              uint8_t path_len, uint8_t cmpr,
+              const uint8_t *addresses, uint8_t addresses_len)
+{
+  struct srh_cache_entry *e;
+
+  if(addresses_len > RPL_SRH_CACHE_MAX_LEN) {
+    return;
+  }
+
+  e = &srh_cache[srh_cache_next];
+  srh_cache_next = (srh_cache_next + 1) % RPL_SRH_CACHE_SIZE;
+  e->node = node;
+  e->first_hop = first_hop;
+  e->generation = uip_sr_generation();
+  e->path_len = path_len;
+  e->cmpr = cmpr;
+  e->addresses_len = addresses_len;
+  memcpy(e->addresses, addresses, addresses_len);
 }
+#endif /* RPL_SRH_CACHE_SIZE */
 /*---------------------------------------------------------------------------*/
 /* Used by rpl_ext_header_update to insert a RPL SRH extension header. This
  * is used at the root, to initiate downward routing. Returns 1 on success,
@@ -189,9 +228,13 @@ insert_srh_header(void)
   uint8_t *hop_ptr;
   uint8_t padding;
   uip_sr_node_t *dest_node;
-  uip_sr_node_t *root_node;
+  uip_sr_node_t *first_hop;
+  const uip_sr_path_t *path;
   uip_sr_node_t *node;
   uip_ipaddr_t node_addr;
+#if RPL_SRH_CACHE_SIZE
+  struct srh_cache_entry *cached;
+#endif /* RPL_SRH_CACHE_SIZE */
 
   /* Always insest SRH as first extension header */
   struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
@@ -218,43 +261,34 @@ insert_srh_header(void)
     return 1;
   }
 
-  root_node = uip_sr_get_node(NULL, &curr_instance.dag.dag_id);
-  if(root_node == NULL) {
-    LOG_ERR("SRH root node not found\n");
-    return 0;
-  }
+#if RPL_SRH_CACHE_SIZE
+  cached = srh_cache_lookup(dest_node);
+  if(cached != NULL) {
+    path_len = cached->path_len;
+    cmpri = cached->cmpr;
+    first_hop = cached->first_hop;
+  } else
+#endif /* RPL_SRH_CACHE_SIZE */
+  {
+    path = uip_sr_get_path(NULL, &UIP_IP_BUF->destipaddr);
+    if(path == NULL) {
+      LOG_ERR("SRH no path found to destination\n");
+      return 0;
+    }
 
-  if(!uip_sr_is_addr_reachable(NULL, &UIP_IP_BUF->destipaddr)) {
-    LOG_ERR("SRH no path found to destination\n");
-    return 0;
+    /* Path length and compression factors, computed by uip-sr along with
+     * the path */
+    path_len = path->len;
+    cmpri = path->common_bytes;
+    first_hop = path->first_hop;
   }
-
-  /* Compute path length and compression factors (we use cmpri == cmpre) */
-  path_len = 0;
-  node = dest_node->parent;
   /* For simplicity, we use cmpri = cmpre */
-  cmpri = 15;
-  cmpre = 15;
+  cmpre = cmpri;
 
-  /* Note that in case of a direct child (node == root_node), we insert
+  /* Note that in case of a direct child (path_len == 0), we insert
   SRH anyway, as RFC 6553 mandates that routed datagrams must include
   SRH or the RPL option (or both) */
 
-  while(node != NULL && node != root_node) {
-
-    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
-
-    /* How many bytes in common between all nodes in the path? */
-    cmpri = MIN(cmpri, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
-    cmpre = cmpri;
-
-    LOG_INFO("SRH Hop ");
-    LOG_INFO_6ADDR(&node_addr);
-    LOG_INFO_("\n");
-    node = node->parent;
-    path_len++;
-  }
-
   /* Extension header length: fixed headers + (n-1) * (16-ComprI) + (16-ComprE)*/
   ext_len = RPL_RH_LEN + RPL_SRH_LEN
       + (path_len - 1) * (16 - cmpre)
@@ -290,22 +324,34 @@ insert_srh_header(void)
   srh_hdr->cmpr = (cmpri << 4) + cmpre;
   srh_hdr->pad = padding << 4;
 
-  /* Initialize addresses field (the actual source route).
-   * From last to first. */
-  node = dest_node;
+  /* Initialize addresses field (the actual source route) */
   hop_ptr = ((uint8_t *)rh_hdr) + ext_len - padding; /* Pointer where to write the next hop compressed address */
 
-  while(node != NULL && node->parent != root_node) {
-    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
-
-    hop_ptr -= (16 - cmpri);
-    memcpy(hop_ptr, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
-
-    node = node->parent;
+#if RPL_SRH_CACHE_SIZE
+  if(cached != NULL) {
+    memcpy(hop_ptr - cached->addresses_len, cached->addresses,
+           cached->addresses_len);
+  } else
+#endif /* RPL_SRH_CACHE_SIZE */
+  {
+    /* From last to first */
+    for(node = dest_node; node != first_hop; node = node->parent) {
+      NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+      LOG_INFO("SRH Hop ");
+      LOG_INFO_6ADDR(&node_addr);
+      LOG_INFO_("\n");
+
+      hop_ptr -= (16 - cmpri);
+      memcpy(hop_ptr, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
+    }
+#if RPL_SRH_CACHE_SIZE
+    srh_cache_add(dest_node, first_hop, path_len, cmpri, hop_ptr,
+                  ((uint8_t *)rh_hdr) + ext_len - padding - hop_ptr);
+#endif /* RPL_SRH_CACHE_SIZE */
   }
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
-  NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+  NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, first_hop);
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field */
@@ -81,10 +81,16 @@ static void handle_probing_timer(void *ptr);
 #endif /* RPL_WITH_PROBING */
 static void handle_periodic_timer(void *ptr);
 static void handle_state_update(void *ptr);
+#if RPL_DAO_BATCH_SIZE
+static void handle_dao_batch_timer(void *ptr);
+#endif /* RPL_DAO_BATCH_SIZE */
 
 /*---------------------------------------------------------------------------*/
 static struct ctimer dis_timer; /* Not part of a DAG because when not joined */
 static struct ctimer periodic_timer; /* Not part of a DAG because used for general state maintenance */
+#if RPL_DAO_BATCH_SIZE
+static struct ctimer dao_batch_timer;
+#endif /* RPL_DAO_BATCH_SIZE */
 
 /*---------------------------------------------------------------------------*/
 /*------------------------------- DIS -------------------------------------- */
@@ -294,6 +300,25 @@ send_new_dao(void *ptr)
   /* Send a DAO with own prefix as target and default lifetime */
   rpl_icmp6_dao_output(curr_instance.default_lifetime);
 }
+#if RPL_DAO_BATCH_SIZE
+/*---------------------------------------------------------------------------*/
+/*------------------------------ DAO batch --------------------------------- */
+/*---------------------------------------------------------------------------*/
+void
+rpl_timers_schedule_dao_batch(clock_time_t delay)
+{
+  if(ctimer_expired(&dao_batch_timer)
+     || delay < timer_remaining(&dao_batch_timer.etimer.timer)) {
+    ctimer_set(&dao_batch_timer, delay, handle_dao_batch_timer, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_dao_batch_timer(void *ptr)
+{
+  rpl_dag_apply_dao_batch();
+}
+#endif /* RPL_DAO_BATCH_SIZE */
 #if RPL_WITH_DAO_ACK
 /*---------------------------------------------------------------------------*/
 /*------------------------------- DAO-ACK ---------------------------------- */
@@ -549,6 +574,9 @@ rpl_timers_stop_dag_timers(void)
 #if RPL_WITH_DAO_ACK
   ctimer_stop(&curr_instance.dag.dao_ack_timer);
 #endif /* RPL_WITH_DAO_ACK */
+#if RPL_DAO_BATCH_SIZE
+  ctimer_stop(&dao_batch_timer);
+#endif /* RPL_DAO_BATCH_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -99,6 +99,14 @@ void rpl_timers_schedule_dao(void);
 */
 void rpl_timers_schedule_dao_ack(uip_ipaddr_t *target, uint16_t sequence);
 
+/**
+ * Schedule the application of the queued DAOs, unless already scheduled
+ * to happen sooner
+ *
+ * \param delay The delay, RPL_DAO_BATCH_DELAY or 0 when the batch is full
+*/
+void rpl_timers_schedule_dao_batch(clock_time_t delay);
+
 /**
  * Let the rpl-timers module know that the last DAO was ACKed
 */
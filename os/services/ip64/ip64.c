@@ -63,6 +63,7 @@
 #include "net/ipv6/uip-ds6.h"
 #include "ip64/ip64-ipv4-dhcp.h"
 #include "contiki-net.h"
+#include "lib/ip-chksum.h"
 
 #include "net/ipv6/uip-debug.h"
 
@@ -269,95 +270,88 @@ ip64_set_ipv6_address(const uip_ip6addr_t *addr)
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+ipv4_checksum(struct ipv4_hdr *hdr)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {	/* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-  }
+  uint16_t sum;
 
-  /* Return sum in host byte order. */
-  return sum;
+  sum = IP_CHKSUM(0, (uint8_t *)hdr, IPV4_HDRLEN);
+  return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
+/* Sums the pseudo-header of a transport layer checksum. ICMPv4 has
+   no pseudo-header. */
 static uint16_t
-ipv4_checksum(struct ipv4_hdr *hdr)
+ipv4_pseudo_header_sum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
   uint16_t sum;
+  struct ipv4_hdr *v4hdr = (struct ipv4_hdr *)packet;
 
-  sum = chksum(0, (uint8_t *)hdr, IPV4_HDRLEN);
-  return (sum == 0) ? 0xffff : uip_htons(sum);
+  if(proto == IP_PROTO_ICMPV4) {
+    /* ping replies' checksums are calculated over the icmp-part only */
+    return 0;
+  }
+
+  /* IP protocol and length fields. This addition cannot carry. */
+  sum = len - IPV4_HDRLEN + proto;
+  /* Sum IP source and destination addresses. */
+  return IP_CHKSUM(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
 ipv4_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
-  uint16_t transport_layer_len;
   uint16_t sum;
-  struct ipv4_hdr *v4hdr = (struct ipv4_hdr *)packet;
 
-  transport_layer_len = len - IPV4_HDRLEN;
-
-  /* First sum pseudoheader. */
-
-  if(proto != IP_PROTO_ICMPV4) {
-    /* IP protocol and length fields. This addition cannot carry. */
-    sum = transport_layer_len + proto;
-    /* Sum IP source and destination addresses. */
-    sum = chksum(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
-  } else {
-    /* ping replies' checksums are calculated over the icmp-part only */
-    sum = 0;
-  }
+  sum = ipv4_pseudo_header_sum(packet, len, proto);
 
   /* Sum transport layer header and data. */
-  sum = chksum(sum, &packet[IPV4_HDRLEN], transport_layer_len);
+  sum = IP_CHKSUM(sum, &packet[IPV4_HDRLEN], len - IPV4_HDRLEN);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
-ipv6_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
+ipv6_pseudo_header_sum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
-  uint16_t transport_layer_len;
   uint16_t sum;
   struct ipv6_hdr *v6hdr = (struct ipv6_hdr *)packet;
 
-  transport_layer_len = len - IPV6_HDRLEN;
-
-  /* First sum pseudoheader. */
-
   /* IP protocol and length fields. This addition cannot carry. */
-  sum = transport_layer_len + proto;
+  sum = len - IPV6_HDRLEN + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
-  sum = chksum(sum, (uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
+  return IP_CHKSUM(sum, (uint8_t *)&v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t));
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ipv6_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
+{
+  uint16_t sum;
+
+  sum = ipv6_pseudo_header_sum(packet, len, proto);
 
   /* Sum transport layer header and data. */
-  sum = chksum(sum, &packet[IPV6_HDRLEN], transport_layer_len);
+  sum = IP_CHKSUM(sum, &packet[IPV6_HDRLEN], len - IPV6_HDRLEN);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
+/* Translates the transport layer checksum of a packet whose payload
+   was copied unchanged from the original packet. Only the
+   pseudo-headers and the first hdrlen bytes of the transport headers
+   (the port numbers, or the ICMP type and code) differ, so the
+   checksum is updated incrementally instead of being recomputed over
+   the whole payload. */
+static uint16_t
+transport_checksum_translate(uint16_t chksum,
+                             uint16_t old_sum, const uint8_t *old_hdr,
+                             uint16_t new_sum, const uint8_t *new_hdr,
+                             uint16_t hdrlen)
+{
+  old_sum = IP_CHKSUM(old_sum, old_hdr, hdrlen);
+  new_sum = IP_CHKSUM(new_sum, new_hdr, hdrlen);
+  return uip_htons(ip_chksum_adjust(uip_ntohs(chksum), old_sum, new_sum));
+}
+/*---------------------------------------------------------------------------*/
 int
 ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 	  uint8_t *resultpacket)
@@ -370,6 +364,7 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv6len, ipv4len;
   struct ip64_addrmap_entry *m;
+  uint8_t payload_rewritten = 0;
 
   v6hdr = (struct ipv6_hdr *)ipv6packet;
   v4hdr = (struct ipv4_hdr *)resultpacket;
@@ -424,15 +419,6 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   case IP_PROTO_TCP:
     PRINTF("ip64_6to4: TCP header\n");
     v4hdr->proto = IP_PROTO_TCP;
-
-    /* Compute and check the TCP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
-    if(ipv6_transport_checksum(ipv6packet, ipv6len,
-                               IP_PROTO_TCP) != 0xffff) {
-      PRINTF("Bad TCP checksum, dropping packet\n");
-    }
-
     break;
 
   case IP_PROTO_UDP:
@@ -446,13 +432,7 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
                       ipv6len - IPV6_HDRLEN - sizeof(struct udp_hdr),
                       (uint8_t *)udphdr + sizeof(struct udp_hdr),
                       BUFSIZE - IPV4_HDRLEN - sizeof(struct udp_hdr));
-    }
-    /* Compute and check the UDP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
-    if(ipv6_transport_checksum(ipv6packet, ipv6len,
-                               IP_PROTO_UDP) != 0xffff) {
-      PRINTF("Bad UDP checksum, dropping packet\n");
+      payload_rewritten = 1;
     }
     break;
 
@@ -616,25 +596,48 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 
   /* The checksum is in different places in the different protocol
      headers, so we need to be sure that we update the correct
-     field. */
+     field. Unless the payload was rewritten, the checksum is
+     translated from the IPv6 packet rather than recomputed. An
+     incorrect checksum therefore stays incorrect, and the packet is
+     dropped by the receiving host. */
   switch(v4hdr->proto) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_TCP));
+    tcphdr->tcpchksum =
+      transport_checksum_translate(tcphdr->tcpchksum,
+                                   ipv6_pseudo_header_sum(ipv6packet, ipv6len,
+                                                          IP_PROTO_TCP),
+                                   &ipv6packet[IPV6_HDRLEN],
+                                   ipv4_pseudo_header_sum(resultpacket, ipv4len,
+                                                          IP_PROTO_TCP),
+                                   (uint8_t *)tcphdr, 2 * sizeof(uint16_t));
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_UDP));
+    if(payload_rewritten) {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
+                                                    IP_PROTO_UDP));
+    } else {
+      udphdr->udpchksum =
+        transport_checksum_translate(udphdr->udpchksum,
+                                     ipv6_pseudo_header_sum(ipv6packet, ipv6len,
+                                                            IP_PROTO_UDP),
+                                     &ipv6packet[IPV6_HDRLEN],
+                                     ipv4_pseudo_header_sum(resultpacket, ipv4len,
+                                                            IP_PROTO_UDP),
+                                     (uint8_t *)udphdr, 2 * sizeof(uint16_t));
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
     break;
   case IP_PROTO_ICMPV4:
-    icmpv4hdr->icmpchksum = 0;
-    icmpv4hdr->icmpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						      IP_PROTO_ICMPV4));
+    icmpv4hdr->icmpchksum =
+      transport_checksum_translate(icmpv4hdr->icmpchksum,
+                                   ipv6_pseudo_header_sum(ipv6packet, ipv6len,
+                                                          IP_PROTO_ICMPV6),
+                                   (uint8_t *)icmpv6hdr,
+                                   0, (uint8_t *)icmpv4hdr,
+                                   2 * sizeof(uint8_t));
     break;
 
   default:
@@ -659,6 +662,7 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv4len, ipv6len, ipv6_packet_len;
   struct ip64_addrmap_entry *m;
+  uint8_t payload_rewritten = 0;
 
   v6hdr = (struct ipv6_hdr *)resultpacket;
   v4hdr = (struct ipv4_hdr *)ipv4packet;
@@ -741,7 +745,7 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
       v6hdr->len[0] = ipv6_packet_len >> 8;
       v6hdr->len[1] = ipv6_packet_len & 0xff;
       ipv6len = ipv6_packet_len + IPV6_HDRLEN;
-
+      payload_rewritten = 1;
     }
     break;
 
@@ -854,28 +858,48 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
      field. */
   switch(v6hdr->nxthdr) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_TCP));
+    tcphdr->tcpchksum =
+      transport_checksum_translate(tcphdr->tcpchksum,
+                                   ipv4_pseudo_header_sum(ipv4packet, ipv4len,
+                                                          IP_PROTO_TCP),
+                                   &ipv4packet[IPV4_HDRLEN],
+                                   ipv6_pseudo_header_sum(resultpacket, ipv6len,
+                                                          IP_PROTO_TCP),
+                                   (uint8_t *)tcphdr, 2 * sizeof(uint16_t));
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    /* As the udplen might have changed (DNS) we need to update it also */
-    udphdr->udplen = uip_htons(ipv6_packet_len);
-    udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_UDP));
+    /* The checksum is optional in IPv4 but not in IPv6, so it must be
+       computed from scratch if the IPv4 packet had none. */
+    if(payload_rewritten || udphdr->udpchksum == 0) {
+      udphdr->udpchksum = 0;
+      /* As the udplen might have changed (DNS) we need to update it also */
+      udphdr->udplen = uip_htons(ipv6_packet_len);
+      udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
+                                                    ipv6len,
+                                                    IP_PROTO_UDP));
+    } else {
+      udphdr->udpchksum =
+        transport_checksum_translate(udphdr->udpchksum,
+                                     ipv4_pseudo_header_sum(ipv4packet, ipv4len,
+                                                            IP_PROTO_UDP),
+                                     &ipv4packet[IPV4_HDRLEN],
+                                     ipv6_pseudo_header_sum(resultpacket, ipv6len,
+                                                            IP_PROTO_UDP),
+                                     (uint8_t *)udphdr, 2 * sizeof(uint16_t));
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
     break;
 
   case IP_PROTO_ICMPV6:
-    icmpv6hdr->icmpchksum = 0;
-    icmpv6hdr->icmpchksum = ~(ipv6_transport_checksum(resultpacket,
-                                                ipv6len,
-                                                IP_PROTO_ICMPV6));
+    icmpv6hdr->icmpchksum =
+      transport_checksum_translate(icmpv6hdr->icmpchksum,
+                                   0, (uint8_t *)icmpv4hdr,
+                                   ipv6_pseudo_header_sum(resultpacket, ipv6len,
+                                                          IP_PROTO_ICMPV6),
+                                   (uint8_t *)icmpv6hdr,
+                                   2 * sizeof(uint8_t));
     break;
   default:
     PRINTF("ip64_4to6: transport protocol %d not implemented\n", v4hdr->proto);
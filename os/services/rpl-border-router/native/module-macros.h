@@ -35,6 +35,10 @@
 
 #define SLIP_DEV_CONF_SEND_DELAY (CLOCK_SECOND / 32)
 
+/* Queue the packets read from the tun interface, so that bursts from
+   the host are not processed in the select callback */
+#define UIP_CONF_IPV6_INPUT_QUEUE_LEN 8
+
 #define SERIALIZE_ATTRIBUTES 1
 
 #define CMD_CONF_OUTPUT border_router_cmd_output
@@ -301,7 +301,7 @@ handle_fd(fd_set *rset, fd_set *wset)
       size = tun_input(uip_buf, sizeof(uip_buf));
       /* printf("TUN data incoming read:%d\n", size); */
       uip_len = size;
-      tcpip_input();
+      tcpip_input_enqueue();
 
       if(slip_config_basedelay) {
         struct timeval tv;
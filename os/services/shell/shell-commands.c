@@ -46,12 +46,14 @@
 #include "shell.h"
 #include "shell-commands.h"
 #include "lib/list.h"
+#include "lib/memb.h"
 #include "sys/log.h"
 #include "dev/watchdog.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uiplib.h"
 #include "net/ipv6/uip-icmp6.h"
 #include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/sicslowpan.h"
 #if BUILD_WITH_RESOLV
 #include "resolv.h"
 #endif /* BUILD_WITH_RESOLV */
@@ -63,6 +65,7 @@
 #endif /* MAC_CONF_WITH_TSCH */
 #if MAC_CONF_WITH_CSMA
 #include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
 #endif
 #include "net/routing/routing.h"
 #include "net/mac/llsec802154.h"
@@ -479,6 +482,60 @@ PT_THREAD(cmd_macaddr(struct pt *pt, shell_output_func output, char *args))
 
   PT_END(pt);
 }
+#if MEMB_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_memb(struct pt *pt, shell_output_func output, char *args))
+{
+  struct memb *m;
+
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "Memory blocks (used/max/total, block size):\n");
+  for(m = memb_stats_head(); m != NULL; m = m->next) {
+    SHELL_OUTPUT(output, "-- %s: %u/%u/%u, %u bytes\n", m->name,
+                 m->count, m->max_count, m->num, m->size);
+  }
+
+  PT_END(pt);
+}
+#endif /* MEMB_STATS */
+#if MAC_CONF_WITH_CSMA && CSMA_QUEUE_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_csma_queues(struct pt *pt, shell_output_func output, char *args))
+{
+  static unsigned i;
+  struct csma_neighbor_queue_info info;
+  const struct csma_queue_stats *stats;
+
+  PT_BEGIN(pt);
+
+  stats = csma_queue_get_stats();
+  SHELL_OUTPUT(output, "CSMA queues: %lu enqueued, %lu dequeued, max depth %u\n",
+               (unsigned long)stats->enqueued, (unsigned long)stats->dequeued,
+               stats->depth_max);
+  SHELL_OUTPUT(output, "-- drops: %lu full, %lu no memory, %lu AQM\n",
+               (unsigned long)stats->drop_full,
+               (unsigned long)stats->drop_nomem,
+               (unsigned long)stats->drop_aqm);
+  SHELL_OUTPUT(output, "-- sojourn: avg %lu, max %lu ticks\n",
+               stats->dequeued > 0 ?
+               (unsigned long)(stats->sojourn_total / stats->dequeued) : 0UL,
+               (unsigned long)stats->sojourn_max);
+  SHELL_OUTPUT(output, "-- frames sent in bursts: %lu\n",
+               (unsigned long)stats->burst_frames);
+  for(i = 0; csma_queue_get_neighbor_info(i, &info); i++) {
+    SHELL_OUTPUT(output, "-- ");
+    shell_output_lladdr(output, &info.addr);
+    SHELL_OUTPUT(output, ": depth %u, drops %u, head %lu, max %lu ticks\n",
+                 info.depth, info.drops, (unsigned long)info.head_sojourn,
+                 (unsigned long)info.sojourn_max);
+  }
+
+  PT_END(pt);
+}
+#endif /* MAC_CONF_WITH_CSMA && CSMA_QUEUE_STATS */
 #if NETSTACK_CONF_WITH_IPV6
 /*---------------------------------------------------------------------------*/
 static
@@ -614,9 +671,48 @@ PT_THREAD(cmd_tsch_status(struct pt *pt, shell_output_func output, char *args))
     SHELL_OUTPUT(output, "-- Network uptime: %lu seconds\n",
                  (unsigned long)(tsch_get_network_uptime_ticks() / CLOCK_SECOND));
   }
+  SHELL_OUTPUT(output, "-- Input ringbuf: max %u/%u, %lu slots skipped\n",
+               tsch_ringbuf_stats.input_max, TSCH_MAX_INCOMING_PACKETS,
+               (unsigned long)tsch_ringbuf_stats.input_full);
+  SHELL_OUTPUT(output, "-- Dequeued ringbuf: max %u/%u, %lu slots skipped\n",
+               tsch_ringbuf_stats.dequeued_max, TSCH_DEQUEUED_ARRAY_SIZE,
+               (unsigned long)tsch_ringbuf_stats.dequeued_full);
+
+  PT_END(pt);
+}
+#if TSCH_PROFILER_ON
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_tsch_profile(struct pt *pt, shell_output_func output, char *args))
+{
+  const struct tsch_profiler_stats *stats;
+  unsigned phase;
+  unsigned bin;
+
+  PT_BEGIN(pt);
+
+  stats = tsch_profiler_get_stats();
+  SHELL_OUTPUT(output, "TSCH slot profile: %lu slots, %lu overruns, %lu deadline misses\n",
+               (unsigned long)stats->slots, (unsigned long)stats->overruns,
+               (unsigned long)stats->deadline_misses);
+  SHELL_OUTPUT(output, "-- Timeslot %lu us, histogram bins of %lu us\n",
+               (unsigned long)RTIMERTICKS_TO_US(tsch_timing[tsch_ts_timeslot_length]),
+               (unsigned long)RTIMERTICKS_TO_US(tsch_timing[tsch_ts_timeslot_length] / TSCH_PROFILER_BINS));
+  for(phase = 0; phase < tsch_phase_count; phase++) {
+    SHELL_OUTPUT(output, "-- %-14s max %6lu us:", tsch_profiler_phase_name(phase),
+                 (unsigned long)RTIMERTICKS_TO_US(stats->max[phase]));
+    for(bin = 0; bin < TSCH_PROFILER_BINS; bin++) {
+      SHELL_OUTPUT(output, " %u", stats->hist[phase][bin]);
+    }
+    SHELL_OUTPUT(output, "\n");
+  }
+  if(args != NULL && !strcmp(args, "reset")) {
+    tsch_profiler_reset();
+  }
 
   PT_END(pt);
 }
+#endif /* TSCH_PROFILER_ON */
 #endif /* MAC_CONF_WITH_TSCH */
 #if NETSTACK_CONF_WITH_IPV6
 /*---------------------------------------------------------------------------*/
@@ -685,6 +781,84 @@ PT_THREAD(cmd_routes(struct pt *pt, shell_output_func output, char *args))
   PT_END(pt);
 }
 /*---------------------------------------------------------------------------*/
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+static
+PT_THREAD(cmd_6lo_ctx(struct pt *pt, shell_output_func output, char *args))
+{
+  const struct sicslowpan_addr_context *ctx;
+  uip_ipaddr_t prefix;
+  unsigned long lifetime;
+  char *next_args;
+  char *end;
+  long cid;
+  int i;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+
+  /* Get first arg (context identifier) */
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args == NULL) {
+    SHELL_OUTPUT(output, "6LoWPAN address contexts:\n");
+    for(i = 0; i < 16; i++) {
+      ctx = sicslowpan_addr_context_get(i);
+      if(ctx != NULL) {
+        memset(&prefix, 0, sizeof(prefix));
+        memcpy(prefix.u8, ctx->prefix, sizeof(ctx->prefix));
+        SHELL_OUTPUT(output, "-- %u: ", ctx->number);
+        shell_output_6addr(output, &prefix);
+        SHELL_OUTPUT(output, "/64%s", ctx->compress ? "" : " (decompression only)");
+        if(ctx->isinfinite) {
+          SHELL_OUTPUT(output, " (lifetime: infinite)\n");
+        } else {
+          SHELL_OUTPUT(output, " (lifetime: %lu seconds)\n",
+                       (unsigned long)stimer_remaining((struct stimer *)&ctx->lifetime));
+        }
+      }
+    }
+    PT_EXIT(pt);
+  }
+
+  cid = strtol(args, &end, 10);
+  if(end == args || *end != '\0' || cid < 0 || cid > 15) {
+    SHELL_OUTPUT(output, "Invalid context identifier: %s\n", args);
+    PT_EXIT(pt);
+  }
+
+  /* Get second arg (prefix, or "off") */
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args == NULL) {
+    SHELL_OUTPUT(output, "Prefix required\n");
+    PT_EXIT(pt);
+  } else if(!strcmp(args, "off")) {
+    if(sicslowpan_addr_context_rm(cid)) {
+      SHELL_OUTPUT(output, "Removed context %ld\n", cid);
+    } else {
+      SHELL_OUTPUT(output, "No context %ld\n", cid);
+    }
+    PT_EXIT(pt);
+  } else if(uiplib_ipaddrconv(args, &prefix) == 0) {
+    SHELL_OUTPUT(output, "Invalid Prefix: %s\n", args);
+    PT_EXIT(pt);
+  }
+
+  /* Get optional third arg (lifetime in seconds) */
+  SHELL_ARGS_NEXT(args, next_args);
+  lifetime = args != NULL ? strtoul(args, NULL, 10) : 0;
+
+  if(sicslowpan_addr_context_set(cid, &prefix, 1, lifetime)) {
+    SHELL_OUTPUT(output, "Set context %ld to ", cid);
+    shell_output_6addr(output, &prefix);
+    SHELL_OUTPUT(output, "/64\n");
+  } else {
+    SHELL_OUTPUT(output, "No room for context %ld\n", cid);
+  }
+
+  PT_END(pt);
+}
+#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+/*---------------------------------------------------------------------------*/
 #if BUILD_WITH_RESOLV
 static
 PT_THREAD(cmd_resolv(struct pt *pt, shell_output_func output, char *args))
@@ -981,11 +1155,20 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#if MEMB_STATS
+  { "memb",                 cmd_memb,                 "'> memb': Shows the usage and high-water mark of all memory blocks" },
+#endif /* MEMB_STATS */
+#if MAC_CONF_WITH_CSMA && CSMA_QUEUE_STATS
+  { "csma-queues",          cmd_csma_queues,          "'> csma-queues': Shows the CSMA neighbor queues and their statistics" },
+#endif /* MAC_CONF_WITH_CSMA && CSMA_QUEUE_STATS */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
   { "ping",                 cmd_ping,                 "'> ping addr': Pings the IPv6 address 'addr'" },
   { "routes",               cmd_routes,               "'> routes': Shows the route entries" },
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  { "6lo-ctx",              cmd_6lo_ctx,              "'> 6lo-ctx [cid prefix [lifetime] | cid off]': Shows, sets or removes 6LoWPAN address contexts" },
+#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
 #if BUILD_WITH_RESOLV
   { "nslookup",             cmd_resolv,               "'> nslookup': Lookup IPv6 address of host" },
 #endif /* BUILD_WITH_RESOLV */
@@ -1007,6 +1190,9 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "tsch-set-coordinator", cmd_tsch_set_coordinator, "'> tsch-set-coordinator 0/1 [0/1]': Sets node as coordinator (1) or not (0). Second, optional parameter: enable (1) or disable (0) security." },
   { "tsch-schedule",        cmd_tsch_schedule,        "'> tsch-schedule': Shows the current TSCH schedule" },
   { "tsch-status",          cmd_tsch_status,          "'> tsch-status': Shows a summary of the current TSCH state" },
+#if TSCH_PROFILER_ON
+  { "tsch-profile",         cmd_tsch_profile,         "'> tsch-profile [reset]': Shows the TSCH slot profile, then optionally resets it" },
+#endif /* TSCH_PROFILER_ON */
 #endif /* MAC_CONF_WITH_TSCH */
 #if TSCH_WITH_SIXTOP
   { "6top",                 cmd_6top,                 "'> 6top help': Shows 6top command usage" },
@@ -92,6 +92,8 @@ ctimer_init(void)
 {
   initialized = 0;
   list_init(ctimer_list);
+  /* Callback timers drive MAC, routing and ND timing */
+  process_set_prio(&ctimer_process, PROCESS_PRIO_HIGH);
   process_start(&ctimer_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup deadline
+ * @{
+ */
+
+/**
+ * \file
+ *         Implementation of the next system deadline.
+ */
+
+#include "contiki.h"
+#include "sys/deadline.h"
+#include "sys/etimer.h"
+#include "sys/rtimer.h"
+/*---------------------------------------------------------------------------*/
+uint32_t
+deadline_next_us(uint32_t max_us)
+{
+  uint32_t us = max_us;
+  uint64_t remaining;
+  clock_time_t now, next;
+  rtimer_clock_t rnext;
+  rtimer_clock_t rnow;
+
+  if(process_nevents() > 0) {
+    return 0;
+  }
+
+  if(etimer_pending()) {
+    now = clock_time();
+    next = etimer_next_expiration_time();
+    if((clock_time_t)(next - now) > ((clock_time_t)~0 >> 1) || next == now) {
+      /* Already expired, the etimer process needs to run */
+      return 0;
+    }
+    remaining = (uint64_t)(clock_time_t)(next - now) * 1000000 / CLOCK_SECOND;
+    if(remaining < us) {
+      us = (uint32_t)remaining;
+    }
+  }
+
+  if(rtimer_next_expiration_time(&rnext)) {
+    rnow = RTIMER_NOW();
+    if(!RTIMER_CLOCK_LT(rnow, rnext)) {
+      return 0;
+    }
+    remaining = (uint64_t)(rtimer_clock_t)(rnext - rnow) * 1000000 / RTIMER_SECOND;
+    if(remaining < us) {
+      us = (uint32_t)remaining;
+    }
+  }
+
+  return us;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the next system deadline.
+ */
+
+/** \addtogroup sys
+ * @{ */
+
+/**
+ * \defgroup deadline Next system deadline
+ *
+ * Computes how long the system can sleep before it has work to do,
+ * taking into account pending events and polls, event timers (and
+ * thereby callback timers) and the scheduled real-time timer.
+ * Platform main loops and low-power modes can use this to sleep until
+ * exactly the next deadline instead of waking up periodically.
+ *
+ * @{
+ */
+
+#ifndef DEADLINE_H_
+#define DEADLINE_H_
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/**
+ * \brief        Get the time until the next deadline of the system
+ * \param max_us Upper bound for the returned value, in microseconds
+ * \return       The number of microseconds until the next event timer
+ *               or real-time timer expires, capped to \p max_us. Zero
+ *               if events or process polls are pending, or if a timer
+ *               has already expired.
+ */
+uint32_t deadline_next_us(uint32_t max_us);
+
+#endif /* DEADLINE_H_ */
+/** @} */
+/** @} */
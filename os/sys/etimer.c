@@ -49,11 +49,236 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
-static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP_SIZE
+/*
+ * Pending timers are kept in a binary min-heap ordered by expiration
+ * time, so the next timer to expire is always heap[0]. Each timer
+ * records its slot in the heap, which lets us check whether a timer is
+ * pending and remove it without searching. Timers that are set while
+ * the heap is full go on an unsorted overflow list.
+ */
+static struct etimer *heap[ETIMER_HEAP_SIZE];
+static uint16_t heap_len;
+static struct etimer *overflow;
+
+#define EXPIRATION(t) ((t)->timer.start + (t)->timer.interval)
+/* Wrap-safe check whether timer a expires before timer b */
+#define EXPIRES_BEFORE(a, b) \
+  ((clock_time_t)(EXPIRATION(a) - EXPIRATION(b)) > ((clock_time_t)~0 >> 1))
+/*---------------------------------------------------------------------------*/
+static void
+heap_place(struct etimer *t, uint16_t i)
+{
+  heap[i] = t;
+  t->heap_index = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_up(uint16_t i)
+{
+  struct etimer *t = heap[i];
+  uint16_t parent;
+
+  while(i > 0) {
+    parent = (i - 1) / 2;
+    if(!EXPIRES_BEFORE(t, heap[parent])) {
+      break;
+    }
+    heap_place(heap[parent], i);
+    i = parent;
+  }
+  heap_place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_down(uint16_t i)
+{
+  struct etimer *t = heap[i];
+  uint32_t child;
+
+  while((child = 2 * (uint32_t)i + 1) < heap_len) {
+    if(child + 1 < heap_len && EXPIRES_BEFORE(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if(!EXPIRES_BEFORE(heap[child], t)) {
+      break;
+    }
+    heap_place(heap[child], i);
+    i = child;
+  }
+  heap_place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+/* Restore the heap order after the expiration time of heap[i] changed */
+static void
+heap_update(uint16_t i)
+{
+  if(i > 0 && EXPIRES_BEFORE(heap[i], heap[(i - 1) / 2])) {
+    sift_up(i);
+  } else {
+    sift_down(i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+in_heap(struct etimer *t)
+{
+  /* Also safe for timers that were never set and contain garbage */
+  return t->heap_index < heap_len && heap[t->heap_index] == t;
+}
+/*---------------------------------------------------------------------------*/
+static int
+in_overflow(struct etimer *t)
+{
+  struct etimer *u;
+
+  for(u = overflow; u != NULL; u = u->next) {
+    if(u == t) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *t)
+{
+  if(heap_len < ETIMER_HEAP_SIZE) {
+    t->next = NULL;
+    heap_place(t, heap_len++);
+    sift_up(t->heap_index);
+  } else {
+    t->next = overflow;
+    overflow = t;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+refill_heap(void)
+{
+  struct etimer *t;
+
+  while(overflow != NULL && heap_len < ETIMER_HEAP_SIZE) {
+    t = overflow;
+    overflow = t->next;
+    insert_timer(t);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_timer(struct etimer *et)
+{
+  struct etimer *t;
+  uint16_t i;
+
+  if(in_heap(et)) {
+    i = et->heap_index;
+    t = heap[--heap_len];
+    if(t != et) {
+      heap_place(t, i);
+      heap_update(i);
+    }
+    refill_heap();
+  } else if(et == overflow) {
+    overflow = et->next;
+  } else {
+    for(t = overflow; t != NULL && t->next != et; t = t->next);
+    if(t != NULL) {
+      t->next = et->next;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  struct etimer *t, *first;
+
+  first = heap_len > 0 ? heap[0] : overflow;
+  if(first == NULL) {
+    next_expiration = 0;
+    return;
+  }
+  for(t = overflow; t != NULL; t = t->next) {
+    if(EXPIRES_BEFORE(t, first)) {
+      first = t;
+    }
+  }
+  next_expiration = EXPIRATION(first);
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+next_expired(void)
+{
+  struct etimer *t;
+
+  if(heap_len > 0 && timer_expired(&heap[0]->timer)) {
+    return heap[0];
+  }
+  for(t = overflow; t != NULL; t = t->next) {
+    if(timer_expired(&t->timer)) {
+      return t;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_process_timers(struct process *p)
+{
+  struct etimer *t, **u;
+  uint16_t i, len;
+
+  /* Compact the remaining timers and rebuild the heap in linear time */
+  len = 0;
+  for(i = 0; i < heap_len; i++) {
+    if(heap[i]->p != p) {
+      heap_place(heap[i], len++);
+    }
+  }
+  heap_len = len;
+  for(i = heap_len / 2; i > 0; i--) {
+    sift_down(i - 1);
+  }
+
+  for(u = &overflow; *u != NULL;) {
+    t = *u;
+    if(t->p == p) {
+      *u = t->next;
+    } else {
+      u = &t->next;
+    }
+  }
+  refill_heap();
+}
+/*---------------------------------------------------------------------------*/
+static void
+post_expired_timers(void)
+{
+  struct etimer *t;
+
+  while((t = next_expired()) != NULL) {
+    if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+      etimer_request_poll();
+      break;
+    }
+    remove_timer(t);
+    /* Reset the process ID of the event timer, to signal that the
+       etimer has expired. This is later checked in the
+       etimer_expired() function. */
+    t->p = PROCESS_NONE;
+    t->next = NULL;
+  }
+  update_time();
+}
+/*---------------------------------------------------------------------------*/
+#else /* ETIMER_HEAP_SIZE */
+static struct etimer *timerlist;
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
@@ -77,64 +302,80 @@ update_time(void)
   }
 }
 /*---------------------------------------------------------------------------*/
-PROCESS_THREAD(etimer_process, ev, data)
+static void
+remove_process_timers(struct process *p)
 {
-  struct etimer *t, *u;
+  struct etimer *t;
 
-  PROCESS_BEGIN();
+  while(timerlist != NULL && timerlist->p == p) {
+    timerlist = timerlist->next;
+  }
 
-  timerlist = NULL;
+  if(timerlist != NULL) {
+    t = timerlist;
+    while(t->next != NULL) {
+      if(t->next->p == p) {
+        t->next = t->next->next;
+      } else {
+        t = t->next;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+post_expired_timers(void)
+{
+  struct etimer *t, *u;
 
-  while(1) {
-    PROCESS_YIELD();
+again:
 
-    if(ev == PROCESS_EVENT_EXITED) {
-      struct process *p = data;
+  u = NULL;
 
-      while(timerlist != NULL && timerlist->p == p) {
-        timerlist = timerlist->next;
-      }
+  for(t = timerlist; t != NULL; t = t->next) {
+    if(timer_expired(&t->timer)) {
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
 
-      if(timerlist != NULL) {
-        t = timerlist;
-        while(t->next != NULL) {
-          if(t->next->p == p) {
-            t->next = t->next->next;
-          } else {
-            t = t->next;
-          }
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+        if(u != NULL) {
+          u->next = t->next;
+        } else {
+          timerlist = t->next;
         }
+        t->next = NULL;
+        update_time();
+        goto again;
+      } else {
+        etimer_request_poll();
       }
-      continue;
-    } else if(ev != PROCESS_EVENT_POLL) {
-      continue;
     }
+    u = t;
+  }
+}
+#endif /* ETIMER_HEAP_SIZE */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+  PROCESS_BEGIN();
 
-again:
+#if ETIMER_HEAP_SIZE
+  heap_len = 0;
+  overflow = NULL;
+#else /* ETIMER_HEAP_SIZE */
+  timerlist = NULL;
+#endif /* ETIMER_HEAP_SIZE */
 
-    u = NULL;
+  while(1) {
+    PROCESS_YIELD();
 
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-        if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-
-          /* Reset the process ID of the event timer, to signal that the
-             etimer has expired. This is later checked in the
-             etimer_expired() function. */
-          t->p = PROCESS_NONE;
-          if(u != NULL) {
-            u->next = t->next;
-          } else {
-            timerlist = t->next;
-          }
-          t->next = NULL;
-          update_time();
-          goto again;
-        } else {
-          etimer_request_poll();
-        }
-      }
-      u = t;
+    if(ev == PROCESS_EVENT_EXITED) {
+      remove_process_timers(data);
+      update_time();
+    } else if(ev == PROCESS_EVENT_POLL) {
+      post_expired_timers();
     }
   }
 
@@ -150,10 +391,29 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
+#if !ETIMER_HEAP_SIZE
   struct etimer *t;
+#endif /* !ETIMER_HEAP_SIZE */
 
   etimer_request_poll();
 
+#if ETIMER_HEAP_SIZE
+  if(in_heap(timer)) {
+    /* Timer already pending, move it to its new place. */
+    timer->p = PROCESS_CURRENT();
+    heap_update(timer->heap_index);
+    update_time();
+    return;
+  }
+  if(timer->p != PROCESS_NONE && in_overflow(timer)) {
+    timer->p = PROCESS_CURRENT();
+    update_time();
+    return;
+  }
+
+  timer->p = PROCESS_CURRENT();
+  insert_timer(timer);
+#else /* ETIMER_HEAP_SIZE */
   if(timer->p != PROCESS_NONE) {
     for(t = timerlist; t != NULL; t = t->next) {
       if(t == timer) {
@@ -169,6 +429,7 @@ add_timer(struct etimer *timer)
   timer->p = PROCESS_CURRENT();
   timer->next = timerlist;
   timerlist = timer;
+#endif /* ETIMER_HEAP_SIZE */
 
   update_time();
 }
@@ -206,6 +467,11 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+#if ETIMER_HEAP_SIZE
+  if(in_heap(et)) {
+    heap_update(et->heap_index);
+  }
+#endif /* ETIMER_HEAP_SIZE */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -230,7 +496,11 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
+#if ETIMER_HEAP_SIZE
+  return heap_len > 0 || overflow != NULL;
+#else /* ETIMER_HEAP_SIZE */
   return timerlist != NULL;
+#endif /* ETIMER_HEAP_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
@@ -242,6 +512,10 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_HEAP_SIZE
+  remove_timer(et);
+  update_time();
+#else /* ETIMER_HEAP_SIZE */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -263,6 +537,7 @@ etimer_stop(struct etimer *et)
       update_time();
     }
   }
+#endif /* ETIMER_HEAP_SIZE */
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
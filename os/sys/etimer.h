@@ -65,6 +65,28 @@
 
 #include "contiki.h"
 
+/**
+ * \brief Size of the event timer min-heap
+ *
+ * By default, pending event timers are kept on an unsorted list: setting
+ * and stopping a timer, as well as finding the next expiration time, take
+ * time linear in the number of pending timers. When this is set to a
+ * non-zero value, pending timers are instead kept in a binary min-heap
+ * of this many slots, ordered by expiration time. Setting and stopping a
+ * timer then take O(log n) time and the next expiration time is found in
+ * O(1). Timers set while the heap is full are kept on an overflow list
+ * and are moved into the heap as slots become free.
+ */
+#ifdef ETIMER_CONF_HEAP_SIZE
+#define ETIMER_HEAP_SIZE ETIMER_CONF_HEAP_SIZE
+#else
+#define ETIMER_HEAP_SIZE 0
+#endif
+
+#if ETIMER_HEAP_SIZE > 0xffff
+#error "ETIMER_CONF_HEAP_SIZE must not exceed 65535"
+#endif
+
 /**
  * A timer.
  *
@@ -77,6 +99,9 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP_SIZE
+  uint16_t heap_index;
+#endif /* ETIMER_HEAP_SIZE */
 };
 
 /**
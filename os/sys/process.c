@@ -44,6 +44,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "contiki.h"
 #include "sys/process.h"
@@ -65,11 +66,18 @@ struct event_data {
   struct process *p;
 };
 
-static process_num_events_t nevents, fevent;
-static struct event_data events[PROCESS_CONF_NUMEVENTS];
+/*
+ * One ring of events per priority level. nevents is the total number
+ * of queued events across all levels.
+ */
+static struct event_data events[PROCESS_PRIO_LEVELS][PROCESS_CONF_NUMEVENTS];
+static process_num_events_t prio_nevents[PROCESS_PRIO_LEVELS];
+static process_num_events_t prio_fevent[PROCESS_PRIO_LEVELS];
+static unsigned int nevents;
 
 #if PROCESS_CONF_STATS
-process_num_events_t process_maxevents;
+unsigned int process_maxevents;
+uint32_t process_dropped_events[PROCESS_PRIO_LEVELS];
 #endif
 
 static volatile unsigned char poll_requested;
@@ -209,9 +217,12 @@ process_init(void)
 {
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  nevents = 0;
+  memset(prio_nevents, 0, sizeof(prio_nevents));
+  memset(prio_fevent, 0, sizeof(prio_fevent));
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  memset(process_dropped_events, 0, sizeof(process_dropped_events));
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -249,6 +260,8 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
+  struct event_data *e;
+  int prio;
 
   /*
    * If there are any events in the queue, take the first one and walk
@@ -260,15 +273,23 @@ do_event(void)
 
   if(nevents > 0) {
 
-    /* There are events that we should deliver. */
-    ev = events[fevent].ev;
+    /* There are events that we should deliver. Pick the most urgent
+       priority level that has any. */
+    for(prio = PROCESS_PRIO_HIGH; prio > PROCESS_PRIO_NORMAL; prio--) {
+      if(prio_nevents[prio] > 0) {
+        break;
+      }
+    }
 
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    e = &events[prio][prio_fevent[prio]];
+    ev = e->ev;
+    data = e->data;
+    receiver = e->p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    prio_fevent[prio] = (prio_fevent[prio] + 1) % PROCESS_CONF_NUMEVENTS;
+    --prio_nevents[prio];
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -319,34 +340,47 @@ process_nevents(void)
 }
 /*---------------------------------------------------------------------------*/
 int
-process_post(struct process *p, process_event_t ev, process_data_t data)
+process_post_prio(struct process *p, process_event_t ev, process_data_t data,
+                  process_prio_t prio)
 {
   process_num_events_t snum;
+  struct event_data *e;
+
+  if(prio > PROCESS_PRIO_HIGH) {
+    prio = PROCESS_PRIO_HIGH;
+  }
 
   if(PROCESS_CURRENT() == NULL) {
-    PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
-           ev, PROCESS_NAME_STRING(p), nevents);
+    PRINTF("process_post: NULL process posts event %d to process '%s', prio %u, nevents %u\n",
+           ev, PROCESS_NAME_STRING(p), prio, nevents);
   } else {
-    PRINTF("process_post: Process '%s' posts event %d to process '%s', nevents %d\n",
+    PRINTF("process_post: Process '%s' posts event %d to process '%s', prio %u, nevents %u\n",
            PROCESS_NAME_STRING(PROCESS_CURRENT()), ev,
-           p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p), nevents);
+           p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p),
+           prio, nevents);
   }
 
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  if(prio_nevents[prio] == PROCESS_CONF_NUMEVENTS) {
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
-      printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
+      printf("soft panic: event queue %u is full when broadcast event %d was posted from %s\n", prio, ev, PROCESS_NAME_STRING(process_current));
     } else {
-      printf("soft panic: event queue is full when event %d was posted to %s from %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
+      printf("soft panic: event queue %u is full when event %d was posted to %s from %s\n", prio, ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
     }
 #endif /* DEBUG */
+#if PROCESS_CONF_STATS
+    process_dropped_events[prio]++;
+#endif /* PROCESS_CONF_STATS */
     return PROCESS_ERR_FULL;
   }
 
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+  snum = (process_num_events_t)(prio_fevent[prio] + prio_nevents[prio]) %
+    PROCESS_CONF_NUMEVENTS;
+  e = &events[prio][snum];
+  e->ev = ev;
+  e->data = data;
+  e->p = p;
+  ++prio_nevents[prio];
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -358,6 +392,27 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
+int
+process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+#if PROCESS_PRIO_LEVELS > 1
+  if(p != PROCESS_BROADCAST && p != PROCESS_ZOMBIE) {
+    return process_post_prio(p, ev, data, p->prio);
+  }
+#endif /* PROCESS_PRIO_LEVELS > 1 */
+  return process_post_prio(p, ev, data, PROCESS_PRIO_NORMAL);
+}
+/*---------------------------------------------------------------------------*/
+void
+process_set_prio(struct process *p, process_prio_t prio)
+{
+#if PROCESS_PRIO_LEVELS > 1
+  if(p != NULL) {
+    p->prio = prio > PROCESS_PRIO_HIGH ? PROCESS_PRIO_HIGH : prio;
+  }
+#endif /* PROCESS_PRIO_LEVELS > 1 */
+}
+/*---------------------------------------------------------------------------*/
 void
 process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 {
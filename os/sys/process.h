@@ -56,9 +56,12 @@
 #include "sys/pt.h"
 #include "sys/cc.h"
 
+#include <stdint.h>
+
 typedef unsigned char process_event_t;
 typedef void *        process_data_t;
 typedef unsigned char process_num_events_t;
+typedef unsigned char process_prio_t;
 
 /**
  * \name Return values
@@ -88,6 +91,35 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \name Event priorities
+ *
+ * Asynchronous events can be queued at one of several priority
+ * levels. Each level has its own event queue of
+ * PROCESS_CONF_NUMEVENTS entries, so a burst of events at one level
+ * cannot make posting at another level fail. do_event() always
+ * delivers the oldest event of the most urgent non-empty level.
+ *
+ * With the default of a single level, there is only one queue and the
+ * scheduler behaves as a plain FIFO.
+ * @{
+ */
+#ifndef PROCESS_CONF_PRIO_LEVELS
+#define PROCESS_CONF_PRIO_LEVELS 1
+#endif /* PROCESS_CONF_PRIO_LEVELS */
+
+#define PROCESS_PRIO_LEVELS PROCESS_CONF_PRIO_LEVELS
+
+#if PROCESS_PRIO_LEVELS < 1 || PROCESS_PRIO_LEVELS > 8
+#error "PROCESS_CONF_PRIO_LEVELS must be between 1 and 8"
+#endif
+
+/** Priority of events posted with process_post() by default */
+#define PROCESS_PRIO_NORMAL   0
+/** Most urgent priority level (equal to PROCESS_PRIO_NORMAL with one level) */
+#define PROCESS_PRIO_HIGH     (PROCESS_PRIO_LEVELS - 1)
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -323,6 +355,9 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_PRIO_LEVELS > 1
+  process_prio_t prio;
+#endif /* PROCESS_PRIO_LEVELS > 1 */
 };
 
 /**
@@ -364,6 +399,48 @@ void process_start(struct process *p, process_data_t data);
  */
 int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+/**
+ * Post an asynchronous event at a given priority.
+ *
+ * This function works like process_post(), but queues the event at
+ * the specified priority level instead of the default priority of
+ * the receiving process. Levels above PROCESS_PRIO_HIGH are clamped.
+ *
+ * \param p The process to which the event should be posted, or
+ * PROCESS_BROADCAST if the event should be posted to all processes.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \param prio The priority level of the event, between
+ * PROCESS_PRIO_NORMAL and PROCESS_PRIO_HIGH.
+ *
+ * \retval PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval PROCESS_ERR_FULL The event queue of this priority level was
+ * full and the event could not be posted.
+ */
+int process_post_prio(struct process *p, process_event_t ev,
+                      process_data_t data, process_prio_t prio);
+
+/**
+ * \brief      Set the default priority of events posted to a process
+ * \param p    The process
+ * \param prio The priority level used by process_post() for events
+ *             sent to \p p
+ *
+ *             Time-critical system processes (the IP stack, the ctimer
+ *             process) use this to have the events posted to them, such
+ *             as etimer expirations, delivered ahead of queued
+ *             application events. Poll requests (process_poll()) are not
+ *             queued events and are unaffected: as before, they are
+ *             serviced before every event, whatever its priority. This
+ *             function has no effect when only one priority level is
+ *             configured.
+ */
+void process_set_prio(struct process *p, process_prio_t prio);
+
 /**
  * Post a synchronous event to a process.
  *
@@ -521,6 +598,13 @@ int process_nevents(void);
 
 /** @} */
 
+#if PROCESS_CONF_STATS
+/** Highest number of events that were queued at the same time */
+extern unsigned int process_maxevents;
+/** Number of events that were dropped because their queue was full */
+extern uint32_t process_dropped_events[PROCESS_PRIO_LEVELS];
+#endif /* PROCESS_CONF_STATS */
+
 extern struct process *process_list;
 
 #define PROCESS_LIST() process_list
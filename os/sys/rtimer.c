@@ -104,5 +104,17 @@ rtimer_run_next(void)
   return;
 }
 /*---------------------------------------------------------------------------*/
+int
+rtimer_next_expiration_time(rtimer_clock_t *t)
+{
+  struct rtimer *r = next_rtimer;
+
+  if(r == NULL) {
+    return 0;
+  }
+  *t = r->time;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 
 /** @}*/
@@ -172,6 +172,13 @@ int rtimer_set(struct rtimer *task, rtimer_clock_t time,
  */
 void rtimer_run_next(void);
 
+/**
+ * \brief      Get the time at which the scheduled real-time task is due
+ * \param t    Set to the time of the scheduled task, if there is one
+ * \return     Non-zero if a real-time task is scheduled, zero otherwise
+ */
+int rtimer_next_expiration_time(rtimer_clock_t *t);
+
 /**
  * \brief      Get the current clock time
  * \return     The current time
@@ -46,6 +46,10 @@ typedef struct test_struct {
 
 MEMB(memb_pool, test_struct_t, NUM_MEMB_BLOCKS);
 
+/* A pool that spans more than one word of the allocation bitmap */
+#define NUM_LARGE_MEMB_BLOCKS 40
+MEMB(large_pool, uint16_t, NUM_LARGE_MEMB_BLOCKS);
+
 int
 main(void)
 {
@@ -151,5 +155,49 @@ main(void)
     (void)memb_free(&memb_pool, memb_block_p);
   }
 
+  /* the high-water mark should be kept after the blocks are freed */
+  if((ret = memb_high_water(&memb_pool)) != NUM_MEMB_BLOCKS) {
+    printf("test failed: memb_high_water() returns %d, which should be %d\n",
+           ret, NUM_MEMB_BLOCKS);
+    return -1;
+  } else {
+    printf("- memb_high_water is OK\n");
+  }
+
+  /* blocks of a larger pool are allocated in order, and the lowest free
+     block is reused first */
+  uint16_t *large_list[NUM_LARGE_MEMB_BLOCKS];
+  memb_init(&large_pool);
+  for(int i = 0; i < NUM_LARGE_MEMB_BLOCKS; i++) {
+    large_list[i] = memb_alloc(&large_pool);
+    if(large_list[i] != (uint16_t *)large_pool.mem + i) {
+      printf("test failed: memb_alloc() returns %p, which should be %p\n",
+             large_list[i], (uint16_t *)large_pool.mem + i);
+      return -1;
+    }
+  }
+  if(memb_alloc(&large_pool) != NULL) {
+    printf("test failed: memb_alloc() allocates more memory than defined\n");
+    return -1;
+  }
+  (void)memb_free(&large_pool, large_list[35]);
+  (void)memb_free(&large_pool, large_list[3]);
+  if(memb_alloc(&large_pool) != large_list[3] ||
+     memb_alloc(&large_pool) != large_list[35] ||
+     memb_alloc(&large_pool) != NULL) {
+    printf("test failed: memb_alloc() does not reuse the lowest free block\n");
+    return -1;
+  } else if(memb_free(&large_pool, large_list[0] + NUM_LARGE_MEMB_BLOCKS) != -1 ||
+            memb_free(&large_pool, memb_block_list[0]) != -1) {
+    printf("test failed: memb_free() accepts a block of another pool\n");
+    return -1;
+  } else if(memb_numfree(&large_pool) != 0 ||
+            memb_high_water(&large_pool) != NUM_LARGE_MEMB_BLOCKS) {
+    printf("test failed: memb_numfree() or memb_high_water() is invalid\n");
+    return -1;
+  } else {
+    printf("- memb_alloc is OK with %d blocks\n", NUM_LARGE_MEMB_BLOCKS);
+  }
+
   return 0;
 }
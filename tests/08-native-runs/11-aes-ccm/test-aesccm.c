@@ -31,6 +31,7 @@
 #include "contiki.h"
 #include "lib/random.h"
 #include "unit-test.h"
+#include "lib/aes-128.h"
 #include "lib/ccm-star.h"
 #include "lib/hexconv.h"
 #include <string.h>
@@ -166,6 +167,51 @@ UNIT_TEST(aesccm_decrypt)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_encrypt, "AES-128 encryption");
+UNIT_TEST(aes_encrypt)
+{
+  /* FIPS-197, Appendix C.1 */
+  static const char *aes_key = "000102030405060708090a0b0c0d0e0f";
+  static const char *aes_plaintext = "00112233445566778899aabbccddeeff";
+  static const char *aes_ciphertext = "69c4e0d86a7b0430d8cdb78070b4c55a";
+  uint8_t key_bytes[AES_128_KEY_LENGTH];
+  uint8_t plaintext_bytes[AES_128_BLOCK_SIZE];
+  uint8_t ciphertext_bytes[AES_128_BLOCK_SIZE];
+  uint8_t block1[AES_128_BLOCK_SIZE];
+  uint8_t block2[AES_128_BLOCK_SIZE];
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: *** AES-128\n");
+
+  hexconv_unhexlify(aes_key, strlen(aes_key), key_bytes, sizeof(key_bytes));
+  hexconv_unhexlify(aes_plaintext, strlen(aes_plaintext),
+                    plaintext_bytes, sizeof(plaintext_bytes));
+  hexconv_unhexlify(aes_ciphertext, strlen(aes_ciphertext),
+                    ciphertext_bytes, sizeof(ciphertext_bytes));
+
+  /* The software driver */
+  aes_128_driver.set_key(key_bytes);
+  memcpy(block1, plaintext_bytes, sizeof(block1));
+  aes_128_driver.encrypt(block1);
+  UNIT_TEST_ASSERT(!memcmp(block1, ciphertext_bytes, sizeof(block1)));
+
+  /* The platform driver, one block and two blocks at once */
+  AES_128.set_key(key_bytes);
+  memcpy(block1, plaintext_bytes, sizeof(block1));
+  AES_128.encrypt(block1);
+  UNIT_TEST_ASSERT(!memcmp(block1, ciphertext_bytes, sizeof(block1)));
+
+  memcpy(block1, plaintext_bytes, sizeof(block1));
+  memcpy(block2, ciphertext_bytes, sizeof(block2));
+  aes_128_encrypt_pair(block1, block2);
+  UNIT_TEST_ASSERT(!memcmp(block1, ciphertext_bytes, sizeof(block1)));
+  AES_128.encrypt(ciphertext_bytes);
+  UNIT_TEST_ASSERT(!memcmp(block2, ciphertext_bytes, sizeof(block2)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -173,6 +219,7 @@ PROCESS_THREAD(test_process, ev, data)
   printf("Run unit-test\n");
   printf("---\n");
 
+  UNIT_TEST_RUN(aes_encrypt);
   UNIT_TEST_RUN(aesccm_encrypt);
   UNIT_TEST_RUN(aesccm_decrypt);
 
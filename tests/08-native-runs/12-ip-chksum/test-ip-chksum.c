@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "lib/ip-chksum.h"
+#include "lib/hexconv.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct backend {
+  const char *name;
+  uint16_t (*chksum)(uint16_t sum, const uint8_t *data, uint16_t len);
+};
+
+static const struct backend backends[] = {
+  { "reference", ip_chksum_reference },
+  { "word", ip_chksum_word },
+#if defined(__SSE2__)
+  { "sse2", ip_chksum_sse2 },
+#endif /* __SSE2__ */
+#if defined(__ARM_NEON)
+  { "neon", ip_chksum_neon },
+#endif /* __ARM_NEON */
+};
+
+#define NUM_BACKENDS (sizeof(backends) / sizeof(backends[0]))
+
+/* A list of data, initial sum => sum */
+static const struct {
+  const char *data;
+  uint16_t initial;
+  uint16_t sum;
+} testcases[] = {
+  /* RFC 1071, section 3 */
+  { "0001f203f4f5f6f7", 0, 0xddf2 },
+  /* IPv4 header with a zero checksum field */
+  { "450000730000400040110000c0a80001c0a800c7", 0, 0x479e },
+  /* Odd length */
+  { "0001f203f4f5f6", 0, 0xdcfb },
+  { "", 0x1234, 0x1234 },
+  { "0000000000000000000000000000000000", 0, 0 },
+  /* Carries in every word */
+  { "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+    0xffff, 0xff00 },
+  { "8000800080008000800080008000800080", 0x8000, 0x0005 },
+};
+
+#define NUM_TESTCASES (sizeof(testcases) / sizeof(testcases[0]))
+#define RANDOM_TESTS 20000
+#define MAXLEN 1500
+
+static uint8_t buf[MAXLEN + 1];
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ip_chksum_vectors, "Checksum test vectors");
+UNIT_TEST(ip_chksum_vectors)
+{
+  int i, b;
+  uint8_t data[64];
+  size_t len;
+  uint16_t sum;
+  bool success;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < NUM_TESTCASES; i++) {
+    len = hexconv_unhexlify(testcases[i].data, strlen(testcases[i].data),
+                            data, sizeof(data));
+    for(b = 0; b < NUM_BACKENDS; b++) {
+      sum = backends[b].chksum(testcases[i].initial, data, len);
+      success = sum == testcases[i].sum;
+      printf("TEST: %s vector %d: 0x%04x --- %s\n", backends[b].name, i,
+             sum, success ? "OK" : "FAIL");
+      UNIT_TEST_ASSERT(success);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ip_chksum_random, "Checksum backends against reference");
+UNIT_TEST(ip_chksum_random)
+{
+  int i, b;
+  uint16_t offset, len, initial, expected;
+  unsigned errors[NUM_BACKENDS];
+
+  UNIT_TEST_BEGIN();
+
+  memset(errors, 0, sizeof(errors));
+  for(i = 0; i < RANDOM_TESTS; i++) {
+    /* Mostly random data, with runs of 0x00 and 0xff bytes for the
+       corner cases of the carry folding */
+    for(len = 0; len < sizeof(buf); len++) {
+      buf[len] = (i % 3 == 0) ? random_rand() : (i % 3 == 1) ? 0xff : 0;
+    }
+    offset = random_rand() % 2;
+    len = random_rand() % (MAXLEN + 1);
+    initial = random_rand();
+
+    expected = ip_chksum_reference(initial, buf + offset, len);
+    for(b = 0; b < NUM_BACKENDS; b++) {
+      if(backends[b].chksum(initial, buf + offset, len) != expected) {
+        errors[b]++;
+      }
+    }
+  }
+
+  for(b = 0; b < NUM_BACKENDS; b++) {
+    printf("TEST: %s: %d random inputs, %u errors --- %s\n",
+           backends[b].name, RANDOM_TESTS, errors[b],
+           errors[b] == 0 ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(errors[b] == 0);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ip_chksum_adjust, "Incremental checksum update");
+UNIT_TEST(ip_chksum_adjust)
+{
+  int i, j;
+  uint16_t len, pos, field_len, chksum, old_sum, new_sum;
+  unsigned errors = 0;
+  bool success;
+
+  UNIT_TEST_BEGIN();
+
+  /* RFC 1624, section 4 */
+  chksum = ip_chksum_adjust(0xdd2f, 0x5555, 0x3285);
+  success = chksum == 0x0000;
+  printf("TEST: RFC 1624 example: 0x%04x --- %s\n", chksum,
+         success ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(success);
+
+  /* Rewrite random fields of random packets. The checksum field is
+     the first word of the packet and is not itself rewritten. */
+  for(i = 0; i < RANDOM_TESTS; i++) {
+    len = 8 + 2 * (random_rand() % (MAXLEN / 2 - 4));
+    for(j = 2; j < len; j++) {
+      buf[j] = random_rand();
+    }
+    buf[0] = buf[1] = 0;
+    chksum = ~IP_CHKSUM(0, buf, len);
+    buf[0] = chksum >> 8;
+    buf[1] = chksum & 0xff;
+
+    pos = 2 + 2 * (random_rand() % ((len - 2) / 2));
+    field_len = 2 * (1 + random_rand() % 4);
+    if(pos + field_len > len) {
+      field_len = len - pos;
+    }
+    old_sum = IP_CHKSUM(0, buf + pos, field_len);
+    for(j = 0; j < field_len; j++) {
+      buf[pos + j] = (i % 2) ? random_rand() : 0xff;
+    }
+    new_sum = IP_CHKSUM(0, buf + pos, field_len);
+
+    chksum = ip_chksum_adjust((buf[0] << 8) | buf[1], old_sum, new_sum);
+    buf[0] = chksum >> 8;
+    buf[1] = chksum & 0xff;
+
+    /* A correct checksum sums the packet to 0xffff */
+    if(ip_chksum_reference(0, buf, len) != 0xffff) {
+      errors++;
+    }
+  }
+  printf("TEST: %d random updates, %u errors --- %s\n", RANDOM_TESTS,
+         errors, errors == 0 ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(ip_chksum_vectors);
+  UNIT_TEST_RUN(ip_chksum_random);
+  UNIT_TEST_RUN(ip_chksum_adjust);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,11 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define SICSLOWPAN_CONF_REASS_CONTEXTS   8
+#define SICSLOWPAN_CONF_REASS_BUF_SIZE   4096
+#define SICSLOWPAN_CONF_REASS_HASH_INDEX 1
+
+#define LOG_CONF_LEVEL_6LOWPAN LOG_LEVEL_NONE
+#define LOG_CONF_LEVEL_IPV6    LOG_LEVEL_NONE
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/sicslowpan.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Bytes of the packet carried by each fragment: a multiple of 8 */
+#define CHUNK 96
+#define MAX_FRAGS (UIP_BUFSIZE / CHUNK + 1)
+#define MAX_PACKETS 8
+
+struct frame {
+  uint8_t data[SICSLOWPAN_FRAGN_HDR_LEN + 1 + CHUNK];
+  uint16_t len;
+};
+
+struct packet {
+  linkaddr_t sender;
+  uint16_t tag;
+  uint16_t len;
+  uint8_t data[UIP_BUFSIZE];
+  struct frame frames[MAX_FRAGS];
+  int num_frames;
+  int delivered;
+};
+
+static struct packet packets[MAX_PACKETS];
+static struct sicslowpan_reass_stats stats_before;
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  int i;
+
+  for(i = 0; i < MAX_PACKETS; i++) {
+    if(packets[i].len == uip_len &&
+       memcmp(uip_buf, packets[i].data, uip_len) == 0) {
+      packets[i].delivered++;
+    }
+  }
+}
+NETSTACK_SNIFFER(sniffer, input_callback, NULL);
+/*---------------------------------------------------------------------------*/
+/* Creates a packet with random payload and splits it into fragments.
+   The first fragment carries the IPv6 header uncompressed. */
+static void
+make_packet(struct packet *p, int sender, uint16_t tag, uint16_t len)
+{
+  struct frame *f;
+  uint16_t offset, n;
+  int i;
+
+  memset(p, 0, sizeof(*p));
+  p->sender.u8[0] = 0x02;
+  p->sender.u8[LINKADDR_SIZE - 1] = sender;
+  p->tag = tag;
+  p->len = len;
+
+  p->data[0] = 0x60;
+  p->data[4] = (len - UIP_IPH_LEN) >> 8;
+  p->data[5] = (len - UIP_IPH_LEN) & 0xff;
+  p->data[6] = UIP_PROTO_NONE;
+  p->data[7] = 64;
+  p->data[8] = 0xfe;
+  p->data[9] = 0x80;
+  p->data[23] = sender;
+  p->data[24] = 0xfe;
+  p->data[25] = 0x80;
+  p->data[39] = 0xfe;
+  for(i = UIP_IPH_LEN; i < len; i++) {
+    p->data[i] = random_rand();
+  }
+
+  for(offset = 0; offset < len; offset += n) {
+    f = &p->frames[p->num_frames++];
+    n = len - offset < CHUNK ? len - offset : CHUNK;
+    f->data[0] = (offset == 0 ? SICSLOWPAN_DISPATCH_FRAG1 : SICSLOWPAN_DISPATCH_FRAGN) | (len >> 8);
+    f->data[1] = len & 0xff;
+    f->data[2] = tag >> 8;
+    f->data[3] = tag & 0xff;
+    if(offset == 0) {
+      f->data[4] = SICSLOWPAN_DISPATCH_IPV6;
+      memcpy(&f->data[5], p->data, n);
+      f->len = 5 + n;
+    } else {
+      f->data[4] = offset / 8;
+      memcpy(&f->data[5], &p->data[offset], n);
+      f->len = 5 + n;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+inject(struct packet *p, int frame)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(p->frames[frame].data, p->frames[frame].len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &p->sender);
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+static void
+shuffle(int *order, int n)
+{
+  int i, j, tmp;
+
+  for(i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  for(i = n - 1; i > 0; i--) {
+    j = random_rand() % (i + 1);
+    tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+stats_start(void)
+{
+  stats_before = *sicslowpan_get_reass_stats();
+}
+/*---------------------------------------------------------------------------*/
+#define STATS_DELTA(field) \
+  (sicslowpan_get_reass_stats()->field - stats_before.field)
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(reass_in_order, "Reassembly in order");
+UNIT_TEST(reass_in_order)
+{
+  int i, f;
+  static const uint16_t sizes[] = { 100, 192, 577, 1000, UIP_BUFSIZE };
+
+  UNIT_TEST_BEGIN();
+
+  stats_start();
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    make_packet(&packets[0], 1, 100 + i, sizes[i]);
+    for(f = 0; f < packets[0].num_frames; f++) {
+      inject(&packets[0], f);
+    }
+    printf("TEST: %u bytes, %d fragments, delivered %d\n",
+           sizes[i], packets[0].num_frames, packets[0].delivered);
+    UNIT_TEST_ASSERT(packets[0].delivered == 1);
+  }
+  UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == i);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(reass_out_of_order, "Reassembly out of order, interleaved");
+UNIT_TEST(reass_out_of_order)
+{
+  static int order[MAX_PACKETS * MAX_FRAGS];
+  int round, i, n;
+
+  UNIT_TEST_BEGIN();
+
+  stats_start();
+  for(round = 0; round < 20; round++) {
+    /* Eight senders, with the same tag, 300 to 500 bytes each so that
+       all packets fit in the reassembly buffer together */
+    n = 0;
+    for(i = 0; i < MAX_PACKETS; i++) {
+      make_packet(&packets[i], i + 1, 7, 300 + random_rand() % 200);
+      n += packets[i].num_frames;
+    }
+    /* Interleave the fragments of all packets in random order */
+    shuffle(order, n);
+    for(i = 0; i < n; i++) {
+      int p = 0, f = order[i];
+      while(f >= packets[p].num_frames) {
+        f -= packets[p].num_frames;
+        p++;
+      }
+      inject(&packets[p], f);
+    }
+    for(i = 0; i < MAX_PACKETS; i++) {
+      UNIT_TEST_ASSERT(packets[i].delivered == 1);
+    }
+  }
+  printf("TEST: reassembled %lu packets\n",
+         (unsigned long)STATS_DELTA(reassembled));
+  UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == 20 * MAX_PACKETS);
+  UNIT_TEST_ASSERT(STATS_DELTA(no_context) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(reass_duplicates, "Duplicate and overlapping fragments");
+UNIT_TEST(reass_duplicates)
+{
+  int f;
+  struct frame *last;
+
+  UNIT_TEST_BEGIN();
+
+  /* Every fragment received twice */
+  stats_start();
+  make_packet(&packets[0], 1, 200, 1000);
+  for(f = 0; f < packets[0].num_frames; f++) {
+    inject(&packets[0], f);
+    if(f < packets[0].num_frames - 1) {
+      inject(&packets[0], f);
+    }
+  }
+  UNIT_TEST_ASSERT(packets[0].delivered == 1);
+  UNIT_TEST_ASSERT(STATS_DELTA(duplicates) == packets[0].num_frames - 1);
+
+  /* A fragment that overlaps with two others drops the packet */
+  stats_start();
+  make_packet(&packets[0], 1, 201, 1000);
+  inject(&packets[0], 0);
+  inject(&packets[0], 1);
+  last = &packets[0].frames[packets[0].num_frames - 1];
+  *last = packets[0].frames[2];
+  last->data[4] -= 4;
+  inject(&packets[0], packets[0].num_frames - 1);
+  UNIT_TEST_ASSERT(STATS_DELTA(overlaps) == 1);
+  UNIT_TEST_ASSERT(packets[0].delivered == 0);
+
+  /* A fragment past the end of the packet drops the packet */
+  stats_start();
+  make_packet(&packets[0], 1, 202, 500);
+  inject(&packets[0], 0);
+  packets[0].frames[1].data[4] = 62;
+  inject(&packets[0], 1);
+  UNIT_TEST_ASSERT(STATS_DELTA(invalid) == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(reass_buffer, "Contexts and buffer space");
+UNIT_TEST(reass_buffer)
+{
+  int i, f;
+
+  UNIT_TEST_BEGIN();
+
+  /* Four packets of 1000 bytes fill the 4096-byte buffer */
+  stats_start();
+  for(i = 0; i < 4; i++) {
+    make_packet(&packets[i], i + 1, 300, 1000);
+    inject(&packets[i], 0);
+  }
+  UNIT_TEST_ASSERT(STATS_DELTA(no_context) == 0);
+
+  /* No room for a fifth one */
+  make_packet(&packets[4], 5, 300, 1000);
+  inject(&packets[4], 0);
+  UNIT_TEST_ASSERT(STATS_DELTA(no_context) == 1);
+
+  /* Complete the first and third packets: their space is free again,
+     but split in two, so the buffer must be compacted for a packet of
+     1500 bytes */
+  for(i = 0; i < 4; i += 2) {
+    for(f = 1; f < packets[i].num_frames; f++) {
+      inject(&packets[i], f);
+    }
+    UNIT_TEST_ASSERT(packets[i].delivered == 1);
+  }
+  make_packet(&packets[4], 5, 301, UIP_BUFSIZE);
+  for(f = 0; f < packets[4].num_frames; f++) {
+    inject(&packets[4], f);
+  }
+  UNIT_TEST_ASSERT(packets[4].delivered == 1);
+
+  /* The packets that were moved are still reassembled correctly */
+  for(i = 1; i < 4; i += 2) {
+    for(f = 1; f < packets[i].num_frames; f++) {
+      inject(&packets[i], f);
+    }
+    UNIT_TEST_ASSERT(packets[i].delivered == 1);
+  }
+  UNIT_TEST_ASSERT(STATS_DELTA(no_context) == 1);
+  UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == 5);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static bool timeout_ok;
+
+  PROCESS_BEGIN();
+
+  netstack_sniffer_add(&sniffer);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(reass_in_order);
+  UNIT_TEST_RUN(reass_out_of_order);
+  UNIT_TEST_RUN(reass_duplicates);
+  UNIT_TEST_RUN(reass_buffer);
+
+  /* An incomplete packet times out */
+  stats_start();
+  make_packet(&packets[0], 1, 400, 1000);
+  inject(&packets[0], 0);
+  etimer_set(&et, (SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16) + CLOCK_SECOND / 4);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  inject(&packets[0], 1);
+  timeout_ok = STATS_DELTA(timeouts) == 1 && packets[0].delivered == 0;
+  printf("TEST: timeout --- %s\n", timeout_ok ? "OK" : "FAIL");
+  if(!timeout_ok ||
+     UNIT_TEST_RESULT(reass_in_order) != unit_test_success ||
+     UNIT_TEST_RESULT(reass_out_of_order) != unit_test_success ||
+     UNIT_TEST_RESULT(reass_duplicates) != unit_test_success ||
+     UNIT_TEST_RESULT(reass_buffer) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/mac/mac.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/ipv6/sicslowpan.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Bytes of the packet carried by each fragment: a multiple of 8 */
+#define CHUNK 96
+#define MAX_FRAGS (UIP_BUFSIZE / CHUNK + 1)
+#define MAX_PACKETS 4
+#define MAX_SENT 64
+#define FRAME_SIZE 127
+
+struct frame {
+  uint8_t data[FRAME_SIZE];
+  uint16_t len;
+  linkaddr_t receiver;
+};
+
+struct packet {
+  linkaddr_t sender;
+  uint16_t tag;
+  uint16_t len;
+  uint8_t data[UIP_BUFSIZE];
+  struct frame frames[MAX_FRAGS];
+  int num_frames;
+};
+
+static struct packet packets[MAX_PACKETS];
+static struct frame sent[MAX_SENT];
+static int num_sent;
+static int num_delivered;
+static struct sicslowpan_reass_stats stats_before;
+
+static const linkaddr_t next_hop_ll = { { 0x02, 0x12, 0x74, 0x02, 0x00, 0x02, 0x02, 0x02 } };
+static uip_ipaddr_t next_hop_ip;
+/*---------------------------------------------------------------------------*/
+/* A MAC driver that records the frames sent by 6LoWPAN */
+static void
+mac_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_send(mac_callback_t sent_callback, void *ptr)
+{
+  if(num_sent < MAX_SENT && packetbuf_datalen() <= FRAME_SIZE) {
+    memcpy(sent[num_sent].data, packetbuf_dataptr(), packetbuf_datalen());
+    sent[num_sent].len = packetbuf_datalen();
+    linkaddr_copy(&sent[num_sent].receiver,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    num_sent++;
+  }
+  mac_call_sent_callback(sent_callback, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_max_payload(void)
+{
+  return FRAME_SIZE - 17;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver test_mac_driver = {
+  "test-mac",
+  mac_init,
+  mac_send,
+  mac_input,
+  mac_on,
+  mac_off,
+  mac_max_payload,
+};
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  num_delivered++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+output_callback(int mac_status)
+{
+}
+NETSTACK_SNIFFER(sniffer, input_callback, output_callback);
+/*---------------------------------------------------------------------------*/
+/* Creates a UDP packet from fd00::<sender> with random payload and splits it
+   into fragments. The first fragment carries the IPv6 header
+   uncompressed. */
+static void
+make_packet(struct packet *p, int sender, uint16_t tag, uint16_t len,
+            const uip_ipaddr_t *dest, uint8_t hop_limit)
+{
+  struct frame *f;
+  uint16_t offset, n;
+  int i;
+
+  memset(p, 0, sizeof(*p));
+  p->sender.u8[0] = 0x02;
+  p->sender.u8[LINKADDR_SIZE - 1] = sender;
+  p->tag = tag;
+  p->len = len;
+
+  p->data[0] = 0x60;
+  p->data[4] = (len - UIP_IPH_LEN) >> 8;
+  p->data[5] = (len - UIP_IPH_LEN) & 0xff;
+  p->data[6] = UIP_PROTO_UDP;
+  p->data[7] = hop_limit;
+  p->data[8] = 0xfd;
+  p->data[23] = sender;
+  memcpy(&p->data[24], dest, sizeof(*dest));
+  for(i = UIP_IPH_LEN; i < len; i++) {
+    p->data[i] = random_rand();
+  }
+  /* UDP header, with ports that 6LoWPAN does not compress */
+  p->data[UIP_IPH_LEN + 4] = (len - UIP_IPH_LEN) >> 8;
+  p->data[UIP_IPH_LEN + 5] = (len - UIP_IPH_LEN) & 0xff;
+
+  for(offset = 0; offset < len; offset += n) {
+    f = &p->frames[p->num_frames++];
+    n = len - offset < CHUNK ? len - offset : CHUNK;
+    f->data[0] = (offset == 0 ? SICSLOWPAN_DISPATCH_FRAG1 : SICSLOWPAN_DISPATCH_FRAGN) | (len >> 8);
+    f->data[1] = len & 0xff;
+    f->data[2] = tag >> 8;
+    f->data[3] = tag & 0xff;
+    if(offset == 0) {
+      f->data[4] = SICSLOWPAN_DISPATCH_IPV6;
+    } else {
+      f->data[4] = offset / 8;
+    }
+    memcpy(&f->data[5], &p->data[offset], n);
+    f->len = 5 + n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+inject(struct packet *p, int frame)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(p->frames[frame].data, p->frames[frame].len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &p->sender);
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+frame_tag(const struct frame *f)
+{
+  return (f->data[2] << 8) | f->data[3];
+}
+/*---------------------------------------------------------------------------*/
+/* Checks that the frames sent from index first forward packet p: a
+   first fragment with its payload, and then the other fragments
+   unchanged but for their tag */
+static int
+check_forwarded(const struct packet *p, int first)
+{
+  const struct frame *in, *out;
+  uint16_t tag;
+  int i, n;
+
+  out = &sent[first];
+  if(!linkaddr_cmp(&out->receiver, &next_hop_ll) ||
+     (out->data[0] & 0xf8) != SICSLOWPAN_DISPATCH_FRAG1 ||
+     (((out->data[0] & 0x07) << 8) | out->data[1]) != p->len) {
+    return 0;
+  }
+  /* The first fragment ends with the same payload, after compressed
+     headers */
+  in = &p->frames[0];
+  n = in->len - 5 - UIP_IPH_LEN - UIP_UDPH_LEN;
+  if(memcmp(&out->data[out->len - n], &in->data[in->len - n], n) != 0) {
+    return 0;
+  }
+
+  tag = frame_tag(out);
+  for(i = 1; i < p->num_frames; i++) {
+    in = &p->frames[i];
+    out = &sent[first + i];
+    if(!linkaddr_cmp(&out->receiver, &next_hop_ll) ||
+       frame_tag(out) != tag || out->len != in->len ||
+       out->data[0] != in->data[0] || out->data[1] != in->data[1] ||
+       memcmp(&out->data[4], &in->data[4], in->len - 4) != 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Counts the packets sent: the frames that do not carry a non-first
+   fragment */
+static int
+count_packets(void)
+{
+  int i, n;
+
+  for(i = n = 0; i < num_sent; i++) {
+    if((sent[i].data[0] & 0xf8) != SICSLOWPAN_DISPATCH_FRAGN) {
+      n++;
+    }
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stats_start(void)
+{
+  stats_before = *sicslowpan_get_reass_stats();
+  num_sent = 0;
+  num_delivered = 0;
+}
+/*---------------------------------------------------------------------------*/
+#define STATS_DELTA(field) \
+  (sicslowpan_get_reass_stats()->field - stats_before.field)
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(fwd_in_order, "Forward fragments as they arrive");
+UNIT_TEST(fwd_in_order)
+{
+  static const uint16_t sizes[] = { 200, 577, 1000, UIP_BUFSIZE };
+  uip_ipaddr_t dest;
+  int i, f;
+
+  UNIT_TEST_BEGIN();
+
+  uip_ip6addr(&dest, 0xfd00, 0, 0, 0, 0, 0, 0, 0x99);
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    stats_start();
+    make_packet(&packets[0], 1, 100 + i, sizes[i], &dest, 64);
+    for(f = 0; f < packets[0].num_frames; f++) {
+      inject(&packets[0], f);
+      /* Each fragment is sent on as soon as it is received */
+      UNIT_TEST_ASSERT(num_sent == f + 1);
+    }
+    printf("TEST: %u bytes, %d fragments, sent %d\n",
+           sizes[i], packets[0].num_frames, num_sent);
+    UNIT_TEST_ASSERT(check_forwarded(&packets[0], 0));
+    UNIT_TEST_ASSERT(STATS_DELTA(forwarded) == 1);
+    UNIT_TEST_ASSERT(STATS_DELTA(forwarded_fragments) == packets[0].num_frames - 1);
+    UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == 0);
+    UNIT_TEST_ASSERT(num_delivered == 0);
+  }
+
+  /* A fragment received again is not forwarded again, and the packet
+     is forwarded in full */
+  stats_start();
+  make_packet(&packets[0], 1, 110, 1000, &dest, 64);
+  inject(&packets[0], 0);
+  inject(&packets[0], 0);
+  UNIT_TEST_ASSERT(num_sent == 1);
+  UNIT_TEST_ASSERT(STATS_DELTA(duplicates) == 1);
+  for(f = 1; f < packets[0].num_frames; f++) {
+    inject(&packets[0], f);
+    inject(&packets[0], f);
+  }
+  UNIT_TEST_ASSERT(num_sent == packets[0].num_frames);
+  UNIT_TEST_ASSERT(STATS_DELTA(duplicates) == packets[0].num_frames);
+  UNIT_TEST_ASSERT(STATS_DELTA(forwarded_fragments) == packets[0].num_frames - 1);
+  UNIT_TEST_ASSERT(check_forwarded(&packets[0], 0));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(fwd_interleaved, "Forward interleaved packets");
+UNIT_TEST(fwd_interleaved)
+{
+  uip_ipaddr_t dest;
+  uint16_t tags[MAX_PACKETS];
+  int i, j, f;
+
+  UNIT_TEST_BEGIN();
+
+  /* Four senders using the same tag */
+  stats_start();
+  uip_ip6addr(&dest, 0xfd00, 0, 0, 0, 0, 0, 0, 0x99);
+  for(i = 0; i < MAX_PACKETS; i++) {
+    make_packet(&packets[i], i + 1, 7, 1000, &dest, 64);
+  }
+  for(f = 0; f < packets[0].num_frames; f++) {
+    for(i = 0; i < MAX_PACKETS; i++) {
+      inject(&packets[i], f);
+    }
+  }
+  UNIT_TEST_ASSERT(num_sent == MAX_PACKETS * packets[0].num_frames);
+  UNIT_TEST_ASSERT(STATS_DELTA(forwarded) == MAX_PACKETS);
+
+  /* The packets get distinct tags, and their fragments are in turn */
+  for(i = 0; i < MAX_PACKETS; i++) {
+    tags[i] = frame_tag(&sent[i]);
+    for(j = 0; j < i; j++) {
+      UNIT_TEST_ASSERT(tags[i] != tags[j]);
+    }
+    for(f = 0; f < packets[i].num_frames; f++) {
+      UNIT_TEST_ASSERT(frame_tag(&sent[f * MAX_PACKETS + i]) == tags[i]);
+      UNIT_TEST_ASSERT(f == 0 || memcmp(&sent[f * MAX_PACKETS + i].data[4],
+                                        &packets[i].frames[f].data[4],
+                                        packets[i].frames[f].len - 4) == 0);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(fwd_fallback, "Reassemble when fragments cannot be forwarded");
+UNIT_TEST(fwd_fallback)
+{
+  uip_ipaddr_t dest;
+  int f;
+
+  UNIT_TEST_BEGIN();
+
+  /* The first fragment arrives last: the packet is reassembled, then
+     fragmented again */
+  stats_start();
+  uip_ip6addr(&dest, 0xfd00, 0, 0, 0, 0, 0, 0, 0x99);
+  make_packet(&packets[0], 1, 300, 1000, &dest, 64);
+  for(f = packets[0].num_frames - 1; f >= 0; f--) {
+    inject(&packets[0], f);
+  }
+  UNIT_TEST_ASSERT(STATS_DELTA(forwarded) == 0);
+  UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == 1);
+  UNIT_TEST_ASSERT(num_sent > 1);
+  UNIT_TEST_ASSERT((sent[0].data[0] & 0xf8) == SICSLOWPAN_DISPATCH_FRAG1);
+  UNIT_TEST_ASSERT(linkaddr_cmp(&sent[0].receiver, &next_hop_ll));
+
+  /* A packet for us is reassembled and delivered */
+  stats_start();
+  uip_ip6addr(&dest, 0xfe80, 0, 0, 0, 0, 0, 0, 0x99);
+  make_packet(&packets[0], 1, 301, 1000, &dest, 64);
+  for(f = 0; f < packets[0].num_frames; f++) {
+    inject(&packets[0], f);
+  }
+  UNIT_TEST_ASSERT(STATS_DELTA(forwarded) == 0);
+  UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == 1);
+  UNIT_TEST_ASSERT(num_delivered == 1);
+
+  /* A packet that the IP stack does not forward is not forwarded
+     fragment by fragment either. The first fragment gets the only
+     ICMPv6 error, and the packet is not reassembled afterwards. */
+  stats_start();
+  uip_ip6addr(&dest, 0xfd00, 0, 0, 0, 0, 0, 0, 0x99);
+  make_packet(&packets[0], 1, 302, 1000, &dest, 1);
+  inject(&packets[0], 0);
+  /* A retransmitted first fragment is not answered again */
+  inject(&packets[0], 0);
+  for(f = 1; f < packets[0].num_frames; f++) {
+    inject(&packets[0], f);
+  }
+  UNIT_TEST_ASSERT(STATS_DELTA(forwarded) == 0);
+  UNIT_TEST_ASSERT(STATS_DELTA(forwarded_fragments) == 0);
+  UNIT_TEST_ASSERT(STATS_DELTA(reassembled) == 0);
+  UNIT_TEST_ASSERT(num_delivered == 0);
+  UNIT_TEST_ASSERT(count_packets() == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  netstack_sniffer_add(&sniffer);
+
+  /* Route everything through a neighbor */
+  uip_ip6addr(&next_hop_ip, 0xfe80, 0, 0, 0, 0x0012, 0x7402, 0x0002, 0x0202);
+  uip_ds6_nbr_add(&next_hop_ip, (const uip_lladdr_t *)&next_hop_ll, 1,
+                  NBR_REACHABLE, NBR_TABLE_REASON_UNDEFINED, NULL);
+  uip_ds6_defrt_add(&next_hop_ip, 0);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(fwd_in_order);
+  UNIT_TEST_RUN(fwd_interleaved);
+  UNIT_TEST_RUN(fwd_fallback);
+
+  if(UNIT_TEST_RESULT(fwd_in_order) != unit_test_success ||
+     UNIT_TEST_RESULT(fwd_interleaved) != unit_test_success ||
+     UNIT_TEST_RESULT(fwd_fallback) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,13 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define NETSTACK_CONF_NETWORK sicslowpan_driver
+#define NETSTACK_CONF_MAC     test_mac_driver
+
+#define SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS       4
+#define SICSLOWPAN_CONF_ADDR_CONTEXT_CACHE_SIZE 4
+
+#define LOG_CONF_LEVEL_6LOWPAN LOG_LEVEL_NONE
+#define LOG_CONF_LEVEL_IPV6    LOG_LEVEL_NONE
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/mac/mac.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/sicslowpan.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define PACKET_LEN 80
+#define FRAME_SIZE 127
+
+struct frame {
+  uint8_t data[FRAME_SIZE];
+  uint16_t len;
+};
+
+static uint8_t packet[PACKET_LEN];
+static uint8_t received[PACKET_LEN];
+static struct frame frame;
+static int num_sent;
+static int num_received;
+
+static linkaddr_t next_hop_ll = { { 0x02, 0x12, 0x74, 0x02, 0x00, 0x02, 0x02, 0x02 } };
+/*---------------------------------------------------------------------------*/
+/* A MAC driver that records the last frame sent by 6LoWPAN */
+static void
+mac_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_send(mac_callback_t sent_callback, void *ptr)
+{
+  if(packetbuf_datalen() <= FRAME_SIZE) {
+    memcpy(frame.data, packetbuf_dataptr(), packetbuf_datalen());
+    frame.len = packetbuf_datalen();
+    num_sent++;
+  }
+  mac_call_sent_callback(sent_callback, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_max_payload(void)
+{
+  return FRAME_SIZE - 17;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver test_mac_driver = {
+  "test-mac",
+  mac_init,
+  mac_send,
+  mac_input,
+  mac_on,
+  mac_off,
+  mac_max_payload,
+};
+/*---------------------------------------------------------------------------*/
+/* Records the packet decompressed by 6LoWPAN */
+static void
+input_callback(void)
+{
+  if(uip_len == PACKET_LEN) {
+    memcpy(received, uip_buf, PACKET_LEN);
+    num_received++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+output_callback(int mac_status)
+{
+}
+NETSTACK_SNIFFER(sniffer, input_callback, output_callback);
+/*---------------------------------------------------------------------------*/
+/* Compresses a UDP packet from <src_prefix>::<our IID> to
+   <dest_prefix>::<the next hop IID>. Returns the IPHC header size,
+   that is, the frame size without the UDP header and payload. */
+static int
+compress(uint16_t src_prefix, uint16_t dest_prefix)
+{
+  uip_ipaddr_t addr;
+  int i;
+
+  memset(packet, 0, sizeof(packet));
+  packet[0] = 0x60;
+  packet[5] = PACKET_LEN - UIP_IPH_LEN;
+  packet[6] = UIP_PROTO_UDP;
+  packet[7] = 64;
+  uip_ip6addr(&addr, src_prefix, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&addr, &uip_lladdr);
+  memcpy(&packet[8], &addr, sizeof(addr));
+  uip_ip6addr(&addr, dest_prefix, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&addr, (uip_lladdr_t *)&next_hop_ll);
+  memcpy(&packet[24], &addr, sizeof(addr));
+  /* UDP header, with ports that 6LoWPAN does not compress */
+  for(i = UIP_IPH_LEN; i < PACKET_LEN; i++) {
+    packet[i] = random_rand();
+  }
+  packet[UIP_IPH_LEN + 4] = 0;
+  packet[UIP_IPH_LEN + 5] = PACKET_LEN - UIP_IPH_LEN;
+
+  uipbuf_clear();
+  memcpy(uip_buf, packet, PACKET_LEN);
+  uip_len = PACKET_LEN;
+  num_sent = 0;
+  NETSTACK_NETWORK.output(&next_hop_ll);
+  if(num_sent != 1) {
+    return -1;
+  }
+  /* The UDP header is compressed to 7 bytes: NHC, ports and checksum */
+  return frame.len - (PACKET_LEN - UIP_IPH_LEN - UIP_UDPH_LEN) - 7;
+}
+/*---------------------------------------------------------------------------*/
+/* Decompresses the last frame sent, and checks that it results in the
+   packet that was compressed */
+static int
+decompress(void)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(frame.data, frame.len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop_ll);
+  num_received = 0;
+  sicslowpan_driver.input();
+  return num_received == 1 && memcmp(received, packet, PACKET_LEN) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+set_context(uint8_t number, uint16_t prefix, uint8_t compress,
+            unsigned long lifetime)
+{
+  uip_ipaddr_t addr;
+
+  uip_ip6addr(&addr, prefix, 0, 0, 0, 0, 0, 0, 0);
+  return sicslowpan_addr_context_set(number, &addr, compress, lifetime);
+}
+/*---------------------------------------------------------------------------*/
+#define IPHC_CID(f) ((f).data[1] & SICSLOWPAN_IPHC_CID)
+#define IPHC_SAC(f) ((f).data[1] & SICSLOWPAN_IPHC_SAC)
+#define IPHC_DAC(f) ((f).data[1] & SICSLOWPAN_IPHC_DAC)
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ctx_compress, "Compress with several contexts");
+UNIT_TEST(ctx_compress)
+{
+  int base, len;
+
+  UNIT_TEST_BEGIN();
+
+  /* Context 0 is fd00::/64: no context identifier byte is needed */
+  base = compress(0xfd00, 0xfd00);
+  printf("TEST: context 0 header %d bytes\n", base);
+  UNIT_TEST_ASSERT(base > 0);
+  UNIT_TEST_ASSERT(!IPHC_CID(frame) && IPHC_SAC(frame) && IPHC_DAC(frame));
+  UNIT_TEST_ASSERT(decompress());
+
+  /* Other contexts cost one byte */
+  UNIT_TEST_ASSERT(set_context(3, 0xfd01, 1, 0));
+  UNIT_TEST_ASSERT(set_context(9, 0xfd02, 1, 0));
+  len = compress(0xfd01, 0xfd02);
+  UNIT_TEST_ASSERT(len == base + 1);
+  UNIT_TEST_ASSERT(IPHC_CID(frame) && IPHC_SAC(frame) && IPHC_DAC(frame));
+  UNIT_TEST_ASSERT(frame.data[2] == 0x39);
+  UNIT_TEST_ASSERT(decompress());
+
+  len = compress(0xfd00, 0xfd01);
+  UNIT_TEST_ASSERT(len == base + 1);
+  UNIT_TEST_ASSERT(frame.data[2] == 0x03);
+  UNIT_TEST_ASSERT(decompress());
+
+  /* Without a context, the address is carried inline */
+  len = compress(0xfd03, 0xfd00);
+  UNIT_TEST_ASSERT(len == base + 16);
+  UNIT_TEST_ASSERT(!IPHC_CID(frame) && !IPHC_SAC(frame) && IPHC_DAC(frame));
+  UNIT_TEST_ASSERT(decompress());
+
+  /* Until all contexts are in use */
+  UNIT_TEST_ASSERT(set_context(4, 0xfd04, 1, 0));
+  UNIT_TEST_ASSERT(!set_context(5, 0xfd05, 1, 0));
+  UNIT_TEST_ASSERT(set_context(4, 0xfd06, 1, 0));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ctx_update, "Update and remove contexts");
+UNIT_TEST(ctx_update)
+{
+  int base, len, i;
+
+  UNIT_TEST_BEGIN();
+
+  base = compress(0xfd00, 0xfd00);
+
+  /* The matches of fd01::/64 and fd03::/64 are cached; they change with
+     the contexts */
+  UNIT_TEST_ASSERT(compress(0xfd01, 0xfd00) == base + 1);
+  UNIT_TEST_ASSERT(sicslowpan_addr_context_rm(3));
+  UNIT_TEST_ASSERT(!sicslowpan_addr_context_rm(3));
+  UNIT_TEST_ASSERT(sicslowpan_addr_context_get(3) == NULL);
+  len = compress(0xfd01, 0xfd00);
+  UNIT_TEST_ASSERT(len == base + 16);
+  UNIT_TEST_ASSERT(!IPHC_SAC(frame));
+  UNIT_TEST_ASSERT(set_context(7, 0xfd03, 1, 0));
+  len = compress(0xfd03, 0xfd00);
+  UNIT_TEST_ASSERT(len == base + 1);
+  UNIT_TEST_ASSERT(frame.data[2] == 0x70);
+  UNIT_TEST_ASSERT(decompress());
+
+  /* Changing the prefix of a context */
+  UNIT_TEST_ASSERT(set_context(7, 0xfd01, 1, 0));
+  UNIT_TEST_ASSERT(compress(0xfd03, 0xfd00) == base + 16);
+  UNIT_TEST_ASSERT(compress(0xfd01, 0xfd00) == base + 1);
+  UNIT_TEST_ASSERT(decompress());
+
+  /* Many prefixes share the cache entries */
+  for(i = 0; i < 64; i++) {
+    len = compress(0xfd00 + (i % 4), 0xfd00 + (i % 3));
+    UNIT_TEST_ASSERT(len == base + ((i % 4) == 3 ? 16 : 0) +
+                     ((i % 4) == 1 || (i % 4) == 2 || (i % 3) == 1 || (i % 3) == 2 ? 1 : 0));
+    UNIT_TEST_ASSERT(decompress());
+  }
+
+  /* A context that is not used for compression still decompresses */
+  UNIT_TEST_ASSERT(set_context(7, 0xfd01, 0, 0));
+  UNIT_TEST_ASSERT(compress(0xfd01, 0xfd00) == base + 16);
+  UNIT_TEST_ASSERT(compress(0xfd02, 0xfd00) == base + 1);
+  UNIT_TEST_ASSERT(frame.data[2] == 0x90);
+  frame.data[2] = 0x70;
+  packet[9] = 0x01;
+  UNIT_TEST_ASSERT(decompress());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static int base;
+  static bool lifetime_ok;
+
+  PROCESS_BEGIN();
+
+  netstack_sniffer_add(&sniffer);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(ctx_compress);
+  UNIT_TEST_RUN(ctx_update);
+
+  /* A context expires at the end of its lifetime */
+  base = compress(0xfd00, 0xfd00);
+  lifetime_ok = set_context(9, 0xfd05, 1, 1) &&
+    compress(0xfd05, 0xfd00) == base + 1;
+  etimer_set(&et, 2 * CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  lifetime_ok = lifetime_ok && compress(0xfd05, 0xfd00) == base + 16 &&
+    sicslowpan_addr_context_get(9) == NULL;
+  printf("TEST: lifetime --- %s\n", lifetime_ok ? "OK" : "FAIL");
+  if(!lifetime_ok ||
+     UNIT_TEST_RESULT(ctx_compress) != unit_test_success ||
+     UNIT_TEST_RESULT(ctx_update) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
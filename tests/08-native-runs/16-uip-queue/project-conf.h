@@ -0,0 +1,15 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define NETSTACK_CONF_NETWORK sicslowpan_driver
+#define NETSTACK_CONF_MAC     test_mac_driver
+
+#define UIP_CONF_IPV6_QUEUE_PKT         1
+#define UIP_CONF_IPV6_QUEUE_PKT_PER_NBR 3
+#define UIP_CONF_IPV6_INPUT_QUEUE_LEN   4
+
+#define LOG_CONF_LEVEL_6LOWPAN LOG_LEVEL_NONE
+#define LOG_CONF_LEVEL_IPV6    LOG_LEVEL_NONE
+#define LOG_CONF_LEVEL_TCPIP   LOG_LEVEL_NONE
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/mac/mac.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-nd6.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-packetqueue.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define PACKET_LEN 60
+#define FRAME_SIZE 127
+#define MAX_SENT 16
+#define NUM_INPUT 6
+
+struct frame {
+  uint8_t data[FRAME_SIZE];
+  uint16_t len;
+  linkaddr_t receiver;
+};
+
+static struct frame sent[MAX_SENT];
+static int num_sent;
+static uint8_t received[NUM_INPUT];
+static int num_received;
+static int record_input;
+
+static linkaddr_t next_hop_ll = { { 0x02, 0x12, 0x74, 0x02, 0x00, 0x02, 0x02, 0x02 } };
+static uip_ipaddr_t next_hop_ip;
+/*---------------------------------------------------------------------------*/
+/* A MAC driver that records the frames sent by 6LoWPAN */
+static void
+mac_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_send(mac_callback_t sent_callback, void *ptr)
+{
+  if(num_sent < MAX_SENT && packetbuf_datalen() <= FRAME_SIZE) {
+    memcpy(sent[num_sent].data, packetbuf_dataptr(), packetbuf_datalen());
+    sent[num_sent].len = packetbuf_datalen();
+    linkaddr_copy(&sent[num_sent].receiver,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    num_sent++;
+  }
+  mac_call_sent_callback(sent_callback, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_max_payload(void)
+{
+  return FRAME_SIZE - 17;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver test_mac_driver = {
+  "test-mac",
+  mac_init,
+  mac_send,
+  mac_input,
+  mac_on,
+  mac_off,
+  mac_max_payload,
+};
+/*---------------------------------------------------------------------------*/
+/* Records the last byte of the packets the IP stack gets to */
+static enum netstack_ip_action
+ip_input(void)
+{
+  if(!record_input) {
+    return NETSTACK_IP_PROCESS;
+  }
+  if(num_received < NUM_INPUT) {
+    received[num_received++] = uip_buf[uip_len - 1];
+  }
+  return NETSTACK_IP_DROP;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor ip_processor = {
+  .process_input = ip_input,
+};
+/*---------------------------------------------------------------------------*/
+/* Puts a UDP packet to fd00::99 in uip_buf, ending with mark */
+static void
+make_packet(uint8_t mark)
+{
+  uipbuf_clear();
+  memset(uip_buf, 0, PACKET_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  uipbuf_set_len_field(UIP_IP_BUF, PACKET_LEN - UIP_IPH_LEN);
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &uip_ds6_get_link_local(-1)->ipaddr);
+  uip_ip6addr(&UIP_IP_BUF->destipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0x99);
+  uip_buf[UIP_IPH_LEN + 5] = PACKET_LEN - UIP_IPH_LEN;
+  uip_buf[PACKET_LEN - 1] = mark;
+  uip_len = PACKET_LEN;
+}
+/*---------------------------------------------------------------------------*/
+/* Puts a solicited Neighbor Advertisement from the next hop in uip_buf */
+static void
+make_na(void)
+{
+  uint8_t *na;
+
+  uipbuf_clear();
+  memset(uip_buf, 0, UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN + 16);
+  UIP_IP_BUF->vtc = 0x60;
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_ICMPH_LEN + UIP_ND6_NA_LEN + 16);
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = UIP_ND6_HOP_LIMIT;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &next_hop_ip);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &uip_ds6_get_link_local(-1)->ipaddr);
+  UIP_ICMP_BUF->type = ICMP6_NA;
+  na = &uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN];
+  na[0] = UIP_ND6_NA_FLAG_SOLICITED | UIP_ND6_NA_FLAG_OVERRIDE;
+  memcpy(&na[4], &next_hop_ip, sizeof(next_hop_ip));
+  na[UIP_ND6_NA_LEN] = UIP_ND6_OPT_TLLAO;
+  na[UIP_ND6_NA_LEN + 1] = 2;
+  memcpy(&na[UIP_ND6_NA_LEN + 2], &next_hop_ll, LINKADDR_SIZE);
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN + 16;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(packetqueue, "Packet queues");
+UNIT_TEST(packetqueue)
+{
+  static struct uip_packetqueue_handle a, b;
+  struct uip_packetqueue_packet *p;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  uip_packetqueue_new(&a);
+  uip_packetqueue_new(&b);
+  UNIT_TEST_ASSERT(uip_packetqueue_buflen(&a) == 0);
+
+  /* Both queues share the pool */
+  for(i = 0; i < UIP_CONF_PACKETQUEUE_NUM_PACKETS; i++) {
+    p = uip_packetqueue_alloc(i % 2 ? &b : &a, 0);
+    UNIT_TEST_ASSERT(p != NULL);
+    p->queue_buf[0] = i;
+    p->queue_buf_len = 1;
+  }
+  UNIT_TEST_ASSERT(uip_packetqueue_alloc(&a, 0) == NULL);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&a) == (UIP_CONF_PACKETQUEUE_NUM_PACKETS + 1) / 2);
+
+  /* First in, first out */
+  for(i = 0; i < UIP_CONF_PACKETQUEUE_NUM_PACKETS; i += 2) {
+    UNIT_TEST_ASSERT(uip_packetqueue_buflen(&a) == 1);
+    UNIT_TEST_ASSERT(uip_packetqueue_buf(&a)[0] == i);
+    uip_packetqueue_pop(&a);
+  }
+  UNIT_TEST_ASSERT(uip_packetqueue_buf(&a) == NULL);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&b) == UIP_CONF_PACKETQUEUE_NUM_PACKETS / 2);
+  uip_packetqueue_free(&b);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&b) == 0);
+  for(i = 0; i < UIP_CONF_PACKETQUEUE_NUM_PACKETS; i++) {
+    UNIT_TEST_ASSERT(uip_packetqueue_alloc(&a, 0) != NULL);
+  }
+  uip_packetqueue_free(&a);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(nd_queue, "Queue packets during address resolution");
+UNIT_TEST(nd_queue)
+{
+  uip_ds6_nbr_t *nbr;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* The first packet triggers a Neighbor Solicitation */
+  num_sent = 0;
+  for(i = 1; i <= UIP_CONF_IPV6_QUEUE_PKT_PER_NBR + 1; i++) {
+    make_packet(i);
+    tcpip_ipv6_output();
+  }
+  UNIT_TEST_ASSERT(num_sent == 1);
+  UNIT_TEST_ASSERT(!linkaddr_cmp(&sent[0].receiver, &next_hop_ll));
+  nbr = uip_ds6_nbr_lookup(&next_hop_ip);
+  UNIT_TEST_ASSERT(nbr != NULL && nbr->state == NBR_INCOMPLETE);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&nbr->packethandle) == UIP_CONF_IPV6_QUEUE_PKT_PER_NBR);
+
+  /* The answer releases the queued packets, in order */
+  num_sent = 0;
+  make_na();
+  tcpip_input();
+  printf("TEST: sent %d queued packets\n", num_sent);
+  UNIT_TEST_ASSERT(num_sent == UIP_CONF_IPV6_QUEUE_PKT_PER_NBR);
+  for(i = 0; i < num_sent; i++) {
+    UNIT_TEST_ASSERT(linkaddr_cmp(&sent[i].receiver, &next_hop_ll));
+    UNIT_TEST_ASSERT(sent[i].data[sent[i].len - 1] == i + 1);
+  }
+  UNIT_TEST_ASSERT(nbr->state == NBR_REACHABLE);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&nbr->packethandle) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static bool input_ok;
+  static int i;
+
+  PROCESS_BEGIN();
+
+  netstack_ip_packet_processor_add(&ip_processor);
+  /* The native platform's default router */
+  uip_ip6addr(&next_hop_ip, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(packetqueue);
+  UNIT_TEST_RUN(nd_queue);
+
+  /* A burst of incoming packets: those that fit in the queue are
+     processed in order when the stack gets to them, the others are
+     dropped */
+  record_input = 1;
+  input_ok = tcpip_input_queue_space() == UIP_CONF_IPV6_INPUT_QUEUE_LEN;
+  for(i = 0; i < NUM_INPUT; i++) {
+    make_packet(i);
+    tcpip_input_enqueue();
+  }
+  input_ok = input_ok && num_received == 0 &&
+    tcpip_input_queue_space() == 0 &&
+    tcpip_input_queue_drops() == NUM_INPUT - UIP_CONF_IPV6_INPUT_QUEUE_LEN;
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  input_ok = input_ok && num_received == UIP_CONF_IPV6_INPUT_QUEUE_LEN &&
+    tcpip_input_queue_space() == UIP_CONF_IPV6_INPUT_QUEUE_LEN;
+  for(i = 0; input_ok && i < num_received; i++) {
+    input_ok = received[i] == i;
+  }
+  record_input = 0;
+  printf("TEST: input queue --- %s\n", input_ok ? "OK" : "FAIL");
+
+  if(!input_ok ||
+     UNIT_TEST_RESULT(packetqueue) != unit_test_success ||
+     UNIT_TEST_RESULT(nd_queue) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,18 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define NETSTACK_CONF_RADIO   test_radio_driver
+
+#define QUEUEBUF_CONF_NUM                 8
+#define CSMA_CONF_MAX_NEIGHBOR_QUEUES     6
+#define CSMA_CONF_MAX_PACKET_PER_NEIGHBOR 8
+#define CSMA_CONF_QUEUE_INDEX             1
+#define CSMA_CONF_QUEUE_STATS             1
+#define CSMA_CONF_AQM                     1
+#define CSMA_CONF_AQM_TARGET              (CLOCK_SECOND / 20)
+#define CSMA_CONF_AQM_INTERVAL            (CLOCK_SECOND / 10)
+#define CSMA_CONF_BURST_MAX_FRAMES        4
+
+#define LOG_CONF_LEVEL_MAC    LOG_LEVEL_NONE
+
+#endif /* PROJECT_CONF_H_ */
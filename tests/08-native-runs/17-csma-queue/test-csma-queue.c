@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/mac/mac.h"
+#include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
+#include "net/mac/framer/frame802154.h"
+#include "dev/radio.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define NUM_NEIGHBORS (CSMA_CONF_MAX_NEIGHBOR_QUEUES + 1)
+#define NUM_H_PACKETS 8
+#define NUM_BURST_PACKETS 6
+
+/* Outcome of the packets, per neighbor and MAC status */
+static int results[NUM_NEIGHBORS][MAC_TX_ERR_FATAL + 1];
+
+static linkaddr_t neighbors[NUM_NEIGHBORS];
+/* The neighbor that never acknowledges */
+static const linkaddr_t *dead;
+static uint8_t last_dsn;
+static int ack_pending;
+/* The frame pending bits of the frames sent, when recording */
+static uint8_t pending_bits[NUM_BURST_PACKETS];
+static int num_frames;
+static int record_frames;
+/*---------------------------------------------------------------------------*/
+/* A radio that acknowledges every unicast frame, except to the dead
+   neighbor */
+static int
+radio_init(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  last_dsn = ((const uint8_t *)payload)[2];
+  if(record_frames && num_frames < NUM_BURST_PACKETS) {
+    pending_bits[num_frames++] = (((const uint8_t *)payload)[0] >> 4) & 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit(unsigned short transmit_len)
+{
+  ack_pending = !packetbuf_holds_broadcast() &&
+    (dead == NULL || !linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
+                                   dead));
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  prepare(payload, payload_len);
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  uint8_t ack[CSMA_ACK_LEN] = { FRAME802154_ACKFRAME, 0, 0 };
+
+  if(!ack_pending || buf_len < CSMA_ACK_LEN) {
+    return 0;
+  }
+  ack_pending = 0;
+  ack[2] = last_dsn;
+  memcpy(buf, ack, CSMA_ACK_LEN);
+  return CSMA_ACK_LEN;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return ack_pending;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  if(param == RADIO_CONST_MAX_PAYLOAD_LEN) {
+    *value = 127;
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver test_radio_driver = {
+  radio_init,
+  prepare,
+  transmit,
+  send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  on,
+  off,
+  get_value,
+  set_value,
+  get_object,
+  set_object
+};
+/*---------------------------------------------------------------------------*/
+static void
+packet_sent(void *ptr, int status, int transmissions)
+{
+  results[(uintptr_t)ptr][status]++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_to(int i)
+{
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), i, 20);
+  packetbuf_set_datalen(20);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &neighbors[i]);
+  NETSTACK_MAC.send(packet_sent, (void *)(uintptr_t)i);
+}
+/*---------------------------------------------------------------------------*/
+static int
+num_queues(void)
+{
+  struct csma_neighbor_queue_info info;
+  int i;
+
+  for(i = 0; csma_queue_get_neighbor_info(i, &info); i++);
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(enqueue, "Neighbor queues and their statistics");
+UNIT_TEST(enqueue)
+{
+  struct csma_neighbor_queue_info info;
+  const struct csma_queue_stats *stats = csma_queue_get_stats();
+  int i;
+  int found;
+
+  UNIT_TEST_BEGIN();
+
+  /* Nothing is sent before the process yields. With four queues, each
+     neighbor may hold two packets of the pool. */
+  for(i = 0; i < 4; i++) {
+    send_to(i);
+  }
+  send_to(2);
+  UNIT_TEST_ASSERT(stats->enqueued == 5);
+  UNIT_TEST_ASSERT(stats->depth_max == 2);
+  send_to(2);
+  UNIT_TEST_ASSERT(stats->drop_full == 1);
+  UNIT_TEST_ASSERT(results[2][MAC_TX_ERR] == 1);
+
+  /* Up to the maximum number of queues */
+  for(i = 4; i < NUM_NEIGHBORS; i++) {
+    send_to(i);
+  }
+  UNIT_TEST_ASSERT(stats->enqueued == CSMA_CONF_MAX_NEIGHBOR_QUEUES + 1);
+  UNIT_TEST_ASSERT(stats->drop_nomem == 1);
+  UNIT_TEST_ASSERT(results[NUM_NEIGHBORS - 1][MAC_TX_ERR] == 1);
+  UNIT_TEST_ASSERT(num_queues() == CSMA_CONF_MAX_NEIGHBOR_QUEUES);
+
+  /* Every neighbor with a queue is found again */
+  found = 0;
+  for(i = 0; csma_queue_get_neighbor_info(i, &info); i++) {
+    UNIT_TEST_ASSERT(info.depth == (linkaddr_cmp(&info.addr, &neighbors[2]) ? 2 : 1));
+    found++;
+  }
+  UNIT_TEST_ASSERT(found == CSMA_CONF_MAX_NEIGHBOR_QUEUES);
+  send_to(0);
+  UNIT_TEST_ASSERT(stats->drop_full == 2);
+  UNIT_TEST_ASSERT(num_queues() == CSMA_CONF_MAX_NEIGHBOR_QUEUES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static const struct csma_queue_stats *stats;
+  static bool sent_ok;
+  static bool burst_ok;
+  static bool aqm_ok;
+  static uint32_t burst_frames;
+  static int i;
+
+  PROCESS_BEGIN();
+
+  stats = csma_queue_get_stats();
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    neighbors[i].u8[0] = 0x02;
+    neighbors[i].u8[LINKADDR_SIZE - 1] = i + 1;
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(enqueue);
+
+  /* The queued packets are all sent and the queues freed */
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  sent_ok = num_queues() == 0 && stats->dequeued == stats->enqueued;
+  for(i = 0; i < CSMA_CONF_MAX_NEIGHBOR_QUEUES; i++) {
+    sent_ok = sent_ok && results[i][MAC_TX_OK] == (i == 2 ? 2 : 1);
+  }
+  printf("TEST: send queued packets --- %s\n", sent_ok ? "OK" : "FAIL");
+
+  /* Bursts of up to CSMA_CONF_BURST_MAX_FRAMES frames, all but the last
+     with the frame pending bit set */
+  memset(results, 0, sizeof(results));
+  burst_frames = stats->burst_frames;
+  record_frames = 1;
+  for(i = 0; i < NUM_BURST_PACKETS; i++) {
+    send_to(3);
+  }
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  record_frames = 0;
+  burst_ok = results[3][MAC_TX_OK] == NUM_BURST_PACKETS &&
+    num_frames == NUM_BURST_PACKETS &&
+    stats->burst_frames - burst_frames ==
+    NUM_BURST_PACKETS - (NUM_BURST_PACKETS + CSMA_CONF_BURST_MAX_FRAMES - 1) /
+    CSMA_CONF_BURST_MAX_FRAMES;
+  for(i = 0; burst_ok && i < NUM_BURST_PACKETS; i++) {
+    burst_ok = pending_bits[i] ==
+      ((i + 1) % CSMA_CONF_BURST_MAX_FRAMES != 0 && i + 1 < NUM_BURST_PACKETS);
+  }
+  printf("TEST: bursts --- %s\n", burst_ok ? "OK" : "FAIL");
+
+  /* Neighbor 0 is dead and flooded. Neighbor 1 still gets its packets
+     through, and the dead neighbor's queue is kept short by head drops. */
+  memset(results, 0, sizeof(results));
+  dead = &neighbors[0];
+  for(i = 0; i < QUEUEBUF_CONF_NUM; i++) {
+    send_to(0);
+  }
+  for(i = 0; i < 10 * NUM_H_PACKETS; i++) {
+    etimer_set(&et, CLOCK_SECOND / 100);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    send_to(0);
+    if(i % 10 == 0) {
+      send_to(1);
+    }
+  }
+  etimer_set(&et, 2 * CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  aqm_ok = results[1][MAC_TX_OK] == NUM_H_PACKETS &&
+    results[0][MAC_TX_OK] == 0 && stats->drop_aqm > 0 &&
+    num_queues() == 0;
+  printf("TEST: dead neighbor, %d no-ack, %d refused, %lu AQM drops --- %s\n",
+         results[0][MAC_TX_NOACK], results[0][MAC_TX_ERR] - (int)stats->drop_aqm,
+         (unsigned long)stats->drop_aqm, aqm_ok ? "OK" : "FAIL");
+
+  if(!sent_ok || !burst_ok || !aqm_ok ||
+     UNIT_TEST_RESULT(enqueue) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,10 @@
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/* 2.4 GHz O-QPSK, as assumed by the timeslot templates */
+#define RADIO_PHY_OVERHEAD  3
+#define RADIO_BYTE_AIR_TIME 32
+
+#define LOG_CONF_LEVEL_FRAMER LOG_LEVEL_NONE
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "cc2420-tsch-15ms.h"
+#include "cc13xx-50kbps-tsch.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Every timeslot timing in the tree that can be linked on its own. The
+   cc1200 timings are private to their radio driver. */
+static const struct {
+  const char *name;
+  const uint16_t *timing_us;
+} platform_timings[] = {
+  { "cc2420 15 ms", tsch_timeslot_timing_us_15000 },
+  { "cc13xx 50 kbps", tsch_timing_cc13xx_50kbps },
+};
+
+#define NUM_PLATFORM_TIMINGS \
+  (sizeof(platform_timings) / sizeof(platform_timings[0]))
+/*---------------------------------------------------------------------------*/
+static int
+num_templates(void)
+{
+  int n = 0;
+  while(tsch_timeslot_timing_get_template(n + 1) != NULL) {
+    n++;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Write the IEs of an EB that only carries a timeslot IE, as the EB
+   creation does, and parse them back */
+static int
+eb_ies_round_trip(const struct ieee802154_ies *out, struct ieee802154_ies *in)
+{
+  uint8_t buf[64];
+  struct ieee802154_ies ies = *out;
+  int hdr_len;
+  int sub_len;
+  int len;
+
+  hdr_len = frame80215e_create_ie_header_list_termination_1(buf, sizeof(buf),
+                                                            &ies);
+  if(hdr_len < 0) {
+    return -1;
+  }
+  /* The MLME IE descriptor goes before the sub-IEs, once their length is
+     known */
+  sub_len = frame80215e_create_ie_tsch_timeslot(buf + hdr_len + 2,
+                                                sizeof(buf) - hdr_len - 2,
+                                                &ies);
+  if(sub_len < 0) {
+    return -1;
+  }
+  ies.ie_mlme_len = sub_len;
+  if(frame80215e_create_ie_mlme(buf + hdr_len, 2, &ies) < 0) {
+    return -1;
+  }
+  len = hdr_len + 2 + sub_len;
+  len += frame80215e_create_ie_payload_list_termination(buf + len,
+                                                        sizeof(buf) - len,
+                                                        &ies);
+
+  memset(in, 0, sizeof(*in));
+  if(frame802154e_parse_information_elements(buf, len, in) < 0) {
+    return -1;
+  }
+  return sub_len;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeslot_templates, "Timeslot templates are valid");
+UNIT_TEST(timeslot_templates)
+{
+  const uint16_t *timing_us;
+  int i;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  n = num_templates();
+  UNIT_TEST_ASSERT(n >= TSCH_TIMESLOT_TEMPLATE_ID_5000);
+  for(i = 1; i <= n; i++) {
+    timing_us = tsch_timeslot_timing_get_template(i);
+    printf("TEST: template %d: %u us, max frame %d --- %s\n", i,
+           timing_us[tsch_ts_timeslot_length],
+           tsch_timeslot_timing_max_frame_len(timing_us),
+           tsch_timeslot_timing_is_valid(timing_us) ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(tsch_timeslot_timing_is_valid(timing_us));
+    UNIT_TEST_ASSERT(tsch_timeslot_timing_get_template_id(timing_us) == i);
+  }
+
+  for(i = 0; i < NUM_PLATFORM_TIMINGS; i++) {
+    timing_us = platform_timings[i].timing_us;
+    printf("TEST: %s: %u us --- %s\n", platform_timings[i].name,
+           timing_us[tsch_ts_timeslot_length],
+           tsch_timeslot_timing_is_valid(timing_us) ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(tsch_timeslot_timing_is_valid(timing_us));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeslot_ie_id_only, "ID-only timeslot IE round trip");
+UNIT_TEST(timeslot_ie_id_only)
+{
+  struct ieee802154_ies out;
+  struct ieee802154_ies in;
+  const uint16_t *timing_us;
+  int i;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  n = num_templates();
+  for(i = 1; i <= n; i++) {
+    memset(&out, 0, sizeof(out));
+    out.ie_tsch_timeslot_id = i;
+    out.ie_tsch_timeslot_id_only = 1;
+    /* One byte of sub-IE content, the ID */
+    UNIT_TEST_ASSERT(eb_ies_round_trip(&out, &in) == 2 + 1);
+    UNIT_TEST_ASSERT(in.ie_tsch_timeslot_id == i);
+    UNIT_TEST_ASSERT(in.ie_tsch_timeslot_id_only);
+
+    timing_us = tsch_timeslot_timing_from_ies(&in, NULL);
+    printf("TEST: ID-only IE, template %d --- %s\n", i,
+           timing_us == tsch_timeslot_timing_get_template(i) ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(timing_us == tsch_timeslot_timing_get_template(i));
+  }
+
+  /* ID 0 stands for the platform default timing */
+  memset(&out, 0, sizeof(out));
+  UNIT_TEST_ASSERT(eb_ies_round_trip(&out, &in) == 2 + 1);
+  UNIT_TEST_ASSERT(in.ie_tsch_timeslot_id == 0);
+  UNIT_TEST_ASSERT(tsch_timeslot_timing_from_ies(&in,
+                   tsch_timeslot_timing_us_15000)
+                   == tsch_timeslot_timing_us_15000);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeslot_ie_unknown, "Unknown timeslot template rejected");
+UNIT_TEST(timeslot_ie_unknown)
+{
+  struct ieee802154_ies out;
+  struct ieee802154_ies in;
+  const uint8_t unknown[] = { num_templates() + 1, 0xff };
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(tsch_timeslot_timing_get_template(0) == NULL);
+  for(i = 0; i < sizeof(unknown); i++) {
+    UNIT_TEST_ASSERT(tsch_timeslot_timing_get_template(unknown[i]) == NULL);
+
+    memset(&out, 0, sizeof(out));
+    out.ie_tsch_timeslot_id = unknown[i];
+    out.ie_tsch_timeslot_id_only = 1;
+    UNIT_TEST_ASSERT(eb_ies_round_trip(&out, &in) == 2 + 1);
+    UNIT_TEST_ASSERT(in.ie_tsch_timeslot_id == unknown[i]);
+    printf("TEST: ID-only IE, unknown template %u --- %s\n", unknown[i],
+           tsch_timeslot_timing_from_ies(&in, NULL) == NULL ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(tsch_timeslot_timing_from_ies(&in, NULL) == NULL);
+  }
+
+  /* A timing that matches no template has no ID */
+  UNIT_TEST_ASSERT(tsch_timeslot_timing_get_template_id(
+                   tsch_timeslot_timing_us_15000) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeslot_ie_full, "Full timeslot IE round trip");
+UNIT_TEST(timeslot_ie_full)
+{
+  struct ieee802154_ies out;
+  struct ieee802154_ies in;
+  const uint16_t *timing_us;
+
+  UNIT_TEST_BEGIN();
+
+  memset(&out, 0, sizeof(out));
+  out.ie_tsch_timeslot_id = 1;
+  memcpy(out.ie_tsch_timeslot, tsch_timeslot_timing_us_15000,
+         sizeof(out.ie_tsch_timeslot));
+  UNIT_TEST_ASSERT(eb_ies_round_trip(&out, &in) == 2 + 25);
+  UNIT_TEST_ASSERT(!in.ie_tsch_timeslot_id_only);
+
+  timing_us = tsch_timeslot_timing_from_ies(&in, NULL);
+  printf("TEST: full IE --- %s\n", timing_us != NULL
+         && memcmp(timing_us, tsch_timeslot_timing_us_15000,
+                   sizeof(tsch_timeslot_timing_usec)) == 0 ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(timing_us != NULL);
+  UNIT_TEST_ASSERT(memcmp(timing_us, tsch_timeslot_timing_us_15000,
+                          sizeof(tsch_timeslot_timing_usec)) == 0);
+
+  /* An all-zero timing, as read from an ID-only IE by nodes that do not
+     know template IDs, is inconsistent */
+  memset(in.ie_tsch_timeslot, 0, sizeof(in.ie_tsch_timeslot));
+  UNIT_TEST_ASSERT(tsch_timeslot_timing_from_ies(&in, NULL) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(timeslot_templates);
+  UNIT_TEST_RUN(timeslot_ie_id_only);
+  UNIT_TEST_RUN(timeslot_ie_unknown);
+  UNIT_TEST_RUN(timeslot_ie_full);
+
+  if(UNIT_TEST_RESULT(timeslot_templates) != unit_test_success ||
+     UNIT_TEST_RESULT(timeslot_ie_id_only) != unit_test_success ||
+     UNIT_TEST_RESULT(timeslot_ie_unknown) != unit_test_success ||
+     UNIT_TEST_RESULT(timeslot_ie_full) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
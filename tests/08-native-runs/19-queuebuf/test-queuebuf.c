@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define LEN 100
+#define HDR_REDUCE 7
+
+static uint8_t payload[LEN];
+/*---------------------------------------------------------------------------*/
+/* Queue a packet and load it back into the packetbuf, which then refers
+   to the queuebuf data */
+static struct queuebuf *
+queue_and_attach(void)
+{
+  struct queuebuf *q;
+
+  packetbuf_copyfrom(payload, LEN);
+  q = queuebuf_new_from_packetbuf();
+  if(q != NULL) {
+    packetbuf_clear();
+    queuebuf_to_packetbuf(q);
+  }
+  return q;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(update_attached, "Update a queuebuf from its own data");
+UNIT_TEST(update_attached)
+{
+  struct queuebuf *q;
+  int ok;
+
+  UNIT_TEST_BEGIN();
+
+  /* Unchanged packet */
+  q = queue_and_attach();
+  UNIT_TEST_ASSERT(q != NULL);
+  queuebuf_update_from_packetbuf(q);
+  ok = queuebuf_datalen(q) == LEN
+    && memcmp(queuebuf_dataptr(q), payload, LEN) == 0;
+  printf("TEST: update unchanged --- %s\n", ok ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(ok);
+  queuebuf_free(q);
+
+  /* Packet with a header reduced, as done by a MAC on input */
+  q = queue_and_attach();
+  UNIT_TEST_ASSERT(q != NULL);
+  UNIT_TEST_ASSERT(packetbuf_hdrreduce(HDR_REDUCE));
+  queuebuf_update_from_packetbuf(q);
+  ok = queuebuf_datalen(q) == LEN - HDR_REDUCE
+    && memcmp(queuebuf_dataptr(q), payload + HDR_REDUCE, LEN - HDR_REDUCE) == 0;
+  printf("TEST: update after header reduction --- %s\n", ok ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(ok);
+  /* The packetbuf still shows the same data */
+  UNIT_TEST_ASSERT(packetbuf_datalen() == LEN - HDR_REDUCE);
+  UNIT_TEST_ASSERT(memcmp(packetbuf_dataptr(), payload + HDR_REDUCE,
+                          LEN - HDR_REDUCE) == 0);
+  packetbuf_clear();
+  queuebuf_free(q);
+
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < LEN; i++) {
+    payload[i] = i;
+  }
+
+  UNIT_TEST_RUN(update_attached);
+
+  if(UNIT_TEST_RESULT(update_attached) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+./run-one.sh 20-ip64-chksum
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "ip64/ip64.h"
+#include "ip64/ip64-addrmap.h"
+#include "ipv6/ip64-addr.h"
+#include "lib/ip-chksum.h"
+#include "unit-test.h"
+#include <string.h>
+#include <stdio.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define IPV6_HDRLEN 40
+#define IPV4_HDRLEN 20
+
+#define PROTO_ICMPV4 1
+#define PROTO_TCP    6
+#define PROTO_UDP    17
+#define PROTO_ICMPV6 58
+
+#define TCP_HDRLEN   20
+#define UDP_HDRLEN   8
+#define ICMP_HDRLEN  8
+
+/* Ports below 1024 go to the local host, others through the address
+   map */
+#define LOCAL_PORT  80
+#define V6_PORT     5000
+#define REMOTE_PORT 7000
+
+static const uint16_t payload_lens[] = { 0, 1, 2, 17, 64, 333, 1000 };
+#define NUM_LENS (sizeof(payload_lens) / sizeof(payload_lens[0]))
+
+static uip_ip4addr_t hostaddr;
+static uip_ip4addr_t remote_v4;
+static uip_ip6addr_t node_v6;
+
+static uint8_t in[UIP_BUFSIZE];
+static uint8_t out[UIP_BUFSIZE];
+/*---------------------------------------------------------------------------*/
+static uint16_t
+chksum_offset(uint8_t proto)
+{
+  switch(proto) {
+  case PROTO_TCP:
+    return 16;
+  case PROTO_UDP:
+    return 6;
+  default:
+    return 2;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The transport checksum of a packet recomputed over its whole payload,
+   in network byte order */
+static uint16_t
+full_chksum(const uint8_t *packet, int ipv6)
+{
+  static uint8_t transport[UIP_BUFSIZE];
+  uint16_t hdrlen = ipv6 ? IPV6_HDRLEN : IPV4_HDRLEN;
+  uint16_t len = ipv6 ? (packet[4] << 8) + packet[5]
+                      : (packet[2] << 8) + packet[3] - IPV4_HDRLEN;
+  uint8_t proto = ipv6 ? packet[6] : packet[9];
+  uint16_t offset = chksum_offset(proto);
+  uint16_t sum = 0;
+
+  memcpy(transport, packet + hdrlen, len);
+  transport[offset] = transport[offset + 1] = 0;
+  if(proto != PROTO_ICMPV4) {
+    sum = ip_chksum_reference(len + proto, packet + (ipv6 ? 8 : 12),
+                              ipv6 ? 32 : 8);
+  }
+  sum = ~ip_chksum_reference(sum, transport, len);
+  if(proto == PROTO_UDP && sum == 0) {
+    sum = 0xffff;
+  }
+  return uip_htons(sum);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+packet_chksum(const uint8_t *packet, int ipv6)
+{
+  uint16_t hdrlen = ipv6 ? IPV6_HDRLEN : IPV4_HDRLEN;
+  uint8_t proto = ipv6 ? packet[6] : packet[9];
+  uint16_t chksum;
+
+  memcpy(&chksum, packet + hdrlen + chksum_offset(proto), sizeof(chksum));
+  return chksum;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_chksum(uint8_t *packet, int ipv6, uint16_t chksum)
+{
+  uint16_t hdrlen = ipv6 ? IPV6_HDRLEN : IPV4_HDRLEN;
+  uint8_t proto = ipv6 ? packet[6] : packet[9];
+
+  memcpy(packet + hdrlen + chksum_offset(proto), &chksum, sizeof(chksum));
+}
+/*---------------------------------------------------------------------------*/
+/* Writes the transport header and payload of a test packet, returns
+   its length */
+static uint16_t
+make_transport(uint8_t *t, uint8_t proto, uint16_t srcport,
+               uint16_t destport, uint16_t payload_len)
+{
+  uint16_t hdrlen;
+  uint16_t i;
+
+  switch(proto) {
+  case PROTO_TCP:
+    hdrlen = TCP_HDRLEN;
+    memset(t, 0, hdrlen);
+    t[4] = 0x12; t[5] = 0x34; t[6] = 0x56; t[7] = 0x78; /* seqno */
+    t[12] = (TCP_HDRLEN / 4) << 4;
+    t[13] = 0x18; /* PSH, ACK */
+    t[14] = 0x10; /* wnd */
+    break;
+  case PROTO_UDP:
+    hdrlen = UDP_HDRLEN;
+    t[4] = (hdrlen + payload_len) >> 8;
+    t[5] = (hdrlen + payload_len) & 0xff;
+    break;
+  default:
+    hdrlen = ICMP_HDRLEN;
+    t[1] = 0; /* code */
+    t[4] = 0xbe; t[5] = 0xef; /* id */
+    t[6] = 0; t[7] = 1; /* seqno */
+    break;
+  }
+  if(proto == PROTO_TCP || proto == PROTO_UDP) {
+    t[0] = srcport >> 8;
+    t[1] = srcport & 0xff;
+    t[2] = destport >> 8;
+    t[3] = destport & 0xff;
+  }
+  for(i = 0; i < payload_len; i++) {
+    t[hdrlen + i] = i * 7 + payload_len;
+  }
+  return hdrlen + payload_len;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+make_ipv6(uint8_t proto, uint16_t payload_len)
+{
+  uip_ip6addr_t dest;
+  uint16_t len;
+
+  memset(in, 0, IPV6_HDRLEN);
+  len = make_transport(in + IPV6_HDRLEN, proto, V6_PORT, REMOTE_PORT,
+                       payload_len);
+  if(proto == PROTO_ICMPV6) {
+    in[IPV6_HDRLEN] = 129; /* Echo reply */
+  }
+  in[0] = 0x60;
+  in[4] = len >> 8;
+  in[5] = len & 0xff;
+  in[6] = proto;
+  in[7] = 64;
+  ip64_addr_4to6(&remote_v4, &dest);
+  memcpy(in + 8, &node_v6, sizeof(node_v6));
+  memcpy(in + 24, &dest, sizeof(dest));
+  set_chksum(in, 1, full_chksum(in, 1));
+  return IPV6_HDRLEN + len;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+make_ipv4(uint8_t proto, uint16_t destport, uint16_t payload_len)
+{
+  uint16_t len;
+
+  memset(in, 0, IPV4_HDRLEN);
+  len = IPV4_HDRLEN + make_transport(in + IPV4_HDRLEN, proto, REMOTE_PORT,
+                                     destport, payload_len);
+  if(proto == PROTO_ICMPV4) {
+    in[IPV4_HDRLEN] = 8; /* Echo */
+  }
+  in[0] = 0x45;
+  in[2] = len >> 8;
+  in[3] = len & 0xff;
+  in[8] = 64;
+  in[9] = proto;
+  memcpy(in + 12, &remote_v4, sizeof(remote_v4));
+  memcpy(in + 16, &hostaddr, sizeof(hostaddr));
+  set_chksum(in, 0, full_chksum(in, 0));
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ip64_6to4_chksum, "6to4 transport checksums");
+UNIT_TEST(ip64_6to4_chksum)
+{
+  static const uint8_t protos[] = { PROTO_TCP, PROTO_UDP, PROTO_ICMPV6 };
+  int p, i;
+  int len;
+  unsigned errors;
+
+  UNIT_TEST_BEGIN();
+
+  for(p = 0; p < sizeof(protos); p++) {
+    errors = 0;
+    for(i = 0; i < NUM_LENS; i++) {
+      len = ip64_6to4(in, make_ipv6(protos[p], payload_lens[i]), out);
+      UNIT_TEST_ASSERT(len == IPV4_HDRLEN + (in[4] << 8) + in[5]);
+      if(packet_chksum(out, 0) != full_chksum(out, 0)) {
+        errors++;
+      }
+    }
+    printf("TEST: 6to4 protocol %u, %u errors --- %s\n", protos[p], errors,
+           errors == 0 ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(errors == 0);
+  }
+
+  /* A corrupted packet is not verified, but its translated checksum
+     stays invalid */
+  errors = 0;
+  for(p = 0; p < sizeof(protos); p++) {
+    len = make_ipv6(protos[p], 64);
+    in[len - 1] ^= 0x5a;
+    ip64_6to4(in, len, out);
+    if(packet_chksum(out, 0) == full_chksum(out, 0)) {
+      errors++;
+    }
+  }
+  printf("TEST: 6to4 corrupted packets, %u errors --- %s\n", errors,
+         errors == 0 ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ip64_4to6_chksum, "4to6 transport checksums");
+UNIT_TEST(ip64_4to6_chksum)
+{
+  static const uint8_t protos[] = { PROTO_TCP, PROTO_UDP, PROTO_ICMPV4 };
+  uint16_t mapped_port[2];
+  int p, i, m;
+  int len;
+  unsigned errors;
+
+  UNIT_TEST_BEGIN();
+
+  /* Let the address map learn a port for TCP and UDP */
+  for(p = 0; p < 2; p++) {
+    UNIT_TEST_ASSERT(ip64_6to4(in, make_ipv6(protos[p], 0), out) > 0);
+    mapped_port[p] = (out[IPV4_HDRLEN] << 8) + out[IPV4_HDRLEN + 1];
+  }
+
+  for(p = 0; p < sizeof(protos); p++) {
+    errors = 0;
+    for(i = 0; i < NUM_LENS; i++) {
+      /* To the local host, and to a mapped port when there is one */
+      for(m = 0; m < (protos[p] == PROTO_ICMPV4 ? 1 : 2); m++) {
+        len = ip64_4to6(in, make_ipv4(protos[p],
+                                      m ? mapped_port[p] : LOCAL_PORT,
+                                      payload_lens[i]), out);
+        UNIT_TEST_ASSERT(len == IPV6_HDRLEN + (in[2] << 8) + in[3]
+                         - IPV4_HDRLEN);
+        if(m) {
+          UNIT_TEST_ASSERT(memcmp(out + 24, &node_v6, sizeof(node_v6)) == 0);
+          UNIT_TEST_ASSERT(out[IPV6_HDRLEN + 2] == V6_PORT >> 8 &&
+                           out[IPV6_HDRLEN + 3] == (V6_PORT & 0xff));
+        }
+        if(packet_chksum(out, 1) != full_chksum(out, 1)) {
+          errors++;
+        }
+      }
+    }
+    printf("TEST: 4to6 protocol %u, %u errors --- %s\n", protos[p], errors,
+           errors == 0 ? "OK" : "FAIL");
+    UNIT_TEST_ASSERT(errors == 0);
+  }
+
+  /* An IPv4 UDP packet without a checksum gets a full one */
+  errors = 0;
+  for(i = 0; i < NUM_LENS; i++) {
+    make_ipv4(PROTO_UDP, LOCAL_PORT, payload_lens[i]);
+    set_chksum(in, 0, 0);
+    ip64_4to6(in, (in[2] << 8) + in[3], out);
+    if(packet_chksum(out, 1) != full_chksum(out, 1)) {
+      errors++;
+    }
+  }
+  printf("TEST: 4to6 UDP without checksum, %u errors --- %s\n", errors,
+         errors == 0 ? "OK" : "FAIL");
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  uip_ip4addr_t netmask;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  ip64_init();
+  ip64_addrmap_init();
+  uip_ipaddr(&hostaddr, 10, 0, 0, 2);
+  uip_ipaddr(&netmask, 255, 255, 255, 0);
+  ip64_set_ipv4_address(&hostaddr, &netmask);
+  uip_ipaddr(&remote_v4, 93, 184, 216, 34);
+  uip_ip6addr(&node_v6, 0xfd00, 0, 0, 0, 0x212, 0x4b00, 0x1, 0x2);
+
+  UNIT_TEST_RUN(ip64_6to4_chksum);
+  UNIT_TEST_RUN(ip64_4to6_chksum);
+
+  if(UNIT_TEST_RESULT(ip64_6to4_chksum) != unit_test_success ||
+     UNIT_TEST_RESULT(ip64_4to6_chksum) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/